@@ -0,0 +1,972 @@
+/***************************************************************************************************************
+ * FILE: Analyze.c
+ *
+ * DESCRIPTION
+ * See comments in Analyze.h.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#include <ctype.h>     /* For toupper() */
+#include <math.h>      /* For sqrt() */
+#include <stdint.h>    /* For uint32_t, uint64_t */
+#include <stdlib.h>    /* For calloc(), free(), malloc(), qsort() */
+#include <string.h>    /* For memcmp(), memcpy(), memset() */
+#include "Analyze.h"   /* Good to always include the module header file. See comments in Globals.c. */
+#include "Globals.h"   /* For TERM_ERR_BUG */
+#include "Kernel.h"    /* For KernelGetTier(), KERNEL_SSE2 */
+#include "Main.h"      /* For MainTerminate() */
+#include "Pool.h"      /* For PoolGetThreads(), PoolGroup, PoolSubmit(), PoolWait() */
+#include "Stream.h"    /* For StreamFill() */
+
+/*
+ * As in Kernel.c, the vector code is only written for x86, and is compiled for its instruction set with the
+ * target attribute.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#define ANALYZE_X86
+#include <emmintrin.h>  /* For the SSE2 intrinsics */
+#endif
+
+/*==============================================================================================================
+ * Static type definitions.
+ *
+ * An AnalyzeClimbText is the ciphertext of the hill climb, shared read-only by its tasks: the alphabet index
+ * of each of its mLen letters, and for each column c, the letters in it, mCols[mColFirst[c]] up to but not
+ * including mCols[mColFirst[c + 1]], and likewise in mGrams the first letters of the quadgrams that have a
+ * letter in it. An AnalyzeClimbTask is one restart of the climb on one worker thread, with the state of its
+ * own random number generator, the plaintext of its key, and its result.
+ *
+ * An AnalyzeIocTask is the share of the candidate periods of one worker thread: the periods mFirst, mFirst +
+ * mStep, ... up to mMaxPeriod. For each block it counts the mLen indices of mIdx, the first of which is at key
+ * position mPos of the message, into mCounts, where the histogram of column c of period p starts at entry
+ * (p * (p - 1) / 2 - mOrigin + c) * mStride, mOrigin being the number of columns of the periods shorter than
+ * the shortest one counted. mScratch holds the ANALYZE_SUB_HISTS copies of the histograms of one period.
+ *
+ * An AnalyzeTable is the open-addressed hash table of the Kasiski examination. It maps the code of an n-gram
+ * to the key position where the n-gram was last seen. A slot whose mKeys entry is 0 is empty, so a key is the
+ * code plus 1. Collisions are resolved by linear probing, and the table doubles when it is half full.
+ *============================================================================================================*/
+typedef struct {
+    const unsigned char *mIdx;        /* The block, as alphabet indices */
+    size_t               mLen;        /* The number of indices in mIdx */
+    size_t               mPos;        /* The key position of mIdx[0], counted from the start of the message */
+    size_t               mFirst;      /* The first period of this task */
+    size_t               mStep;       /* The distance between the periods of this task */
+    size_t               mMaxPeriod;  /* The longest period */
+    size_t               mOrigin;     /* The number of columns of the periods before the first one counted */
+    size_t               mStride;     /* The number of bins in a histogram, n + 1 */
+    uint64_t            *mCounts;     /* The column histograms of every period, shared by all of the tasks */
+    uint32_t            *mScratch;    /* The copies of the histograms of one period for one block */
+} AnalyzeIocTask;
+
+typedef struct {
+    const float         *mQuad;                    /* The quadgram table, see NgramTable */
+    const unsigned char *mIdx;                     /* The alphabet index of each letter of the ciphertext */
+    unsigned char        mLetters[NGRAM_LETTERS];  /* The letter of each alphabet index, see NgramLetters() */
+    size_t               mLen;                     /* The number of letters */
+    size_t               mN;                       /* The number of chars in the alphabet, 26 */
+    size_t               mPeriod;                  /* The key length */
+    const uint32_t      *mColFirst;                /* Where the letters of each column start in mCols */
+    const uint32_t      *mCols;                    /* The letters of each column, column by column */
+    const uint32_t      *mGramFirst;               /* Where the quadgrams of each column start in mGrams */
+    const uint32_t      *mGrams;                   /* The quadgrams of each column, by their first letter */
+} AnalyzeClimbText;
+
+typedef struct {
+    const AnalyzeClimbText *mText;    /* The ciphertext */
+    uint64_t                mRandom;  /* The state of the random number generator of the restart */
+    unsigned char          *mKey;     /* The key, mPeriod alphabet indices */
+    unsigned char          *mPlain;   /* The plaintext for mKey, mLen letters of the quadgram table */
+    double                  mScore;   /* The log probability of mPlain */
+} AnalyzeClimbTask;
+
+typedef struct {
+    uint32_t *mKeys;   /* The code + 1 of the n-gram in each slot, 0 for an empty slot */
+    uint64_t *mLast;   /* The key position of the last occurrence of the n-gram in each slot */
+    size_t    mCap;    /* The number of slots, a power of 2 */
+    size_t    mCount;  /* The number of slots in use */
+    int       mBits;   /* log2(mCap) */
+} AnalyzeTable;
+
+/*==============================================================================================================
+ * Static function declarations.
+ *============================================================================================================*/
+static double AnalyzeClimbScore(const AnalyzeClimbText *pText, const unsigned char *pPlain, size_t pCol);
+static void AnalyzeClimbSet(const AnalyzeClimbText *pText, unsigned char *pPlain, size_t pCol, size_t pKey);
+static void AnalyzeClimbTaskRun(void *pArg);
+static int AnalyzeCompare(const void *pLeft, const void *pRight);
+static void AnalyzeCount(int pFd, const VigenereAlpha *pAlpha, size_t pMinPeriod, size_t pMaxPeriod,
+                         uint64_t *pCounts);
+static size_t AnalyzeIndex(const VigenereAlpha *pAlpha, const char *pIn, size_t pLen, unsigned char *pOut);
+#ifdef ANALYZE_X86
+static size_t AnalyzeIndexSse2(const VigenereAlpha *pAlpha, const char *pIn, size_t pLen, unsigned char *pOut);
+#endif
+static void AnalyzeIocTaskRun(void *pArg);
+static void *AnalyzeMalloc(size_t pSize);
+static uint32_t AnalyzeRandom(uint64_t *pState);
+static void AnalyzeRank(AnalyzePeriod *pRank, size_t pMaxPeriod);
+static size_t AnalyzeShift(const float *pSquares, const float *pWeights, size_t pLen);
+#ifdef ANALYZE_X86
+static size_t AnalyzeShiftSse2(const float *pSquares, const float *pWeights, size_t pLen);
+#endif
+static void AnalyzeTableBegin(AnalyzeTable *pTable, int pBits);
+static void AnalyzeTableEnd(AnalyzeTable *pTable);
+static bool AnalyzeTableSwap(AnalyzeTable *pTable, uint32_t pCode, uint64_t pPos, uint64_t *pLast);
+
+/*==============================================================================================================
+ * Static global variables.
+ *
+ * gAnalyzeEnglish[c] is the frequency of letter 'A' + c in English text, in percent. A char of the alphabet
+ * that is not a letter is given ANALYZE_FREQ_FLOOR percent.
+ *============================================================================================================*/
+static const double gAnalyzeEnglish[26] = {
+    8.167, 1.492, 2.782, 4.253, 12.702, 2.228, 2.015, 6.094, 6.966, 0.153, 0.772, 4.025, 2.406,
+    6.749, 7.507, 1.929, 0.095,  5.987, 6.327, 9.056, 2.758, 0.978, 2.360, 0.150, 1.974, 0.074
+};
+
+/*==============================================================================================================
+ * Function definitions.
+ *============================================================================================================*/
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeBest
+ *
+ * DESCR:    Picks the key length out of the pCount periods of pRank, which are ranked best first. A multiple of
+ *           the key length scores about as well as the key length itself, and may even score a little better by
+ *           chance, so the pick is the shortest period that scores at least ANALYZE_BEST times the top score.
+ *
+ * RETURNS:  The period, or 0 if pCount is 0.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t AnalyzeBest
+    (
+    const AnalyzePeriod *pRank,
+    size_t               pCount
+    )
+{
+    size_t best = 0, i;
+
+    for (i = 0; i < pCount; ++i) {
+        if (pRank[i].mScore >= ANALYZE_BEST * pRank[0].mScore && (!best || pRank[i].mPeriod < best)) {
+            best = pRank[i].mPeriod;
+        }
+    }
+    return best;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeClimb
+ *
+ * DESCR:    Reads the ciphertext from pFd to end of file and recovers the key of length pPeriod by hill
+ *           climbing on the quadgram log probability of the plaintext (see Analyze.h), for the alphabet pAlpha,
+ *           which is the 26 letters (see NgramLetters()), with the quadgrams of pTable. Only the first
+ *           ANALYZE_CLIMB_LEN letters are used. The restarts run in rounds, one on each worker thread, until
+ *           ANALYZE_CLIMB_AGREE of them have climbed to the best key found so far, or ANALYZE_CLIMB_RESTARTS
+ *           have run. Restart r seeds the random number generator of its task with r, so the key found does not
+ *           depend on the number of threads. Fails and terminates with an error message if the ciphertext could
+ *           not be read or the memory could not be allocated.
+ *
+ * RETURNS:  The number of letters (chars of the alphabet) in the ciphertext, and in pKey the key, pPeriod chars
+ *           of the alphabet and a terminating NUL, or "" if there are fewer than 4 letters.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t AnalyzeClimb
+    (
+    int                  pFd,
+    const VigenereAlpha *pAlpha,
+    const NgramTable    *pTable,
+    size_t               pPeriod,
+    char                *pKey
+    )
+{
+    size_t n = pAlpha->mLen, numTasks = (size_t)PoolGetThreads(), agree = 0, restarts = 0;
+    size_t c, j, k, last, len, letters = 0, pos = 0, s, t;
+    char *raw = AnalyzeMalloc(ANALYZE_BLOCK_LEN);
+    unsigned char *idx = AnalyzeMalloc(ANALYZE_BLOCK_LEN), *cipher = AnalyzeMalloc(ANALYZE_CLIMB_LEN);
+    unsigned char *best = AnalyzeMalloc(pPeriod);
+    uint32_t *col = AnalyzeMalloc(ANALYZE_CLIMB_LEN * sizeof(*col)), *colFirst, *cols, *gramFirst, *grams;
+    double bestScore = 0.0;
+    AnalyzeClimbText text;
+    AnalyzeClimbTask *tasks;
+    PoolGroup pending = { 0 };
+
+    /* Keep the first ANALYZE_CLIMB_LEN letters and the key column of each, and count the rest. */
+    while ((len = StreamFill(pFd, raw, ANALYZE_BLOCK_LEN)) > 0) {
+        len = AnalyzeIndex(pAlpha, raw, len, idx);
+        for (j = 0; j < len; ++j, ++pos) {
+            if (idx[j] == n) continue;
+            if (letters < ANALYZE_CLIMB_LEN) {
+                cipher[letters] = idx[j];
+                col[letters] = (uint32_t)(pos % pPeriod);
+            }
+            ++letters;
+        }
+    }
+    free(idx);
+    free(raw);
+    pKey[0] = '\0';
+    text.mLen = letters < ANALYZE_CLIMB_LEN ? letters : ANALYZE_CLIMB_LEN;
+    if (text.mLen < 4) {
+        free(col);
+        free(best);
+        free(cipher);
+        return letters;
+    }
+
+    /* List the letters of each column, and the quadgrams that each column has a letter in. */
+    colFirst = calloc(pPeriod + 1, sizeof(*colFirst));
+    gramFirst = AnalyzeMalloc((pPeriod + 1) * sizeof(*gramFirst));
+    cols = AnalyzeMalloc(text.mLen * sizeof(*cols));
+    grams = AnalyzeMalloc(4 * text.mLen * sizeof(*grams));
+    if (!colFirst) MainTerminate(TERM_ERR_BUG, "could not allocate memory for the analysis.\n");
+    for (j = 0; j < text.mLen; ++j) ++colFirst[col[j] + 1];
+    for (c = 0; c < pPeriod; ++c) colFirst[c + 1] += colFirst[c];
+    for (j = 0; j < text.mLen; ++j) cols[colFirst[col[j]]++] = (uint32_t)j;
+    for (c = pPeriod; c > 0; --c) colFirst[c] = colFirst[c - 1];
+    colFirst[0] = 0;
+    gramFirst[0] = 0;
+    for (c = k = 0; c < pPeriod; ++c) {
+        for (last = (size_t)-1, j = colFirst[c]; j < colFirst[c + 1]; ++j) {
+            for (s = cols[j] < 3 ? 0 : cols[j] - 3; s <= cols[j] && s + 4 <= text.mLen; ++s) {
+                if (last == (size_t)-1 || s > last) grams[k++] = (uint32_t)(last = s);
+            }
+        }
+        gramFirst[c + 1] = (uint32_t)k;
+    }
+    NgramLetters(pAlpha, text.mLetters);
+    text.mQuad = pTable->mQuad;
+    text.mIdx = cipher;
+    text.mN = n;
+    text.mPeriod = pPeriod;
+    text.mColFirst = colFirst;
+    text.mCols = cols;
+    text.mGramFirst = gramFirst;
+    text.mGrams = grams;
+
+    /* Run the restarts in rounds, one on each thread, until enough of them agree on the best key. */
+    tasks = AnalyzeMalloc(numTasks * sizeof(*tasks));
+    for (t = 0; t < numTasks; ++t) {
+        tasks[t].mText = &text;
+        tasks[t].mKey = AnalyzeMalloc(pPeriod);
+        tasks[t].mPlain = AnalyzeMalloc(text.mLen);
+    }
+    while (agree < ANALYZE_CLIMB_AGREE && restarts < ANALYZE_CLIMB_RESTARTS) {
+        for (t = 0; t < numTasks; ++t) {
+            tasks[t].mRandom = (uint64_t)(restarts + t + 1) * 2654435769u;
+            PoolSubmit(&pending, AnalyzeClimbTaskRun, &tasks[t]);
+        }
+        PoolWait(&pending);
+        for (t = 0; t < numTasks; ++t, ++restarts) {
+            if (restarts > 0 && !memcmp(tasks[t].mKey, best, pPeriod)) {
+                ++agree;
+            } else if (restarts == 0 || tasks[t].mScore > bestScore) {
+                memcpy(best, tasks[t].mKey, pPeriod);
+                bestScore = tasks[t].mScore;
+                agree = 1;
+            }
+        }
+    }
+    for (c = 0; c < pPeriod; ++c) pKey[c] = (char)pAlpha->mChar[best[c]];
+    pKey[pPeriod] = '\0';
+
+    for (t = 0; t < numTasks; ++t) {
+        free(tasks[t].mPlain);
+        free(tasks[t].mKey);
+    }
+    free(tasks);
+    free(grams);
+    free(cols);
+    free(gramFirst);
+    free(colFirst);
+    free(col);
+    free(best);
+    free(cipher);
+    return letters;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeClimbScore
+ * DESCR:    Sums the log probabilities of the quadgrams of pPlain that column pCol of pText has a letter in, or
+ *           of every quadgram of pPlain if pCol is the key length. Only these change when the key char of the
+ *           column does, so a change is scored without scoring the whole plaintext.
+ * RETURNS:  The sum.
+ *------------------------------------------------------------------------------------------------------------*/
+static double AnalyzeClimbScore
+    (
+    const AnalyzeClimbText *pText,
+    const unsigned char    *pPlain,
+    size_t                  pCol
+    )
+{
+    const unsigned char *p;
+    double score = 0.0;
+    size_t g;
+
+    if (pCol == pText->mPeriod) {
+        for (g = 0; g + 4 <= pText->mLen; ++g) {
+            p = pPlain + g;
+            score += pText->mQuad[((p[0] * NGRAM_LETTERS + p[1]) * NGRAM_LETTERS + p[2]) * NGRAM_LETTERS +
+                                  p[3]];
+        }
+        return score;
+    }
+    for (g = pText->mGramFirst[pCol]; g < pText->mGramFirst[pCol + 1]; ++g) {
+        p = pPlain + pText->mGrams[g];
+        score += pText->mQuad[((p[0] * NGRAM_LETTERS + p[1]) * NGRAM_LETTERS + p[2]) * NGRAM_LETTERS + p[3]];
+    }
+    return score;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeClimbSet
+ * DESCR:    Decrypts the letters of column pCol of pText with the key char at alphabet index pKey into pPlain,
+ *           as letters of the quadgram table (see NgramLetters()). The other columns are left as they are.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void AnalyzeClimbSet
+    (
+    const AnalyzeClimbText *pText,
+    unsigned char          *pPlain,
+    size_t                  pCol,
+    size_t                  pKey
+    )
+{
+    size_t j, i;
+
+    for (j = pText->mColFirst[pCol]; j < pText->mColFirst[pCol + 1]; ++j) {
+        i = pText->mCols[j];
+        pPlain[i] = pText->mLetters[(pText->mIdx[i] + pText->mN - pKey) % pText->mN];
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeClimbTaskRun
+ * DESCR:    Runs one restart of the hill climb. pArg is the AnalyzeClimbTask. Runs on a worker thread (see
+ *           AnalyzeClimb()). The key starts out random. Then each key char in turn is set to the char that
+ *           gives the plaintext the highest score, which only needs the quadgrams of its column to be decrypted
+ *           and scored again for each char that is tried, until a pass through the key changes no char. The
+ *           score rises with every change, so the climb ends, at a key that no single change improves.
+ * RETURNS:  Nothing. The key and its score are left in the task.
+ *------------------------------------------------------------------------------------------------------------*/
+static void AnalyzeClimbTaskRun
+    (
+    void *pArg
+    )
+{
+    AnalyzeClimbTask *task = pArg;
+    const AnalyzeClimbText *text = task->mText;
+    size_t c, k, bestKey;
+    double score, bestScore;
+    bool climbed = true;
+
+    for (c = 0; c < text->mPeriod; ++c) {
+        task->mKey[c] = (unsigned char)(AnalyzeRandom(&task->mRandom) % text->mN);
+        AnalyzeClimbSet(text, task->mPlain, c, task->mKey[c]);
+    }
+    while (climbed) {
+        climbed = false;
+        for (c = 0; c < text->mPeriod; ++c) {
+            bestKey = task->mKey[c];
+            bestScore = AnalyzeClimbScore(text, task->mPlain, c);
+            for (k = 0; k < text->mN; ++k) {
+                if (k == task->mKey[c]) continue;
+                AnalyzeClimbSet(text, task->mPlain, c, k);
+                score = AnalyzeClimbScore(text, task->mPlain, c);
+                if (score > bestScore) {
+                    bestKey = k;
+                    bestScore = score;
+                }
+            }
+            AnalyzeClimbSet(text, task->mPlain, c, bestKey);
+            if (bestKey != task->mKey[c]) climbed = true;
+            task->mKey[c] = (unsigned char)bestKey;
+        }
+    }
+    task->mScore = AnalyzeClimbScore(text, task->mPlain, text->mPeriod);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeColumns
+ *
+ * DESCR:    Reads the ciphertext from pFd to end of file and counts its chars into the pPeriod column
+ *           histograms of the key length pPeriod, in one pass, for the alphabet pAlpha, which is not the binary
+ *           alphabet. pCounts has room for pPeriod * (n + 1) counts, and the histogram of column c starts at
+ *           entry c * (n + 1), the last bin of each counting the chars that are not in the alphabet. Fails and
+ *           terminates with an error message if the ciphertext could not be read or the memory could not be
+ *           allocated.
+ *
+ * RETURNS:  The number of letters (chars of the alphabet) in the ciphertext, and the histograms in pCounts.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t AnalyzeColumns
+    (
+    int                  pFd,
+    const VigenereAlpha *pAlpha,
+    size_t               pPeriod,
+    uint64_t            *pCounts
+    )
+{
+    size_t stride = pAlpha->mLen + 1, b, letters = 0;
+
+    memset(pCounts, 0, pPeriod * stride * sizeof(*pCounts));
+    AnalyzeCount(pFd, pAlpha, pPeriod, pPeriod, pCounts);
+    for (b = 0; b < pPeriod * stride; ++b) letters += b % stride != stride - 1 ? (size_t)pCounts[b] : 0;
+    return letters;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeCompare
+ * DESCR:    The qsort() comparison of two AnalyzePeriods: the higher score first, and of equal scores, the
+ *           shorter period first.
+ * RETURNS:  < 0, 0, or > 0 as pLeft goes before, with, or after pRight.
+ *------------------------------------------------------------------------------------------------------------*/
+static int AnalyzeCompare
+    (
+    const void *pLeft,
+    const void *pRight
+    )
+{
+    const AnalyzePeriod *left = pLeft, *right = pRight;
+
+    if (left->mScore != right->mScore) return left->mScore > right->mScore ? -1 : 1;
+    return left->mPeriod < right->mPeriod ? -1 : left->mPeriod > right->mPeriod;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeCount
+ * DESCR:    Reads the ciphertext from pFd to end of file and counts it into the column histograms of every
+ *           period from pMinPeriod to pMaxPeriod in pCounts, which are laid out as described for
+ *           AnalyzeIocTask, for the alphabet pAlpha. The periods are split across the worker threads, which
+ *           count each block while the next one is read and indexed. Fails and terminates with an error message
+ *           if the ciphertext could not be read or the memory could not be allocated.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void AnalyzeCount
+    (
+    int                  pFd,
+    const VigenereAlpha *pAlpha,
+    size_t               pMinPeriod,
+    size_t               pMaxPeriod,
+    uint64_t            *pCounts
+    )
+{
+    size_t stride = pAlpha->mLen + 1, numTasks = (size_t)PoolGetThreads();
+    size_t cur = 0, len, next, pos = 0, rawLen, t;
+    char *raw = AnalyzeMalloc(ANALYZE_BLOCK_LEN);
+    unsigned char *idx[2];
+    AnalyzeIocTask *tasks;
+    PoolGroup pending = { 0 };
+
+    if (numTasks > pMaxPeriod - pMinPeriod + 1) numTasks = pMaxPeriod - pMinPeriod + 1;
+    idx[0] = AnalyzeMalloc(ANALYZE_BLOCK_LEN);
+    idx[1] = AnalyzeMalloc(ANALYZE_BLOCK_LEN);
+    tasks = AnalyzeMalloc(numTasks * sizeof(*tasks));
+    for (t = 0; t < numTasks; ++t) {
+        tasks[t].mFirst = pMinPeriod + t;
+        tasks[t].mStep = numTasks;
+        tasks[t].mMaxPeriod = pMaxPeriod;
+        tasks[t].mOrigin = pMinPeriod * (pMinPeriod - 1) / 2;
+        tasks[t].mStride = stride;
+        tasks[t].mCounts = pCounts;
+        tasks[t].mScratch = AnalyzeMalloc(ANALYZE_SUB_HISTS * pMaxPeriod * stride * sizeof(uint32_t));
+    }
+
+    /* Count each block on the worker threads while the next one is read and indexed. */
+    rawLen = StreamFill(pFd, raw, ANALYZE_BLOCK_LEN);
+    len = AnalyzeIndex(pAlpha, raw, rawLen, idx[cur]);
+    while (rawLen > 0) {
+        for (t = 0; t < numTasks; ++t) {
+            tasks[t].mIdx = idx[cur];
+            tasks[t].mLen = len;
+            tasks[t].mPos = pos;
+            PoolSubmit(&pending, AnalyzeIocTaskRun, &tasks[t]);
+        }
+        rawLen = StreamFill(pFd, raw, ANALYZE_BLOCK_LEN);
+        next = AnalyzeIndex(pAlpha, raw, rawLen, idx[cur ^ 1]);
+        PoolWait(&pending);
+        pos += len;
+        len = next;
+        cur ^= 1;
+    }
+
+    for (t = 0; t < numTasks; ++t) free(tasks[t].mScratch);
+    free(tasks);
+    free(idx[1]);
+    free(idx[0]);
+    free(raw);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeIndex
+ * DESCR:    Turns the pLen chars of pIn into their indices in the alphabet, n for a char that is not in it, in
+ *           pOut. For the text alphabet, where the key does not advance past a non-letter, the non-letters are
+ *           then dropped, so that the i-th index of pOut is at key position i.
+ * RETURNS:  The number of indices in pOut.
+ *------------------------------------------------------------------------------------------------------------*/
+static size_t AnalyzeIndex
+    (
+    const VigenereAlpha *pAlpha,
+    const char          *pIn,
+    size_t               pLen,
+    unsigned char       *pOut
+    )
+{
+    unsigned char n = (unsigned char)pAlpha->mLen, v;
+    size_t i = 0, k = 0;
+
+#ifdef ANALYZE_X86
+    if (pAlpha->mRange && KernelGetTier() >= KERNEL_SSE2) i = AnalyzeIndexSse2(pAlpha, pIn, pLen, pOut);
+#endif
+    for (; i < pLen; ++i) {
+        v = pAlpha->mIndex[(unsigned char)pIn[i]];
+        pOut[i] = v == VIGENERE_ALPHA_NONE ? n : v;
+    }
+    if (!pAlpha->mText) return pLen;
+    for (i = 0; i < pLen; ++i) {
+        pOut[k] = pOut[i];
+        k += pOut[i] != n;
+    }
+    return k;
+}
+
+#ifdef ANALYZE_X86
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeIndexSse2
+ * DESCR:    AnalyzeIndex() for an alphabet that is a run of consecutive chars, 16 chars at a time. The index of
+ *           a char is the char minus the first char of the alphabet, after the case bit is cleared for the text
+ *           alphabet, and it is in the alphabet if that is less than n as an unsigned byte, i.e., if the min of
+ *           it and n - 1 is itself.
+ * RETURNS:  The number of chars done, a multiple of 16.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("sse2")))
+static size_t AnalyzeIndexSse2
+    (
+    const VigenereAlpha *pAlpha,
+    const char          *pIn,
+    size_t               pLen,
+    unsigned char       *pOut
+    )
+{
+    const __m128i mask = _mm_set1_epi8((char)~pAlpha->mCase), base = _mm_set1_epi8((char)pAlpha->mBase);
+    const __m128i last = _mm_set1_epi8((char)(pAlpha->mLen - 1)), none = _mm_set1_epi8((char)pAlpha->mLen);
+    size_t i;
+
+    for (i = 0; i + 16 <= pLen; i += 16) {
+        __m128i x  = _mm_sub_epi8(_mm_and_si128(_mm_loadu_si128((const __m128i *)(pIn + i)), mask), base);
+        __m128i ok = _mm_cmpeq_epi8(_mm_min_epu8(x, last), x);
+        _mm_storeu_si128((__m128i *)(pOut + i), _mm_or_si128(_mm_and_si128(ok, x), _mm_andnot_si128(ok, none)));
+    }
+    return i;
+}
+#endif
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeIoc
+ *
+ * DESCR:    Reads the ciphertext from pFd to end of file and scores every period from 1 to pMaxPeriod (at most
+ *           ANALYZE_PERIOD_MAX) by the mean index of coincidence of its columns, times n, for the alphabet
+ *           pAlpha, which is not the binary alphabet. A column with fewer than two letters is left out of the
+ *           mean. Fails and terminates with an error message if the ciphertext could not be read or the memory
+ *           could not be allocated.
+ *
+ * RETURNS:  The number of letters (chars of the alphabet) in the ciphertext, and in pRank the pMaxPeriod
+ *           periods, ranked best first (see AnalyzeCompare()).
+ *------------------------------------------------------------------------------------------------------------*/
+size_t AnalyzeIoc
+    (
+    int                  pFd,
+    const VigenereAlpha *pAlpha,
+    size_t               pMaxPeriod,
+    AnalyzePeriod       *pRank
+    )
+{
+    size_t stride = pAlpha->mLen + 1, c, p, b, letters = 0;
+    uint64_t *counts = calloc(pMaxPeriod * (pMaxPeriod + 1) / 2 * stride, sizeof(*counts)), *h, sum, coincide;
+    double score;
+    int cols;
+
+    if (!counts) MainTerminate(TERM_ERR_BUG, "could not allocate the histograms.\n");
+    AnalyzeCount(pFd, pAlpha, 1, pMaxPeriod, counts);
+
+    /* Score each period by the mean IoC of its columns. */
+    for (p = 1; p <= pMaxPeriod; ++p) {
+        score = 0.0;
+        cols = 0;
+        for (c = 0; c < p; ++c) {
+            h = counts + (p * (p - 1) / 2 + c) * stride;
+            sum = coincide = 0;
+            for (b = 0; b + 1 < stride; ++b) {
+                sum += h[b];
+                coincide += h[b] * (h[b] - 1);
+            }
+            if (p == 1) letters = (size_t)sum;
+            if (sum < 2) continue;
+            score += (double)coincide / ((double)sum * (double)(sum - 1));
+            ++cols;
+        }
+        pRank[p - 1].mPeriod = p;
+        pRank[p - 1].mScore = cols ? score / cols * pAlpha->mLen : 0.0;
+    }
+    AnalyzeRank(pRank, pMaxPeriod);
+
+    free(counts);
+    return letters;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeIocTaskRun
+ * DESCR:    Counts one block into the column histograms of the periods of one task (see AnalyzeIocTask). pArg
+ *           is the AnalyzeIocTask. Runs on a worker thread (see AnalyzeIoc()). The counts of the block go into
+ *           32-bit copies of the histograms, which a block is too short to overflow, and are then added to the
+ *           64-bit totals. The periods of different tasks have disjoint totals, so no lock is needed.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void AnalyzeIocTaskRun
+    (
+    void *pArg
+    )
+{
+    AnalyzeIocTask *task = pArg;
+    const unsigned char *idx = task->mIdx;
+    size_t stride = task->mStride, p, col, copy, end, j, k, rowLen;
+    uint32_t *sub = task->mScratch, *h;
+    uint64_t *total;
+
+    for (p = task->mFirst; p <= task->mMaxPeriod; p += task->mStep) {
+        rowLen = p * stride;
+        memset(sub, 0, ANALYZE_SUB_HISTS * rowLen * sizeof(*sub));
+        col = task->mPos % p;
+        copy = 0;
+        for (j = 0; j < task->mLen; j = end) {
+            /* One pass through the key, from column col to the end of the key or of the block. */
+            end = j + p - col < task->mLen ? j + p - col : task->mLen;
+            for (h = sub + copy * rowLen + col * stride; j < end; ++j, h += stride) ++h[idx[j]];
+            col = 0;
+            if (++copy == ANALYZE_SUB_HISTS) copy = 0;
+        }
+        total = task->mCounts + (p * (p - 1) / 2 - task->mOrigin) * stride;
+        for (k = 0; k < rowLen; ++k) {
+            for (copy = 0; copy < ANALYZE_SUB_HISTS; ++copy) total[k] += sub[copy * rowLen + k];
+        }
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeKasiski
+ *
+ * DESCR:    Reads the ciphertext from pFd to end of file and scores every period from 1 to pMaxPeriod (at most
+ *           ANALYZE_PERIOD_MAX) by a Kasiski examination of its trigrams (see Analyze.h), for the alphabet
+ *           pAlpha, which is not the binary alphabet. An n-gram is ANALYZE_GRAM_LEN letters at consecutive key
+ *           positions, so outside of text mode a char that is not in the alphabet ends it. A distance shorter
+ *           than ANALYZE_DIST_LEN is counted in a table, which is summed over the multiples of each period at
+ *           the end, and a longer one is factored when it is found. Fails and terminates with an error message
+ *           if the ciphertext could not be read or the memory could not be allocated.
+ *
+ * RETURNS:  The number of letters (chars of the alphabet) in the ciphertext, and in pRank the pMaxPeriod
+ *           periods, ranked best first (see AnalyzeCompare()). Every score is 0 if no n-gram was repeated.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t AnalyzeKasiski
+    (
+    int                  pFd,
+    const VigenereAlpha *pAlpha,
+    size_t               pMaxPeriod,
+    AnalyzePeriod       *pRank
+    )
+{
+    uint32_t n = (uint32_t)pAlpha->mLen, span = 1, code = 0;
+    size_t f, j, k, len, letters = 0, run = 0;
+    uint64_t *dist = calloc(ANALYZE_DIST_LEN, sizeof(*dist)), *fact = calloc(pMaxPeriod + 1, sizeof(*fact));
+    uint64_t d, last, pos = 0, repeats = 0;
+    double expect;
+    char *raw = AnalyzeMalloc(ANALYZE_BLOCK_LEN);
+    unsigned char *idx = AnalyzeMalloc(ANALYZE_BLOCK_LEN);
+    AnalyzeTable table;
+
+    if (!dist || !fact) MainTerminate(TERM_ERR_BUG, "could not allocate memory for the analysis.\n");
+    for (j = 0; j < ANALYZE_GRAM_LEN; ++j) span *= n;
+    AnalyzeTableBegin(&table, 12);
+    while ((len = StreamFill(pFd, raw, ANALYZE_BLOCK_LEN)) > 0) {
+        len = AnalyzeIndex(pAlpha, raw, len, idx);
+        for (j = 0; j < len; ++j, ++pos) {
+            if (idx[j] == n) {
+                run = 0;
+                continue;
+            }
+            ++letters;
+            code = (code * n + idx[j]) % span;
+            if (++run < ANALYZE_GRAM_LEN || !AnalyzeTableSwap(&table, code, pos, &last)) continue;
+            d = pos - last;
+            ++repeats;
+            if (d < ANALYZE_DIST_LEN) {
+                ++dist[d];
+            } else {
+                for (f = 2; f <= pMaxPeriod; ++f) fact[f] += d % f == 0;
+            }
+        }
+    }
+
+    /* Score each period by how many more of the distances it divides than chance would, in standard
+     * deviations. */
+    for (f = 1; f <= pMaxPeriod; ++f) {
+        for (k = f; k < ANALYZE_DIST_LEN; k += f) fact[f] += dist[k];
+        expect = (double)repeats / f;
+        pRank[f - 1].mPeriod = f;
+        pRank[f - 1].mScore = f > 1 && repeats ? (fact[f] - expect) / sqrt(expect * (1.0 - 1.0 / f)) : 0.0;
+    }
+    AnalyzeRank(pRank, pMaxPeriod);
+
+    AnalyzeTableEnd(&table);
+    free(idx);
+    free(raw);
+    free(fact);
+    free(dist);
+    return letters;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeMalloc
+ * DESCR:    Allocates pSize bytes. Fails and terminates with an error message if they could not be allocated.
+ * RETURNS:  The memory, which the caller frees with free().
+ *------------------------------------------------------------------------------------------------------------*/
+static void *AnalyzeMalloc
+    (
+    size_t pSize
+    )
+{
+    void *mem = malloc(pSize ? pSize : 1);
+
+    if (!mem) MainTerminate(TERM_ERR_BUG, "could not allocate memory for the analysis.\n");
+    return mem;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeRandom
+ * DESCR:    Advances the xorshift random number generator whose state is *pState, which must not be 0. Each
+ *           task of the hill climb has its own state, so the threads share nothing while they climb.
+ * RETURNS:  The next random number, of 32 bits.
+ *------------------------------------------------------------------------------------------------------------*/
+static uint32_t AnalyzeRandom
+    (
+    uint64_t *pState
+    )
+{
+    uint64_t x = *pState;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *pState = x;
+    return (uint32_t)(x >> 32);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeRank
+ * DESCR:    Sorts the pMaxPeriod scored periods of pRank, best first (see AnalyzeCompare()).
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void AnalyzeRank
+    (
+    AnalyzePeriod *pRank,
+    size_t         pMaxPeriod
+    )
+{
+    qsort(pRank, pMaxPeriod, sizeof(*pRank), AnalyzeCompare);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeShift
+ * DESCR:    Finds the shift of one column of the ciphertext that best fits the plaintext letter frequencies.
+ *           pSquares is the column histogram, as squared shares of the column, repeated so that pSquares[s + i]
+ *           is the square of the share of letter (s + i) % pLen, and pWeights[i] is 1 over the expected share
+ *           of letter i in the plaintext. The chi-squared statistic of shift s is then, up to a constant and a
+ *           positive factor, the sum over i of pSquares[s + i] * pWeights[i], which is the score. Uses SSE2
+ *           when the kernel tier allows it (see AnalyzeShiftSse2()).
+ * RETURNS:  The shift 0..pLen - 1 with the lowest score, the lowest of equal ones.
+ *------------------------------------------------------------------------------------------------------------*/
+static size_t AnalyzeShift
+    (
+    const float *pSquares,
+    const float *pWeights,
+    size_t       pLen
+    )
+{
+    size_t best = 0, i, s;
+    float score, bestScore = 0.0f;
+
+#ifdef ANALYZE_X86
+    if (KernelGetTier() >= KERNEL_SSE2) return AnalyzeShiftSse2(pSquares, pWeights, pLen);
+#endif
+    for (s = 0; s < pLen; ++s) {
+        score = 0.0f;
+        for (i = 0; i < pLen; ++i) score += pSquares[s + i] * pWeights[i];
+        if (s == 0 || score < bestScore) {
+            best = s;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+#ifdef ANALYZE_X86
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeShiftSse2
+ * DESCR:    AnalyzeShift() for four shifts at a time. The histogram rotated by shifts s..s + 3 is a sliding
+ *           window of pSquares, so the four scores are summed in the lanes of one vector: each weight is
+ *           broadcast and multiplied by the four squares at s + i..s + i + 3, one unaligned load, with no
+ *           shuffle or horizontal add. pSquares must have room for (pLen rounded up to 4) + pLen - 1 squares.
+ * RETURNS:  The shift 0..pLen - 1 with the lowest score, the lowest of equal ones.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("sse2")))
+static size_t AnalyzeShiftSse2
+    (
+    const float *pSquares,
+    const float *pWeights,
+    size_t       pLen
+    )
+{
+    float scores[VIGENERE_ALPHA_MAX + 4];
+    size_t best = 0, i, s;
+
+    for (s = 0; s < pLen; s += 4) {
+        __m128 sum = _mm_setzero_ps();
+        for (i = 0; i < pLen; ++i) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(pWeights[i]), _mm_loadu_ps(pSquares + s + i)));
+        }
+        _mm_storeu_ps(scores + s, sum);
+    }
+    for (s = 1; s < pLen; ++s) {
+        if (scores[s] < scores[best]) best = s;
+    }
+    return best;
+}
+#endif
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeSolve
+ *
+ * DESCR:    Recovers the key of length pPeriod from the column histograms of the ciphertext in pCounts (see
+ *           AnalyzeColumns()), for the alphabet pAlpha, assuming the plaintext is English. Column c was
+ *           shifted by key char c, so the key char is the shift that makes the column fit the English letter
+ *           frequencies best by the chi-squared statistic (see AnalyzeShift()). A char of the alphabet that is
+ *           a letter, of either case, is expected at the frequency of the letter, and any other char at
+ *           ANALYZE_FREQ_FLOOR percent. A column with no letters gets the first char of the alphabet.
+ *
+ * RETURNS:  The key in pKey, pPeriod chars of the alphabet and a terminating NUL, in the form a key file (the
+ *           -k option) holds it.
+ *------------------------------------------------------------------------------------------------------------*/
+void AnalyzeSolve
+    (
+    const VigenereAlpha *pAlpha,
+    const uint64_t      *pCounts,
+    size_t               pPeriod,
+    char                *pKey
+    )
+{
+    size_t n = pAlpha->mLen, stride = n + 1, c, i, len = (n + 3) / 4 * 4 + n - 1;
+    float squares[2 * VIGENERE_ALPHA_MAX + 4], weights[VIGENERE_ALPHA_MAX];
+    const uint64_t *h;
+    double expect[VIGENERE_ALPHA_MAX], share, total = 0.0;
+    uint64_t sum;
+    int letter;
+
+    for (i = 0; i < n; ++i) {
+        letter = toupper(pAlpha->mChar[i]);
+        expect[i] = letter >= 'A' && letter <= 'Z' ? gAnalyzeEnglish[letter - 'A'] : ANALYZE_FREQ_FLOOR;
+        total += expect[i];
+    }
+    for (i = 0; i < n; ++i) weights[i] = (float)(total / expect[i]);
+    for (c = 0; c < pPeriod; ++c) {
+        h = pCounts + c * stride;
+        for (sum = 0, i = 0; i < n; ++i) sum += h[i];
+        for (i = 0; i < len; ++i) {
+            share = sum ? (double)h[i % n] / (double)sum : 0.0;
+            squares[i] = (float)(share * share);
+        }
+        pKey[c] = (char)pAlpha->mChar[AnalyzeShift(squares, weights, n)];
+    }
+    pKey[pPeriod] = '\0';
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeTableBegin
+ * DESCR:    Makes pTable an empty table of 2^pBits slots. Fails and terminates with an error message if the
+ *           memory could not be allocated.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void AnalyzeTableBegin
+    (
+    AnalyzeTable *pTable,
+    int           pBits
+    )
+{
+    pTable->mBits = pBits;
+    pTable->mCap = (size_t)1 << pBits;
+    pTable->mCount = 0;
+    pTable->mKeys = calloc(pTable->mCap, sizeof(*pTable->mKeys));
+    pTable->mLast = AnalyzeMalloc(pTable->mCap * sizeof(*pTable->mLast));
+    if (!pTable->mKeys) MainTerminate(TERM_ERR_BUG, "could not allocate memory for the analysis.\n");
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeTableEnd
+ * DESCR:    Frees the memory of pTable.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void AnalyzeTableEnd
+    (
+    AnalyzeTable *pTable
+    )
+{
+    free(pTable->mLast);
+    free(pTable->mKeys);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: AnalyzeTableSwap
+ * DESCR:    Records that the n-gram with code pCode was seen at key position pPos. The slot of a code starts at
+ *           the top mBits bits of the code times 2^32 / phi, a Fibonacci hash, which spreads the codes of
+ *           similar n-grams apart, and the probe goes on from there to the code or an empty slot. The table is
+ *           doubled and every entry moved to its new slot when it is half full.
+ * RETURNS:  true if the n-gram had been seen before, with the position it was last seen at in *pLast.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool AnalyzeTableSwap
+    (
+    AnalyzeTable *pTable,
+    uint32_t      pCode,
+    uint64_t      pPos,
+    uint64_t     *pLast
+    )
+{
+    AnalyzeTable grown;
+    size_t i, mask = pTable->mCap - 1, s;
+
+    for (s = (uint32_t)(pCode * 2654435769u) >> (32 - pTable->mBits); pTable->mKeys[s]; s = (s + 1) & mask) {
+        if (pTable->mKeys[s] == pCode + 1) {
+            *pLast = pTable->mLast[s];
+            pTable->mLast[s] = pPos;
+            return true;
+        }
+    }
+    pTable->mKeys[s] = pCode + 1;
+    pTable->mLast[s] = pPos;
+    if (++pTable->mCount * 2 > pTable->mCap) {
+        AnalyzeTableBegin(&grown, pTable->mBits + 1);
+        for (i = 0; i < pTable->mCap; ++i) {
+            if (pTable->mKeys[i]) AnalyzeTableSwap(&grown, pTable->mKeys[i] - 1, pTable->mLast[i], pLast);
+        }
+        AnalyzeTableEnd(pTable);
+        *pTable = grown;
+    }
+    return false;
+}
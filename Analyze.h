@@ -0,0 +1,160 @@
+/***************************************************************************************************************
+ * FILE: Analyze.h
+ *
+ * DESCRIPTION
+ * Cryptanalysis of a ciphertext whose key is not known (the analyze mode of the vigenere program). The first
+ * step is to find the length of the key, the period of the cipher. If the key has length p, then every p-th
+ * char of the ciphertext was shifted by the same key char, so each of the p columns that the ciphertext is cut
+ * into is a simple Caesar cipher of the plaintext and keeps the uneven letter frequencies of the plaintext. The
+ * index of coincidence (IoC) of a column, the chance that two chars picked from it are the same, is about 0.066
+ * for English and 1/26 for uniformly random letters. AnalyzeIoc() computes the IoC of every column for every
+ * candidate period from 1 to a maximum, times the number of chars n in the alphabet, so that 1.0 is random and
+ * English is about 1.7. The right period and its multiples score high and the others score about 1.0.
+ *
+ * The IoC needs many letters per column, so it is noisy for a short ciphertext. AnalyzeKasiski() does a Kasiski
+ * examination instead: when the same trigram of plaintext falls under the same part of the key, it gives the
+ * same trigram of ciphertext, a multiple of the key length away. So the distance from each trigram of the
+ * ciphertext to the last place the same trigram was seen is counted for each of its factors. A factor f divides
+ * 1 / f of the distances of chance repeats, so the score of f is how many standard deviations more distances it
+ * divides than that, which is about 0 for a wrong period. The key length scores highest: a divisor of it
+ * divides the real repeats too, but also more chance ones, which drown them out, and a multiple of it divides
+ * only some of the real repeats. Each trigram is found with a rolling code over the alphabet, the number of the
+ * last three letters in base n, which is looked up in an open-addressed hash table of the last position of each
+ * trigram, so the examination takes one pass and memory for the distinct trigrams only, however long the
+ * ciphertext is.
+ *
+ * The ciphertext is read once, in blocks, from a file descriptor, so a message of any size can be analyzed.
+ * Each block is first turned into alphabet indices (n for a char not in the alphabet), with SSE2 when the
+ * alphabet is a run of consecutive chars. For the IoC, the candidate periods are then split across the worker
+ * threads (see Pool.h), each thread counting the letters of the block into the column histograms of its
+ * periods. Each histogram is kept in ANALYZE_SUB_HISTS copies, a pass through the key going to the next copy,
+ * so that the same counter is not incremented twice in a row, which would make each increment wait on the store
+ * of the one before it. The next block is read while the threads count the current one.
+ *
+ * Once the key length p is known, AnalyzeColumns() counts the ciphertext into the histograms of its p columns
+ * in one more pass, and AnalyzeSolve() recovers each key char from the histogram of its column: the key char is
+ * the shift of the alphabet that makes the column fit the letter frequencies of English best, by the
+ * chi-squared statistic. Each column is one histogram whatever the length of the ciphertext, and all n shifts
+ * of a column are scored with SSE2, four shifts to a vector, so the solve takes no time next to the pass.
+ *
+ * Letter frequencies need many letters per column, so they fail for a short ciphertext with a long key.
+ * AnalyzeClimb() recovers such a key by hill climbing on the log probability of the plaintext by its quadgrams
+ * (see Ngram.h) instead: each key char in turn is changed to the one that scores best, until no single change
+ * scores better. A change of one key char changes only the letters of its column, so only the quadgrams that
+ * have a letter in that column are decrypted and scored again. A climb can stop at a key that is not the best,
+ * so it is restarted from random keys, on every worker thread at once, until several restarts agree.
+ *
+ * As in the cipher, the key advances on every char of the message, but only past letters in text mode (the -t
+ * option), where the letters of both cases are counted as one.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#ifndef _ANALYZE_H_ /* Preprocessor guard to prevent Analyze.h from being included more than once */
+#define _ANALYZE_H_ /* See comments in Main.h. */
+
+#include <stddef.h>    /* For size_t */
+#include <stdint.h>    /* For uint64_t */
+#include "Ngram.h"     /* For NgramTable */
+#include "Vigenere.h"  /* For VigenereAlpha */
+
+/*==============================================================================================================
+ * Global preprocessor macros.
+ *
+ * ANALYZE_PERIOD_LEN is the default longest period that is tried (the --max-period option), and
+ * ANALYZE_PERIOD_MAX the longest that may be asked for. ANALYZE_BEST is how close to the top score a period
+ * must score to be picked as the key length by AnalyzeBest(). ANALYZE_GRAM_LEN is the length of the n-grams of
+ * the Kasiski examination, and distances shorter than ANALYZE_DIST_LEN are counted in a table and factored at
+ * the end rather than one at a time. ANALYZE_FREQ_FLOOR is the frequency, in percent, that AnalyzeSolve()
+ * expects a char of the alphabet that is not a letter to have in the plaintext. The hill climb of
+ * AnalyzeClimb() uses the first ANALYZE_CLIMB_LEN letters of the ciphertext, and stops when ANALYZE_CLIMB_AGREE
+ * restarts have found the best key, or after ANALYZE_CLIMB_RESTARTS restarts.
+ *============================================================================================================*/
+#define ANALYZE_BEST           (0.8)
+#define ANALYZE_BLOCK_LEN      (1 << 20)
+#define ANALYZE_CLIMB_AGREE    (3)
+#define ANALYZE_CLIMB_LEN      (1 << 16)
+#define ANALYZE_CLIMB_RESTARTS (100)
+#define ANALYZE_DIST_LEN       (1 << 16)
+#define ANALYZE_FREQ_FLOOR     (0.1)
+#define ANALYZE_GRAM_LEN       (3)
+#define ANALYZE_PERIOD_LEN     (64)
+#define ANALYZE_PERIOD_MAX     (256)
+#define ANALYZE_SUB_HISTS      (4)
+
+/*==============================================================================================================
+ * Global type definitions.
+ *
+ * An AnalyzePeriod is a candidate key length and its score.
+ *============================================================================================================*/
+typedef struct {
+    size_t mPeriod;  /* The candidate key length */
+    double mScore;   /* The score of the period, e.g., the mean IoC of its columns, times n */
+} AnalyzePeriod;
+
+/*==============================================================================================================
+ * Global function declarations.
+ *
+ * See comments in Main.h concerning what global function declarations are for.
+ *============================================================================================================*/
+extern size_t AnalyzeBest
+    (
+    const AnalyzePeriod *pRank,
+    size_t               pCount
+    );
+
+extern size_t AnalyzeClimb
+    (
+    int                  pFd,
+    const VigenereAlpha *pAlpha,
+    const NgramTable    *pTable,
+    size_t               pPeriod,
+    char                *pKey
+    );
+
+extern size_t AnalyzeColumns
+    (
+    int                  pFd,
+    const VigenereAlpha *pAlpha,
+    size_t               pPeriod,
+    uint64_t            *pCounts
+    );
+
+extern size_t AnalyzeIoc
+    (
+    int                  pFd,
+    const VigenereAlpha *pAlpha,
+    size_t               pMaxPeriod,
+    AnalyzePeriod       *pRank
+    );
+
+extern size_t AnalyzeKasiski
+    (
+    int                  pFd,
+    const VigenereAlpha *pAlpha,
+    size_t               pMaxPeriod,
+    AnalyzePeriod       *pRank
+    );
+
+extern void AnalyzeSolve
+    (
+    const VigenereAlpha *pAlpha,
+    const uint64_t      *pCounts,
+    size_t               pPeriod,
+    char                *pKey
+    );
+
+#endif /* __ANALYZE_H__ */
@@ -0,0 +1,604 @@
+/***************************************************************************************************************
+ * FILE: Armor.c
+ *
+ * DESCRIPTION
+ * See comments in Armor.h.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#include <ctype.h>    /* For isspace() */
+#include "Armor.h"    /* Good to always include the module header file. See comments in Globals.c. */
+#include "Globals.h"  /* For TERM_ERR_ARMOR */
+#include "Kernel.h"   /* For KernelGetTier(), KERNEL_SSE2, KERNEL_AVX2 */
+#include "Main.h"     /* For MainTerminate() */
+#include "String.h"   /* For streq */
+
+/*
+ * As in Kernel.c, the vector kernels are only written for x86, and each one is compiled for its own
+ * instruction set with the target attribute.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#define ARMOR_X86
+#include <immintrin.h>  /* For the SSE2 and AVX2 intrinsics */
+#endif
+
+/*==============================================================================================================
+ * Static function declarations.
+ *============================================================================================================*/
+#ifdef ARMOR_X86
+static size_t ArmorB64DecodeAvx2(const char *pIn, size_t pLen, char *pOut);
+static size_t ArmorB64EncodeAvx2(const char *pIn, size_t pLen, char *pOut);
+#endif
+static void ArmorB64Group(const unsigned char *pIn, char *pOut);
+static int ArmorB64Value(unsigned char pChar);
+static size_t ArmorDecode(ArmorState *pState, const char *pIn, size_t pLen, char *pOut);
+static size_t ArmorEncode(ArmorState *pState, const char *pIn, size_t pLen, char *pOut);
+static size_t ArmorFlush(ArmorState *pState, char *pOut);
+#ifdef ARMOR_X86
+static size_t ArmorHexDecodeAvx2(const char *pIn, size_t pLen, char *pOut);
+static size_t ArmorHexDecodeSse2(const char *pIn, size_t pLen, char *pOut);
+static size_t ArmorHexEncodeAvx2(const char *pIn, size_t pLen, char *pOut);
+static size_t ArmorHexEncodeSse2(const char *pIn, size_t pLen, char *pOut);
+#endif
+static int ArmorHexValue(unsigned char pChar);
+
+/*==============================================================================================================
+ * Static global variables.
+ *
+ * gArmorB64Chars is the base64 alphabet: char v is the digit for the 6-bit value v. gArmorHexChars is the same
+ * for hex.
+ *============================================================================================================*/
+static const char *gArmorB64Chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char *gArmorHexChars = "0123456789abcdef";
+
+/*==============================================================================================================
+ * Function definitions.
+ *============================================================================================================*/
+
+#ifdef ARMOR_X86
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorB64DecodeAvx2
+ * DESCR:    Decodes 32 base64 chars to 24 bytes at a time. The value of each char is its code plus an offset
+ *           that depends only on its high nibble ('A'..'Z' -65, 'a'..'z' -71, '0'..'9' +4, '+' +19) except for
+ *           '/' (+16), so the offset is looked up with a byte shuffle. Whether a char is valid is found the
+ *           same way: one shuffle by the low nibble and one by the high nibble give two bit sets that have no
+ *           bit in common exactly for the 64 valid chars. The four 6-bit values of each dword are then joined
+ *           into 24 bits with two multiply-adds, and a shuffle and a permute pack the 3 bytes of each dword
+ *           together.
+ * RETURNS:  The number of chars done, a multiple of 32. It stops at the first 32 chars that are not all valid
+ *           (whitespace, padding, or an invalid char), which are left to the scalar loop of ArmorDecode().
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static size_t ArmorB64DecodeAvx2
+    (
+    const char *pIn,
+    size_t      pLen,
+    char       *pOut
+    )
+{
+    const __m256i lutLo   = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                             0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                                             0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                             0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lutHi   = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                             0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                             0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                             0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lutRoll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                             0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i pack    = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                             2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i low = _mm256_set1_epi8(0x0F), slash = _mm256_set1_epi8('/');
+    size_t i, o = 0;
+
+    for (i = 0; i + 32 <= pLen; i += 32, o += 24) {
+        __m256i x  = _mm256_loadu_si256((const __m256i *)(pIn + i));
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi32(x, 4), low);
+        __m256i lo = _mm256_and_si256(x, low);
+        if (!_mm256_testz_si256(_mm256_shuffle_epi8(lutLo, lo), _mm256_shuffle_epi8(lutHi, hi))) break;
+        x = _mm256_add_epi8(x, _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(_mm256_cmpeq_epi8(x, slash), hi)));
+        x = _mm256_maddubs_epi16(x, _mm256_set1_epi32(0x01400140));
+        x = _mm256_madd_epi16(x, _mm256_set1_epi32(0x00011000));
+        x = _mm256_shuffle_epi8(x, pack);
+        x = _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm_storeu_si128((__m128i *)(pOut + o), _mm256_castsi256_si128(x));
+        _mm_storel_epi64((__m128i *)(pOut + o + 16), _mm256_extracti128_si256(x, 1));
+    }
+    return i;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorB64EncodeAvx2
+ * DESCR:    Encodes 24 bytes to 32 base64 chars at a time. Each 128-bit lane gets 12 bytes, and a shuffle puts
+ *           the 3 bytes of a group in a dword as bytes 1, 0, 2, 1. Two multiplies then shift the four 6-bit
+ *           fields of the group into the four bytes of the dword. The value v of a byte is turned into its char
+ *           by adding an offset that is picked with a shuffle from a 16-entry table: a saturating subtract and
+ *           a compare map 0..25 to entry 13, 26..51 to entry 0, and 52..63 to entries 1..12.
+ * RETURNS:  The number of bytes done, a multiple of 24. Each step loads 28 bytes (the second lane is loaded
+ *           from pIn + 12) and uses 24 of them, so it stops when fewer than 28 bytes are left.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static size_t ArmorB64EncodeAvx2
+    (
+    const char *pIn,
+    size_t      pLen,
+    char       *pOut
+    )
+{
+    const __m256i split = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                           1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m256i shift = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                           '/' - 63, 'A', 0, 0,
+                                           'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                           '/' - 63, 'A', 0, 0);
+    size_t i, o = 0;
+
+    for (i = 0; i + 28 <= pLen; i += 24, o += 32) {
+        __m256i x = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(pIn + i))),
+                                            _mm_loadu_si128((const __m128i *)(pIn + i + 12)), 1);
+        __m256i v, r;
+        x = _mm256_shuffle_epi8(x, split);
+        v = _mm256_or_si256(_mm256_mulhi_epu16(_mm256_and_si256(x, _mm256_set1_epi32(0x0FC0FC00)),
+                                               _mm256_set1_epi32(0x04000040)),
+                            _mm256_mullo_epi16(_mm256_and_si256(x, _mm256_set1_epi32(0x003F03F0)),
+                                               _mm256_set1_epi32(0x01000010)));
+        r = _mm256_subs_epu8(v, _mm256_set1_epi8(51));
+        r = _mm256_or_si256(r, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), v),
+                                                _mm256_set1_epi8(13)));
+        _mm256_storeu_si256((__m256i *)(pOut + o), _mm256_add_epi8(v, _mm256_shuffle_epi8(shift, r)));
+    }
+    return i;
+}
+#endif
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorB64Group
+ * DESCR:    Encodes the 3 bytes at pIn as the 4 base64 chars at pOut.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void ArmorB64Group
+    (
+    const unsigned char *pIn,
+    char                *pOut
+    )
+{
+    pOut[0] = gArmorB64Chars[pIn[0] >> 2];
+    pOut[1] = gArmorB64Chars[(pIn[0] & 0x03) << 4 | pIn[1] >> 4];
+    pOut[2] = gArmorB64Chars[(pIn[1] & 0x0F) << 2 | pIn[2] >> 6];
+    pOut[3] = gArmorB64Chars[pIn[2] & 0x3F];
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorB64Value
+ * DESCR:    Looks up the 6-bit value of the base64 digit pChar.
+ * RETURNS:  0..63, or -1 if pChar is not a base64 digit.
+ *------------------------------------------------------------------------------------------------------------*/
+static int ArmorB64Value
+    (
+    unsigned char pChar
+    )
+{
+    if (pChar >= 'A' && pChar <= 'Z') return pChar - 'A';
+    if (pChar >= 'a' && pChar <= 'z') return pChar - 'a' + 26;
+    if (pChar >= '0' && pChar <= '9') return pChar - '0' + 52;
+    if (pChar == '+') return 62;
+    if (pChar == '/') return 63;
+    return -1;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorBegin
+ * DESCR:    Initializes pState to encode (pDecode false) or decode (pDecode true) the armor pKind, from the
+ *           start of a message.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ArmorBegin
+    (
+    ArmorState *pState,
+    int         pKind,
+    bool        pDecode
+    )
+{
+    pState->mKind = pKind;
+    pState->mDecode = pDecode;
+    pState->mEnded = false;
+    pState->mPartLen = 0;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorDecode
+ * DESCR:    Decodes the pLen chars at pIn to pOut. Whenever no group is unfinished the vector kernel of the
+ *           tier in use decodes as much as it can; the rest is done one char at a time, skipping whitespace.
+ *           Terminates with an error message if a char is not whitespace, padding, or a digit of the armor.
+ * RETURNS:  The number of bytes written to pOut.
+ *------------------------------------------------------------------------------------------------------------*/
+static size_t ArmorDecode
+    (
+    ArmorState *pState,
+    const char *pIn,
+    size_t      pLen,
+    char       *pOut
+    )
+{
+    bool hex = pState->mKind == ARMOR_HEX;
+    int tier = KernelGetTier(), group = hex ? 2 : 4, v;
+    unsigned char *part = pState->mPart, c;
+    size_t i = 0, o = 0, n = 0;
+
+    while (i < pLen) {
+#ifdef ARMOR_X86
+        if (pState->mPartLen == 0) {
+            if (hex && tier >= KERNEL_AVX2) n = ArmorHexDecodeAvx2(pIn + i, pLen - i, pOut + o);
+            else if (hex && tier >= KERNEL_SSE2) n = ArmorHexDecodeSse2(pIn + i, pLen - i, pOut + o);
+            else if (!hex && tier >= KERNEL_AVX2) n = ArmorB64DecodeAvx2(pIn + i, pLen - i, pOut + o);
+            i += n;
+            o += hex ? n / 2 : n / 4 * 3;
+            if (i == pLen) break;
+        }
+#endif
+        c = (unsigned char)pIn[i++];
+        v = hex ? ArmorHexValue(c) : ArmorB64Value(c);
+        if (v >= 0 && pState->mPartLen < group - 1) {
+            part[pState->mPartLen++] = (unsigned char)v;
+        } else if (v >= 0 && hex) {
+            pOut[o++] = (char)(part[0] << 4 | v);
+            pState->mPartLen = 0;
+        } else if (v >= 0) {
+            pOut[o++] = (char)(part[0] << 2 | part[1] >> 4);
+            pOut[o++] = (char)(part[1] << 4 | part[2] >> 2);
+            pOut[o++] = (char)(part[2] << 6 | v);
+            pState->mPartLen = 0;
+        } else if (c == '=' && !hex) {
+            o += ArmorFlush(pState, pOut + o);
+        } else if (!isspace(c)) {
+            MainTerminate(TERM_ERR_ARMOR, "the armored message has a char (code %d) that is not %s.\n", (int)c,
+                          hex ? "a hex digit" : "base64");
+        }
+    }
+    return o;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorEncode
+ * DESCR:    Encodes the pLen bytes at pIn to pOut. For base64, the group left unfinished by the previous call
+ *           is finished first, and the bytes that do not make a whole group at the end are kept in pState. The
+ *           bulk of the bytes is done by the vector kernel of the tier in use.
+ * RETURNS:  The number of chars written to pOut.
+ *------------------------------------------------------------------------------------------------------------*/
+static size_t ArmorEncode
+    (
+    ArmorState *pState,
+    const char *pIn,
+    size_t      pLen,
+    char       *pOut
+    )
+{
+    const unsigned char *in = (const unsigned char *)pIn;
+    unsigned char *part = pState->mPart;
+    int tier = KernelGetTier();
+    size_t i = 0, o = 0, n;
+
+    if (pState->mKind == ARMOR_HEX) {
+#ifdef ARMOR_X86
+        if (tier >= KERNEL_AVX2) i = ArmorHexEncodeAvx2(pIn, pLen, pOut);
+        else if (tier >= KERNEL_SSE2) i = ArmorHexEncodeSse2(pIn, pLen, pOut);
+#endif
+        for (; i < pLen; ++i) {
+            pOut[2 * i]     = gArmorHexChars[in[i] >> 4];
+            pOut[2 * i + 1] = gArmorHexChars[in[i] & 0x0F];
+        }
+        return 2 * pLen;
+    }
+
+    while (pState->mPartLen > 0 && pState->mPartLen < 3 && i < pLen) part[pState->mPartLen++] = in[i++];
+    if (pState->mPartLen == 3) {
+        ArmorB64Group(part, pOut);
+        o = 4;
+        pState->mPartLen = 0;
+    }
+    if (pState->mPartLen > 0) return o;
+#ifdef ARMOR_X86
+    if (tier >= KERNEL_AVX2) {
+        n = ArmorB64EncodeAvx2(pIn + i, pLen - i, pOut + o);
+        i += n;
+        o += n / 3 * 4;
+    }
+#endif
+    for (; i + 3 <= pLen; i += 3, o += 4) ArmorB64Group(in + i, pOut + o);
+    while (i < pLen) part[pState->mPartLen++] = in[i++];
+    return o;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorEnd
+ * DESCR:    Ends the message. When encoding, writes the unfinished base64 group, padded with '=', and the final
+ *           newline to pOut. When decoding, writes the bytes of an unfinished base64 group (the padding is
+ *           optional) to pOut, and terminates with an error message if the armored message was cut short in
+ *           the middle of a byte. Calling it again does nothing.
+ * RETURNS:  The number of chars or bytes written to pOut.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t ArmorEnd
+    (
+    ArmorState *pState,
+    char       *pOut
+    )
+{
+    unsigned char *part = pState->mPart;
+    size_t o = 0;
+
+    if (pState->mEnded || pState->mKind == ARMOR_NONE) return 0;
+    pState->mEnded = true;
+    if (pState->mDecode) return ArmorFlush(pState, pOut);
+    if (pState->mPartLen > 0) {
+        if (pState->mPartLen == 1) part[1] = 0;
+        part[2] = 0;
+        ArmorB64Group(part, pOut);
+        if (pState->mPartLen == 1) pOut[2] = '=';
+        pOut[3] = '=';
+        o = 4;
+        pState->mPartLen = 0;
+    }
+    pOut[o++] = '\n';
+    return o;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorFlush
+ * DESCR:    Decodes the unfinished group of pState, at padding or at the end of the message: 2 base64 digits
+ *           make 1 byte and 3 make 2. Terminates with an error message if there is a lone base64 digit or hex
+ *           digit, which cannot make a whole byte.
+ * RETURNS:  The number of bytes written to pOut.
+ *------------------------------------------------------------------------------------------------------------*/
+static size_t ArmorFlush
+    (
+    ArmorState *pState,
+    char       *pOut
+    )
+{
+    const unsigned char *part = pState->mPart;
+    int len = pState->mPartLen;
+
+    pState->mPartLen = 0;
+    if (len == 0) return 0;
+    if (len == 1) MainTerminate(TERM_ERR_ARMOR, "the armored message ends in the middle of a byte.\n");
+    pOut[0] = (char)(part[0] << 2 | part[1] >> 4);
+    if (len == 2) return 1;
+    pOut[1] = (char)(part[1] << 4 | part[2] >> 2);
+    return 2;
+}
+
+#ifdef ARMOR_X86
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorHexDecodeAvx2
+ * DESCR:    Same as ArmorHexDecodeSse2() but 64 chars to 32 bytes at a time. The pack works within each 128-bit
+ *           lane, so a permute puts the four 8-byte quarters back in order.
+ * RETURNS:  The number of chars done, a multiple of 64.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static size_t ArmorHexDecodeAvx2
+    (
+    const char *pIn,
+    size_t      pLen,
+    char       *pOut
+    )
+{
+    const __m256i zero = _mm256_set1_epi8('0'), nine = _mm256_set1_epi8(9), a = _mm256_set1_epi8('a');
+    const __m256i five = _mm256_set1_epi8(5), ten = _mm256_set1_epi8(10), lower = _mm256_set1_epi8(0x20);
+    const __m256i byte = _mm256_set1_epi16(0x00FF);
+    __m256i x[2], r[2];
+    size_t i;
+    int j;
+
+    for (i = 0; i + 64 <= pLen; i += 64) {
+        __m256i ok = _mm256_set1_epi8(-1);
+        for (j = 0; j < 2; ++j) {
+            __m256i c   = _mm256_loadu_si256((const __m256i *)(pIn + i + 32 * j));
+            __m256i d   = _mm256_sub_epi8(c, zero);
+            __m256i l   = _mm256_sub_epi8(_mm256_or_si256(c, lower), a);
+            __m256i isD = _mm256_cmpeq_epi8(_mm256_min_epu8(d, nine), d);
+            __m256i isL = _mm256_cmpeq_epi8(_mm256_min_epu8(l, five), l);
+            ok = _mm256_and_si256(ok, _mm256_or_si256(isD, isL));
+            x[j] = _mm256_or_si256(_mm256_and_si256(isD, d), _mm256_and_si256(isL, _mm256_add_epi8(l, ten)));
+            r[j] = _mm256_or_si256(_mm256_slli_epi16(_mm256_and_si256(x[j], byte), 4),
+                                   _mm256_srli_epi16(x[j], 8));
+        }
+        if (_mm256_movemask_epi8(ok) != -1) break;
+        _mm256_storeu_si256((__m256i *)(pOut + i / 2), _mm256_permute4x64_epi64(_mm256_packus_epi16(r[0], r[1]),
+                                                                                 0xD8));
+    }
+    return i;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorHexDecodeSse2
+ * DESCR:    Decodes 32 hex digits to 16 bytes at a time. For each lane,
+ *
+ *           d     <- char - '0'                           -- 0..9 for a decimal digit
+ *           l     <- (char | 0x20) - 'a'                  -- 0..5 for 'a'..'f' or 'A'..'F'
+ *           value <- d <= 9 ? d : l <= 5 ? l + 10 : bad   -- unsigned compares with min, as in Kernel.c
+ *
+ *           Each pair of values is one 16-bit lane, high digit in the low byte, so (lane << 4 | lane >> 8),
+ *           masked to a byte and packed, is the decoded byte.
+ * RETURNS:  The number of chars done, a multiple of 32. It stops at the first 32 chars that are not all hex
+ *           digits, which are left to the scalar loop of ArmorDecode().
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("sse2")))
+static size_t ArmorHexDecodeSse2
+    (
+    const char *pIn,
+    size_t      pLen,
+    char       *pOut
+    )
+{
+    const __m128i zero = _mm_set1_epi8('0'), nine = _mm_set1_epi8(9), a = _mm_set1_epi8('a');
+    const __m128i five = _mm_set1_epi8(5), ten = _mm_set1_epi8(10), lower = _mm_set1_epi8(0x20);
+    const __m128i byte = _mm_set1_epi16(0x00FF);
+    __m128i x[2], r[2];
+    size_t i;
+    int j;
+
+    for (i = 0; i + 32 <= pLen; i += 32) {
+        __m128i ok = _mm_set1_epi8(-1);
+        for (j = 0; j < 2; ++j) {
+            __m128i c   = _mm_loadu_si128((const __m128i *)(pIn + i + 16 * j));
+            __m128i d   = _mm_sub_epi8(c, zero);
+            __m128i l   = _mm_sub_epi8(_mm_or_si128(c, lower), a);
+            __m128i isD = _mm_cmpeq_epi8(_mm_min_epu8(d, nine), d);
+            __m128i isL = _mm_cmpeq_epi8(_mm_min_epu8(l, five), l);
+            ok = _mm_and_si128(ok, _mm_or_si128(isD, isL));
+            x[j] = _mm_or_si128(_mm_and_si128(isD, d), _mm_and_si128(isL, _mm_add_epi8(l, ten)));
+            r[j] = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(x[j], byte), 4), _mm_srli_epi16(x[j], 8));
+        }
+        if (_mm_movemask_epi8(ok) != 0xFFFF) break;
+        _mm_storeu_si128((__m128i *)(pOut + i / 2), _mm_packus_epi16(r[0], r[1]));
+    }
+    return i;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorHexEncodeAvx2
+ * DESCR:    Same as ArmorHexEncodeSse2() but 32 bytes to 64 chars at a time. The unpacks work within each
+ *           128-bit lane, so two permutes put the halves back in order.
+ * RETURNS:  The number of bytes done, a multiple of 32.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static size_t ArmorHexEncodeAvx2
+    (
+    const char *pIn,
+    size_t      pLen,
+    char       *pOut
+    )
+{
+    const __m256i low = _mm256_set1_epi8(0x0F), nine = _mm256_set1_epi8(9), zero = _mm256_set1_epi8('0');
+    const __m256i gap = _mm256_set1_epi8('a' - '0' - 10);
+    size_t i;
+
+    for (i = 0; i + 32 <= pLen; i += 32) {
+        __m256i x  = _mm256_loadu_si256((const __m256i *)(pIn + i));
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), low);
+        __m256i lo = _mm256_and_si256(x, low);
+        __m256i a  = _mm256_unpacklo_epi8(hi, lo);
+        __m256i b  = _mm256_unpackhi_epi8(hi, lo);
+        a = _mm256_add_epi8(_mm256_add_epi8(a, zero), _mm256_and_si256(_mm256_cmpgt_epi8(a, nine), gap));
+        b = _mm256_add_epi8(_mm256_add_epi8(b, zero), _mm256_and_si256(_mm256_cmpgt_epi8(b, nine), gap));
+        _mm256_storeu_si256((__m256i *)(pOut + 2 * i), _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256((__m256i *)(pOut + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    return i;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorHexEncodeSse2
+ * DESCR:    Encodes 16 bytes to 32 hex digits at a time. The high and low nibbles of the bytes are interleaved
+ *           with unpacks, and each nibble n becomes n + '0', plus 'a' - '0' - 10 if n > 9.
+ * RETURNS:  The number of bytes done, a multiple of 16.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("sse2")))
+static size_t ArmorHexEncodeSse2
+    (
+    const char *pIn,
+    size_t      pLen,
+    char       *pOut
+    )
+{
+    const __m128i low = _mm_set1_epi8(0x0F), nine = _mm_set1_epi8(9), zero = _mm_set1_epi8('0');
+    const __m128i gap = _mm_set1_epi8('a' - '0' - 10);
+    size_t i;
+
+    for (i = 0; i + 16 <= pLen; i += 16) {
+        __m128i x  = _mm_loadu_si128((const __m128i *)(pIn + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), low);
+        __m128i lo = _mm_and_si128(x, low);
+        __m128i a  = _mm_unpacklo_epi8(hi, lo);
+        __m128i b  = _mm_unpackhi_epi8(hi, lo);
+        a = _mm_add_epi8(_mm_add_epi8(a, zero), _mm_and_si128(_mm_cmpgt_epi8(a, nine), gap));
+        b = _mm_add_epi8(_mm_add_epi8(b, zero), _mm_and_si128(_mm_cmpgt_epi8(b, nine), gap));
+        _mm_storeu_si128((__m128i *)(pOut + 2 * i), a);
+        _mm_storeu_si128((__m128i *)(pOut + 2 * i + 16), b);
+    }
+    return i;
+}
+#endif
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorHexValue
+ * DESCR:    Looks up the value of the hex digit pChar, which may be upper or lower case.
+ * RETURNS:  0..15, or -1 if pChar is not a hex digit.
+ *------------------------------------------------------------------------------------------------------------*/
+static int ArmorHexValue
+    (
+    unsigned char pChar
+    )
+{
+    if (pChar >= '0' && pChar <= '9') return pChar - '0';
+    if (pChar >= 'a' && pChar <= 'f') return pChar - 'a' + 10;
+    if (pChar >= 'A' && pChar <= 'F') return pChar - 'A' + 10;
+    return -1;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorMaxLen
+ * DESCR:    Finds how big an output buffer must be for ArmorRun() on pLen bytes or chars, followed by
+ *           ArmorEnd().
+ * RETURNS:  The most chars (encoding) or bytes (decoding) those two calls can write.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t ArmorMaxLen
+    (
+    const ArmorState *pState,
+    size_t            pLen
+    )
+{
+    if (pState->mKind == ARMOR_NONE) return pLen;
+    if (pState->mDecode) return pLen + 3;
+    if (pState->mKind == ARMOR_HEX) return 2 * pLen + 1;
+    return (pLen + 2) / 3 * 4 + 5;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorNamed
+ * DESCR:    Looks up the armor named pName, "hex" or "base64".
+ * RETURNS:  ARMOR_HEX or ARMOR_BASE64, or -1 if there is no armor named pName.
+ *------------------------------------------------------------------------------------------------------------*/
+int ArmorNamed
+    (
+    const char *pName
+    )
+{
+    if (streq(pName, "hex")) return ARMOR_HEX;
+    if (streq(pName, "base64")) return ARMOR_BASE64;
+    return -1;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ArmorRun
+ * DESCR:    Encodes or decodes the next pLen bytes or chars of the message, at pIn, to pOut, which must have
+ *           room for ArmorMaxLen(pState, pLen) bytes. pIn and pOut must not overlap.
+ * RETURNS:  The number of chars (encoding) or bytes (decoding) written to pOut.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t ArmorRun
+    (
+    ArmorState *pState,
+    const char *pIn,
+    size_t      pLen,
+    char       *pOut
+    )
+{
+    if (pState->mKind == ARMOR_NONE) return 0;
+    return pState->mDecode ? ArmorDecode(pState, pIn, pLen, pOut) : ArmorEncode(pState, pIn, pLen, pOut);
+}
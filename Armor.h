@@ -0,0 +1,99 @@
+/***************************************************************************************************************
+ * FILE: Armor.h
+ *
+ * DESCRIPTION
+ * ASCII armor for the ciphertext (the --armor option). A binary ciphertext cannot pass through a channel that
+ * only carries text, so with armor the ciphertext is written as hex (two lowercase hex digits per byte) or as
+ * base64 (RFC 4648, four chars per three bytes, padded with '='), followed by a newline. The armor is applied
+ * to the ciphertext side only: encryption encodes its output and decryption decodes its input, in the same
+ * pass over each block as the cipher (see Stream.c), so there is no second process and no second copy of the
+ * message.
+ *
+ * An ArmorState carries the part of a group that is left over at the end of one block to the next one: up to
+ * two bytes when encoding base64, up to three base64 chars or one hex digit when decoding. The decoder skips
+ * whitespace (so wrapped lines, like those of base64(1), are fine), accepts both cases of hex digits, and
+ * treats padding as optional.
+ *
+ * The encoders and decoders have vector kernels that follow the tier of the Kernel module (see Kernel.h). Hex
+ * uses SSE2 and AVX2, with arithmetic in place of a table lookup. Base64 uses AVX2, with byte shuffles for the
+ * table lookups and multiplies to move the 6-bit fields; the sse2 tier has no byte shuffle, so it does base64
+ * with the scalar loop. The avx512bw tier uses the AVX2 kernels.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#ifndef _ARMOR_H_ /* Preprocessor guard to prevent Armor.h from being included more than once */
+#define _ARMOR_H_ /* See comments in Main.h. */
+
+#include <stddef.h>  /* For size_t */
+#include "Types.h"   /* For bool */
+
+/*==============================================================================================================
+ * Global preprocessor macros.
+ *============================================================================================================*/
+#define ARMOR_NONE   (0)
+#define ARMOR_HEX    (1)
+#define ARMOR_BASE64 (2)
+
+/*==============================================================================================================
+ * Global type definitions.
+ *============================================================================================================*/
+typedef struct {
+    int           mKind;     /* ARMOR_NONE, ARMOR_HEX, or ARMOR_BASE64 */
+    bool          mDecode;   /* true to decode armored text to bytes, false to encode bytes */
+    bool          mEnded;    /* true once ArmorEnd() has been called */
+    unsigned char mPart[3];  /* The bytes (encoding) or the digit values (decoding) of an unfinished group */
+    int           mPartLen;  /* The number of entries of mPart in use */
+} ArmorState;
+
+/*==============================================================================================================
+ * Global function declarations.
+ *
+ * See comments in Main.h concerning what global function declarations are for.
+ *============================================================================================================*/
+extern void ArmorBegin
+    (
+    ArmorState *pState,
+    int         pKind,
+    bool        pDecode
+    );
+
+extern size_t ArmorEnd
+    (
+    ArmorState *pState,
+    char       *pOut
+    );
+
+extern size_t ArmorMaxLen
+    (
+    const ArmorState *pState,
+    size_t            pLen
+    );
+
+extern int ArmorNamed
+    (
+    const char *pName
+    );
+
+extern size_t ArmorRun
+    (
+    ArmorState *pState,
+    const char *pIn,
+    size_t      pLen,
+    char       *pOut
+    );
+
+#endif /* __ARMOR_H__ */
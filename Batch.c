@@ -0,0 +1,418 @@
+/***************************************************************************************************************
+ * FILE: Batch.c
+ *
+ * DESCRIPTION
+ * See comments in Batch.h.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>      /* For FILE, fopen(), fgets(), fclose() */
+#include <stdlib.h>     /* For calloc(), free(), malloc(), qsort(), realloc() */
+#include <string.h>     /* For memset(), strchr(), strcmp(), strlen(), strtok() */
+#include <sys/stat.h>   /* For stat() */
+#include "Batch.h"      /* Good to always include the module header file. See comments in Globals.c. */
+#include "File.h"       /* For FileMap(), FileMapNew(), FileReadBytes(), FileReadStr(), FileSame(), ... */
+#include "Globals.h"    /* For MAX_MSG_LEN, TERM_ERR_BUG, TERM_ERR_FILE, TERM_ERR_KEYFILE, TERM_ERR_MODE */
+#include "Main.h"       /* For MainTerminate() */
+#include "Model.h"      /* For ModelGetAlpha() */
+#include "Pool.h"       /* For PoolApply(), PoolGroup, PoolSubmit(), PoolWait() */
+#include "String.h"     /* For streq, StrDup() */
+#include "Vigenere.h"   /* For VigenereApply(), VigenereSchedBegin(), VigenereSchedEnd() */
+
+/*==============================================================================================================
+ * Preprocessor macros.
+ *
+ * A file longer than BATCH_CHUNK_LEN bytes is split into chunks of that many bytes, each of which is a task of
+ * its own. It is a multiple of 64 so that every chunk but the last runs whole vectors. BATCH_LINE_LEN is the
+ * longest manifest line that can be read.
+ *============================================================================================================*/
+#define BATCH_CHUNK_LEN (4 << 20)
+#define BATCH_LINE_LEN  (4096)
+
+/*==============================================================================================================
+ * Static global variables and types.
+ *
+ * A BatchKey is a key schedule built from one key file for one mode. A BatchJob is one line of the manifest.
+ * The jobs point at the BatchKey they use rather than owning a schedule, so that a key file used by a thousand
+ * jobs is read once. A BatchChunk is the argument of BatchChunkTask(): one chunk of one job's file. A BatchFile
+ * is one input or output file of a job while BatchOrder() works out which jobs use the same files.
+ *============================================================================================================*/
+typedef struct {
+    char          *mFilename;  /* The key file */
+    bool           mMode;      /* VIGENERE_ENCRYPT or VIGENERE_DECRYPT */
+    VigenereSched  mSched;     /* The schedule built from the key in mFilename for mMode */
+} BatchKey;
+
+typedef struct BatchChunk BatchChunk;
+
+typedef struct {
+    size_t               mKey;     /* The index of the job's key in gBatch.mKeys */
+    const VigenereSched *mSched;   /* The key schedule, &gBatch.mKeys[mKey].mSched */
+    char                *mIn;      /* The input file name */
+    char                *mOut;     /* The output file name, which may name the same file as mIn */
+    char                *mInMap;   /* The mapped input file */
+    char                *mOutMap;  /* The mapped output file, which is mInMap if the job is in place */
+    size_t               mLen;     /* The length of the input (and output) file */
+    size_t               mLeft;    /* The number of chunks not yet finished */
+    BatchChunk          *mChunks;  /* The chunks, if the file was split */
+    size_t               mWave;    /* The job runs after every job of an earlier wave (see BatchOrder()) */
+} BatchJob;
+
+typedef struct {
+    char   *mName;    /* The file name, as written in the manifest */
+    bool    mExists;  /* true if the file existed when the manifest was read */
+    dev_t   mDev;     /* The device of the file, if it exists */
+    ino_t   mIno;     /* The inode of the file, if it exists */
+    size_t  mRef;     /* 2 * (index of the job) for the job's input, plus 1 for its output */
+} BatchFile;
+
+struct BatchChunk {
+    BatchJob *mJob;  /* The job that the chunk belongs to */
+    size_t    mOff;  /* The offset of the chunk in the file */
+};
+
+static struct {
+    BatchKey *mKeys;     /* The distinct (key file, mode) pairs */
+    size_t    mNumKeys;  /* The number of entries in mKeys */
+    BatchJob *mJobs;     /* The jobs, in manifest order */
+    size_t    mNumJobs;  /* The number of entries in mJobs */
+    PoolGroup mPending;  /* The jobs and their chunks, which are all waited for together */
+} gBatch;
+
+/*==============================================================================================================
+ * Static function declarations.
+ *============================================================================================================*/
+static void BatchChunkTask(void *pArg);
+static int BatchFileCompare(const void *pLeft, const void *pRight);
+static void BatchJobEnd(BatchJob *pJob);
+static void BatchJobTask(void *pArg);
+static size_t BatchKeyGet(char *pFilename, bool pMode);
+static BatchJob **BatchOrder();
+static void BatchParse(char *pFilename);
+
+/*==============================================================================================================
+ * Function definitions.
+ *============================================================================================================*/
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: BatchChunkTask
+ * DESCR:    Encrypts or decrypts one chunk of a job's file. The chunk starts at key index mOff % (key length).
+ *           Whichever chunk of a job finishes last unmaps the job's files.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void BatchChunkTask
+    (
+    void *pArg
+    )
+{
+    BatchChunk *chunk = pArg;
+    BatchJob *job = chunk->mJob;
+    size_t len = job->mLen - chunk->mOff < BATCH_CHUNK_LEN ? job->mLen - chunk->mOff : BATCH_CHUNK_LEN;
+
+    VigenereApply(job->mSched, chunk->mOff % job->mSched->mLen, job->mInMap + chunk->mOff,
+                  job->mOutMap + chunk->mOff, len);
+    if (__atomic_sub_fetch(&job->mLeft, 1, __ATOMIC_ACQ_REL) == 0) BatchJobEnd(job);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: BatchFileCompare
+ * DESCR:    The qsort() comparison of two BatchFiles: files that exist first, ordered by device and inode, so
+ *           that two names of the same file compare equal, and then files that do not exist, ordered by name.
+ * RETURNS:  < 0, 0, or > 0 as pLeft goes before, with, or after pRight.
+ *------------------------------------------------------------------------------------------------------------*/
+static int BatchFileCompare
+    (
+    const void *pLeft,
+    const void *pRight
+    )
+{
+    const BatchFile *left = pLeft, *right = pRight;
+
+    if (left->mExists != right->mExists) return left->mExists ? -1 : 1;
+    if (!left->mExists) return strcmp(left->mName, right->mName);
+    if (left->mDev != right->mDev) return left->mDev < right->mDev ? -1 : 1;
+    return left->mIno < right->mIno ? -1 : left->mIno > right->mIno;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: BatchJobEnd
+ * DESCR:    Unmaps the files of a job whose chunks are all finished.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void BatchJobEnd
+    (
+    BatchJob *pJob
+    )
+{
+    if (pJob->mOutMap != pJob->mInMap) FileUnmap(pJob->mOutMap, pJob->mLen);
+    FileUnmap(pJob->mInMap, pJob->mLen);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: BatchJobTask
+ * DESCR:    Runs one job. The input file is mapped, and so is the output file unless it is the input file, in
+ *           which case the job is done in place. A file of at most BATCH_CHUNK_LEN bytes is done right here. A
+ *           longer one for the text alphabet, whose key index at a chunk is not known until the letters before
+ *           the chunk are counted, is run by PoolApply(), which counts them in parallel and waits for its own
+ *           slices, running them on this thread too. Any other longer one is split into chunks: all but the
+ *           first are submitted to the pool, where they go on this thread's own queue for idle threads to
+ *           steal, and then this thread does the first one.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void BatchJobTask
+    (
+    void *pArg
+    )
+{
+    BatchJob *job = pArg;
+    size_t n, c;
+
+    if (FileSame(job->mIn, job->mOut)) {
+        job->mInMap = job->mOutMap = FileMap(job->mIn, true, &job->mLen);
+    } else {
+        job->mInMap = FileMap(job->mIn, false, &job->mLen);
+        job->mOutMap = FileMapNew(job->mOut, job->mLen);
+    }
+    n = (job->mLen + BATCH_CHUNK_LEN - 1) / BATCH_CHUNK_LEN;
+    if (n <= 1 || job->mSched->mAlpha.mText) {
+        if (n <= 1) VigenereApply(job->mSched, 0, job->mInMap, job->mOutMap, job->mLen);
+        else PoolApply(job->mSched, 0, job->mInMap, job->mOutMap, job->mLen);
+        BatchJobEnd(job);
+        return;
+    }
+    job->mChunks = malloc(n * sizeof(BatchChunk));
+    if (!job->mChunks) MainTerminate(TERM_ERR_BUG, "could not allocate the chunks of '%s'.\n", job->mIn);
+    job->mLeft = n;
+    for (c = 0; c < n; ++c) {
+        job->mChunks[c].mJob = job;
+        job->mChunks[c].mOff = c * BATCH_CHUNK_LEN;
+    }
+    for (c = 1; c < n; ++c) PoolSubmit(&gBatch.mPending, BatchChunkTask, &job->mChunks[c]);
+    BatchChunkTask(&job->mChunks[0]);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: BatchKeyGet
+ * DESCR:    Finds the key schedule for key file pFilename and mode pMode. If this is the first job to use them,
+ *           the key file is read (all of it, as raw bytes, for the binary alphabet, otherwise its first word),
+ *           the schedule is built, and gBatch.mKeys takes ownership of pFilename. Fails and terminates with an
+ *           error message if the key file is empty or the schedule could not be built.
+ * RETURNS:  The index of the key in gBatch.mKeys. An index rather than a pointer, because mKeys moves as it
+ *           grows.
+ *------------------------------------------------------------------------------------------------------------*/
+static size_t BatchKeyGet
+    (
+    char *pFilename,
+    bool  pMode
+    )
+{
+    char key[MAX_MSG_LEN+1], *bytes = NULL;
+    BatchKey *keys;
+    size_t k, len;
+
+    for (k = 0; k < gBatch.mNumKeys; ++k) {
+        if (gBatch.mKeys[k].mMode == pMode && streq(gBatch.mKeys[k].mFilename, pFilename)) {
+            return k;
+        }
+    }
+    if (ModelGetAlpha()->mLen == VIGENERE_ALPHA_BYTES) {
+        bytes = FileReadBytes(pFilename, &len);
+    } else {
+        FileReadStr(pFilename, key, MAX_MSG_LEN);
+        len = strlen(key);
+    }
+    if (!len) MainTerminate(TERM_ERR_KEYFILE, "key file '%s' is empty.\n", pFilename);
+    keys = realloc(gBatch.mKeys, (gBatch.mNumKeys + 1) * sizeof(BatchKey));
+    if (!keys) MainTerminate(TERM_ERR_BUG, "could not allocate the key table.\n");
+    gBatch.mKeys = keys;
+    keys[k].mFilename = pFilename;
+    keys[k].mMode = pMode;
+    if (!VigenereSchedBegin(&keys[k].mSched, pMode, bytes ? bytes : key, len, ModelGetAlpha())) {
+        MainTerminate(TERM_ERR_KEYFILE, "key file '%s' has a char that is not in the alphabet.\n", pFilename);
+    }
+    free(bytes);
+    ++gBatch.mNumKeys;
+    return k;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: BatchOrder
+ * DESCR:    Puts the jobs into waves, so that a job that reads or writes a file written by an earlier job of
+ *           the manifest, or writes a file read by an earlier job, runs after that job has finished. The files
+ *           are numbered by sorting them (see BatchFileCompare()), and then, in manifest order, each job's wave
+ *           is one past the latest wave of the jobs it must follow. The jobs of one wave are independent, so
+ *           they all run at once. A file that does not exist yet is matched by name, so every job that uses it
+ *           must name it the same way. Fails and terminates with an error message if memory could not be
+ *           allocated.
+ * RETURNS:  The jobs sorted by wave, in manifest order within a wave. The caller frees the array.
+ *------------------------------------------------------------------------------------------------------------*/
+static BatchJob **BatchOrder
+    (
+    )
+{
+    size_t n = gBatch.mNumJobs, f, id, j, wave, in, out, *ids, *written, *read, *count;
+    BatchFile *files;
+    BatchJob **order;
+    struct stat st;
+
+    /* written[id] and read[id] are 1 + the latest wave that writes or reads file id, or 0 if none does yet. */
+    files = malloc((2 * n + 1) * sizeof(BatchFile));
+    ids = malloc((2 * n + 1) * sizeof(size_t));
+    written = calloc(4 * n + 1, sizeof(size_t));
+    count = calloc(n + 1, sizeof(size_t));
+    order = malloc((n + 1) * sizeof(BatchJob *));
+    if (!files || !ids || !written || !count || !order) {
+        MainTerminate(TERM_ERR_BUG, "could not allocate the job table.\n");
+    }
+    read = written + 2 * n;
+
+    for (f = 0; f < 2 * n; ++f) {
+        files[f].mName = f & 1 ? gBatch.mJobs[f / 2].mOut : gBatch.mJobs[f / 2].mIn;
+        files[f].mExists = stat(files[f].mName, &st) == 0;
+        files[f].mDev = files[f].mExists ? st.st_dev : 0;
+        files[f].mIno = files[f].mExists ? st.st_ino : 0;
+        files[f].mRef = f;
+    }
+    qsort(files, 2 * n, sizeof(BatchFile), BatchFileCompare);
+    for (f = 0, id = 0; f < 2 * n; ++f) {
+        if (f > 0 && BatchFileCompare(&files[f - 1], &files[f]) != 0) ++id;
+        ids[files[f].mRef] = id;
+    }
+
+    for (j = 0; j < n; ++j) {
+        in = ids[2 * j];
+        out = ids[2 * j + 1];
+        wave = written[in];
+        if (written[out] > wave) wave = written[out];
+        if (read[out] > wave) wave = read[out];
+        gBatch.mJobs[j].mWave = wave;
+        if (read[in] < wave + 1) read[in] = wave + 1;
+        written[out] = wave + 1;
+        ++count[wave + 1];
+    }
+    for (wave = 1; wave <= n; ++wave) count[wave] += count[wave - 1];
+    for (j = 0; j < n; ++j) order[count[gBatch.mJobs[j].mWave]++] = &gBatch.mJobs[j];
+
+    free(files);
+    free(ids);
+    free(written);
+    free(count);
+    return order;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: BatchParse
+ * DESCR:    Reads the manifest pFilename into gBatch.mJobs. Each job's key is found or loaded by BatchKeyGet(),
+ *           and once every key has been loaded, each job is pointed at its key schedule. Fails and terminates
+ *           with an error message if the manifest could not be read or a line is malformed.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void BatchParse
+    (
+    char *pFilename
+    )
+{
+    char line[BATCH_LINE_LEN], *field[5];
+    size_t cap = 0, j;
+    BatchJob *job;
+    FILE *in;
+    int lineNum, f;
+    bool mode;
+
+    in = fopen(pFilename, "rt");
+    if (!in) MainTerminate(TERM_ERR_FILE, "could not open '%s' for reading.\n", pFilename);
+    for (lineNum = 1; fgets(line, sizeof(line), in); ++lineNum) {
+        if (!strchr(line, '\n') && !feof(in)) {
+            MainTerminate(TERM_ERR_FILE, "%s line %d: line is too long.\n", pFilename, lineNum);
+        }
+        for (f = 0; f < 5 && (field[f] = strtok(f == 0 ? line : NULL, " \t\r\n")); ++f) ;
+        if (f == 0 || field[0][0] == '#') continue;
+        if (f != 4) {
+            MainTerminate(TERM_ERR_FILE, "%s line %d: expected 'mode keyfile infile outfile'.\n", pFilename,
+                          lineNum);
+        }
+        if (!streq(field[0], "e") && !streq(field[0], "d")) {
+            MainTerminate(TERM_ERR_MODE, "%s line %d: invalid mode '%s'.\n", pFilename, lineNum, field[0]);
+        }
+        mode = streq(field[0], "e") ? VIGENERE_ENCRYPT : VIGENERE_DECRYPT;
+
+        if (gBatch.mNumJobs == cap) {
+            cap = cap ? 2 * cap : 256;
+            job = realloc(gBatch.mJobs, cap * sizeof(BatchJob));
+            if (!job) MainTerminate(TERM_ERR_BUG, "could not allocate the job table.\n");
+            gBatch.mJobs = job;
+        }
+        job = &gBatch.mJobs[gBatch.mNumJobs++];
+        memset(job, 0, sizeof(BatchJob));
+        job->mIn = StrDup(field[2]);
+        job->mOut = StrDup(field[3]);
+        field[1] = StrDup(field[1]);
+        if (!job->mIn || !job->mOut || !field[1]) {
+            MainTerminate(TERM_ERR_BUG, "could not allocate the job table.\n");
+        }
+
+        /* The key table owns field[1] if this is a new key, otherwise it is not needed. */
+        j = gBatch.mNumKeys;
+        job->mKey = BatchKeyGet(field[1], mode);
+        if (gBatch.mNumKeys == j) free(field[1]);
+    }
+    fclose(in);
+    for (j = 0; j < gBatch.mNumJobs; ++j) {
+        gBatch.mJobs[j].mSched = &gBatch.mKeys[gBatch.mJobs[j].mKey].mSched;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: BatchRun
+ * DESCR:    Runs every job of the manifest pFilename on the thread pool, one wave (see BatchOrder()) at a time,
+ *           and waits for all of them to finish. If the pool has not been started, the jobs are run one after
+ *           another on this thread.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void BatchRun
+    (
+    char *pFilename
+    )
+{
+    BatchJob **order;
+    size_t j, k;
+
+    BatchParse(pFilename);
+    order = BatchOrder();
+    for (j = 0; j < gBatch.mNumJobs; j = k) {
+        for (k = j; k < gBatch.mNumJobs && order[k]->mWave == order[j]->mWave; ++k) {
+            PoolSubmit(&gBatch.mPending, BatchJobTask, order[k]);
+        }
+        PoolWait(&gBatch.mPending);
+    }
+    free(order);
+
+    for (j = 0; j < gBatch.mNumJobs; ++j) {
+        free(gBatch.mJobs[j].mIn);
+        free(gBatch.mJobs[j].mOut);
+        free(gBatch.mJobs[j].mChunks);
+    }
+    for (j = 0; j < gBatch.mNumKeys; ++j) {
+        VigenereSchedEnd(&gBatch.mKeys[j].mSched);
+        free(gBatch.mKeys[j].mFilename);
+    }
+    free(gBatch.mJobs);
+    free(gBatch.mKeys);
+    memset(&gBatch, 0, sizeof(gBatch));
+}
@@ -0,0 +1,49 @@
+/***************************************************************************************************************
+ * FILE: Batch.h
+ *
+ * DESCRIPTION
+ * Batch mode. A manifest file lists jobs, one per line, each of which encrypts or decrypts one file into
+ * another (or into itself) with some key file:
+ *
+ *     # mode  keyfile   infile      outfile
+ *     e       key1.txt  plain1.txt  cipher1.txt
+ *     d       key1.txt  cipher1.txt plain1.txt
+ *
+ * Fields are separated by spaces or tabs, so file names cannot contain them. Blank lines and lines starting
+ * with '#' are skipped. All of the jobs are run by one process on the thread pool (see Pool.h), so there is no
+ * fork/exec per file. Jobs run at the same time unless one uses a file that an earlier job of the manifest
+ * writes, or writes a file that an earlier job reads, like the d job above, which runs after the e job. Each
+ * distinct key file is read, and its key schedule built, only once per mode, and shared by every job that uses
+ * it. A big file is split into chunks that idle threads steal, so a few huge files among many small ones still
+ * keep every thread busy.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#ifndef _BATCH_H_ /* Preprocessor guard to prevent Batch.h from being included more than once */
+#define _BATCH_H_ /* See comments in Main.h. */
+
+/*==============================================================================================================
+ * Global function declarations.
+ *
+ * See comments in Main.h concerning what global function declarations are for.
+ *============================================================================================================*/
+extern void BatchRun
+    (
+    char *pFilename
+    );
+
+#endif /* __BATCH_H__ */
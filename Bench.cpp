@@ -0,0 +1,113 @@
+/***************************************************************************************************************
+ * FILE: Bench.cpp
+ *
+ * DESCRIPTION
+ * Benchmark of the run time key kernels (vigenere::Cipher, one run per kernel tier this CPU supports) against
+ * the compile time key cipher (vigenere::FixedCipher), built by "make bench". Usage:
+ *
+ *     ./bench [megabytes]
+ *
+ * A buffer of random uppercase letters with a space about every sixth char (64 MB by default) is encrypted
+ * in place, several times with each cipher and each key, and the best time is reported in MB/s. The output
+ * of every cipher is checked against the output of the first one, so a wrong result cannot look fast.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#include <chrono>           // For std::chrono::steady_clock
+#include <cstdio>           // For std::printf()
+#include <cstdlib>          // For std::atoi()
+#include <random>           // For std::mt19937
+#include <string>           // For std::string
+#include <string_view>      // For std::string_view
+#include "VigenereLib.hpp"  // For vigenere::Cipher, vigenere::FixedCipher
+
+static constexpr int BENCH_RUNS = 5;
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: BenchTime
+ * DESCR:    Copies pIn to pOut and runs pApply on pOut BENCH_RUNS times, starting from a fresh copy each time.
+ * RETURNS:  The best MB/s.
+ *------------------------------------------------------------------------------------------------------------*/
+template <typename F>
+static double BenchTime
+    (
+    const std::string &pIn,
+    std::string       &pOut,
+    F                  pApply
+    )
+{
+    double best = 0;
+    for (int run = 0; run < BENCH_RUNS; ++run) {
+        pOut = pIn;
+        auto start = std::chrono::steady_clock::now();
+        pApply(std::span<char>(pOut));
+        std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+        double mbs = pIn.size() / 1e6 / secs.count();
+        if (mbs > best) best = mbs;
+    }
+    return best;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: BenchKey
+ * DESCR:    Benchmarks every kernel tier and the FixedCipher for key Key.
+ * RETURNS:  false if some output differs from the output of the first tier.
+ *------------------------------------------------------------------------------------------------------------*/
+template <vigenere::FixedKey Key>
+static bool BenchKey
+    (
+    const std::string &pIn
+    )
+{
+    static const char *const tiers[] = { "scalar", "swar", "sse2", "avx2", "avx512bw" };
+    std::string key(Key.mKey), expect, out;
+    vigenere::Cipher cipher(key, vigenere::Mode::Encrypt);
+    bool ok = true;
+
+    for (const char *tier : tiers) {
+        if (!vigenere::Cipher::Kernel(tier)) continue;
+        double mbs = BenchTime(pIn, out, [&](std::span<char> pBuf) { cipher.Apply(pBuf); });
+        if (expect.empty()) expect = out;
+        ok = ok && out == expect;
+        std::printf("%-18s %-10s %9.0f MB/s%s\n", key.c_str(), tier, mbs, out == expect ? "" : "  WRONG");
+    }
+    double mbs = BenchTime(pIn, out, [](std::span<char> pBuf) { vigenere::FixedCipher<Key>::Apply(pBuf); });
+    ok = ok && out == expect;
+    std::printf("%-18s %-10s %9.0f MB/s%s\n", key.c_str(), "fixed", mbs, out == expect ? "" : "  WRONG");
+    return ok;
+}
+
+int main
+    (
+    int   pArgc,
+    char *pArgv[]
+    )
+{
+    std::size_t len = (pArgc > 1 ? std::atoi(pArgv[1]) : 64) * (std::size_t)1000000;
+    std::mt19937 rng(220);
+    std::string in(len, ' ');
+    bool ok = true;
+
+    for (char &c : in) {
+        unsigned r = rng() % 31;
+        if (r < 26) c = static_cast<char>('A' + r);
+    }
+    ok = BenchKey<"LEMON">(in) && ok;
+    ok = BenchKey<"KEVINBURGER">(in) && ok;
+    ok = BenchKey<"THEQUICKBROWNFOXJUMPSOVERTHELAZYDOG">(in) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,565 @@
+/***************************************************************************************************************
+ * FILE: Container.c
+ *
+ * DESCRIPTION
+ * See comments in Container.h.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+
+/*
+ * pread(), fstat(), and pthread_once() are POSIX, not ANSI C, so with -ansi they are not declared unless we
+ * ask for them. This must come before any #include.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>      /* For errno, EINTR */
+#include <pthread.h>    /* For pthread_once() */
+#include <stdlib.h>     /* For free(), malloc(), realloc() */
+#include <string.h>     /* For memcmp(), memcpy() */
+#include <sys/stat.h>   /* For fstat() */
+#include <unistd.h>     /* For pread(), write() */
+#include "Container.h"  /* Good to always include the module header file. See comments in Globals.c. */
+#include "Kernel.h"     /* For KernelGetTier(), KERNEL_SSE2 */
+
+/*
+ * As in Kernel.c, the crc32 instruction is only used on x86, in a function compiled for SSE4.2 with the target
+ * attribute.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#define CONTAINER_X86
+#include <cpuid.h>      /* For __get_cpuid(), bit_SSE4_2 */
+#include <immintrin.h>  /* For _mm_crc32_u8(), _mm_crc32_u64() */
+#endif
+
+/*==============================================================================================================
+ * Preprocessor macros.
+ *
+ * CONTAINER_POLY is the CRC32C (Castagnoli) polynomial, bit-reversed, as the CRC is computed low bit first.
+ *============================================================================================================*/
+#define CONTAINER_FILE_LEN  (16)
+#define CONTAINER_FOOT_LEN  (32)
+#define CONTAINER_POLY      (0x82F63B78)
+
+/*==============================================================================================================
+ * Static function declarations.
+ *============================================================================================================*/
+#ifdef CONTAINER_X86
+static uint32_t ContainerCrcHw(uint32_t pCrc, const unsigned char *pBuf, size_t pLen);
+#endif
+static void ContainerCrcInit();
+static uint32_t ContainerGet32(const unsigned char *pBuf);
+static uint64_t ContainerGet64(const unsigned char *pBuf);
+static void ContainerHead(unsigned char *pHead, const ContainerChunk *pChunk, size_t pIndex);
+static bool ContainerIndex(ContainerReader *pReader, const unsigned char *pIndex, size_t pNum,
+                           const unsigned char *pFoot);
+static void ContainerPut32(unsigned char *pBuf, uint32_t pValue);
+static void ContainerPut64(unsigned char *pBuf, uint64_t pValue);
+static bool ContainerReadAt(int pFd, void *pBuf, size_t pLen, uint64_t pOffset);
+static bool ContainerUnhead(const unsigned char *pHead, size_t pIndex, ContainerChunk *pChunk);
+static bool ContainerWriteAll(int pFd, const void *pBuf, size_t pLen);
+
+/*==============================================================================================================
+ * Static global variables.
+ *
+ * gContainerCrcTable[k][b] is the CRC of byte b followed by k zero bytes, which lets slice-by-8 look up the 8
+ * bytes of a word independently and xor the results. The table is built once, by the first call of
+ * ContainerCrc() in any thread. gContainerCrcHw is true if the CPU has the crc32 instruction.
+ *============================================================================================================*/
+static bool           gContainerCrcHw = false;
+static pthread_once_t gContainerCrcOnce = PTHREAD_ONCE_INIT;
+static uint32_t       gContainerCrcTable[8][256];
+static const char    *gContainerFileMagic = "VGNRCHK1";
+static const char    *gContainerFootMagic = "VGNR";
+
+/*==============================================================================================================
+ * Function definitions.
+ *============================================================================================================*/
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerClose
+ * DESCR:    Frees the index of a container opened by ContainerOpen(). The file is not closed.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ContainerClose
+    (
+    ContainerReader *pReader
+    )
+{
+    free(pReader->mChunks);
+    pReader->mChunks = NULL;
+    pReader->mNumChunks = 0;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerCrc
+ * DESCR:    Continues the CRC32C pCrc over the pLen bytes at pBuf. Pass 0 for pCrc to start a new CRC.
+ *           Slice-by-8 does one table lookup per byte but the 8 lookups of a word do not depend on each other,
+ *           so they overlap; the crc32 instruction does a whole word at once.
+ * RETURNS:  The CRC32C of the bytes that came before, followed by pBuf.
+ *------------------------------------------------------------------------------------------------------------*/
+uint32_t ContainerCrc
+    (
+    uint32_t    pCrc,
+    const void *pBuf,
+    size_t      pLen
+    )
+{
+    const unsigned char *p = pBuf;
+    uint32_t crc = ~pCrc, lo;
+
+    pthread_once(&gContainerCrcOnce, ContainerCrcInit);
+#ifdef CONTAINER_X86
+    if (gContainerCrcHw && KernelGetTier() >= KERNEL_SSE2) return ~ContainerCrcHw(crc, p, pLen);
+#endif
+    for (; pLen >= 8; p += 8, pLen -= 8) {
+        lo = crc ^ (p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+        crc = gContainerCrcTable[7][lo & 0xFF] ^ gContainerCrcTable[6][(lo >> 8) & 0xFF] ^
+              gContainerCrcTable[5][(lo >> 16) & 0xFF] ^ gContainerCrcTable[4][lo >> 24] ^
+              gContainerCrcTable[3][p[4]] ^ gContainerCrcTable[2][p[5]] ^
+              gContainerCrcTable[1][p[6]] ^ gContainerCrcTable[0][p[7]];
+    }
+    for (; pLen > 0; ++p, --pLen) crc = gContainerCrcTable[0][(crc ^ *p) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+#ifdef CONTAINER_X86
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerCrcHw
+ * DESCR:    Continues the CRC pCrc, which is not inverted, over pLen bytes with the crc32 instruction, 8 bytes
+ *           at a time on x86-64 and one byte at a time on 32-bit x86.
+ * RETURNS:  The CRC, not inverted.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("sse4.2")))
+static uint32_t ContainerCrcHw
+    (
+    uint32_t             pCrc,
+    const unsigned char *pBuf,
+    size_t               pLen
+    )
+{
+#ifdef __x86_64__
+    unsigned long long crc = pCrc, word;
+
+    for (; pLen >= 8; pBuf += 8, pLen -= 8) {
+        memcpy(&word, pBuf, 8);
+        crc = _mm_crc32_u64(crc, word);
+    }
+    pCrc = (uint32_t)crc;
+#endif
+    for (; pLen > 0; ++pBuf, --pLen) pCrc = _mm_crc32_u8(pCrc, *pBuf);
+    return pCrc;
+}
+#endif
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerCrcInit
+ * DESCR:    Builds the slice-by-8 tables, and finds out if the CPU has the crc32 instruction. Called once, with
+ *           pthread_once().
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void ContainerCrcInit
+    (
+    )
+{
+#ifdef CONTAINER_X86
+    unsigned eax, ebx, ecx, edx;
+#endif
+    uint32_t crc;
+    int b, k;
+
+    for (b = 0; b < 256; ++b) {
+        crc = b;
+        for (k = 0; k < 8; ++k) crc = crc & 1 ? (crc >> 1) ^ CONTAINER_POLY : crc >> 1;
+        gContainerCrcTable[0][b] = crc;
+    }
+    for (b = 0; b < 256; ++b) {
+        for (k = 1; k < 8; ++k) {
+            crc = gContainerCrcTable[k-1][b];
+            gContainerCrcTable[k][b] = (crc >> 8) ^ gContainerCrcTable[0][crc & 0xFF];
+        }
+    }
+#ifdef CONTAINER_X86
+    gContainerCrcHw = __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_SSE4_2);
+#endif
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerGet32
+ * DESCR:    Decodes a little-endian 32-bit number.
+ * RETURNS:  The number.
+ *------------------------------------------------------------------------------------------------------------*/
+static uint32_t ContainerGet32
+    (
+    const unsigned char *pBuf
+    )
+{
+    return pBuf[0] | (uint32_t)pBuf[1] << 8 | (uint32_t)pBuf[2] << 16 | (uint32_t)pBuf[3] << 24;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerGet64
+ * DESCR:    Decodes a little-endian 64-bit number.
+ * RETURNS:  The number.
+ *------------------------------------------------------------------------------------------------------------*/
+static uint64_t ContainerGet64
+    (
+    const unsigned char *pBuf
+    )
+{
+    return ContainerGet32(pBuf) | (uint64_t)ContainerGet32(pBuf + 4) << 32;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerHead
+ * DESCR:    Encodes the header of chunk number pIndex into the CONTAINER_HEAD_LEN bytes at pHead.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void ContainerHead
+    (
+    unsigned char        *pHead,
+    const ContainerChunk *pChunk,
+    size_t                pIndex
+    )
+{
+    ContainerPut64(pHead, pChunk->mOffset);
+    ContainerPut64(pHead + 8, pChunk->mPhase);
+    ContainerPut32(pHead + 16, pChunk->mLen);
+    ContainerPut32(pHead + 20, pChunk->mCrc);
+    ContainerPut32(pHead + 24, (uint32_t)pIndex);
+    ContainerPut32(pHead + 28, ContainerCrc(0, pHead, 28));
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerIndex
+ * DESCR:    Decodes the pNum entries of the index at pIndex into pReader->mChunks, and checks them against the
+ *           footer at pFoot: every chunk but the last is full, the chunks are in order and cover the message,
+ *           and the index ends where the footer starts.
+ * RETURNS:  true if the index is good.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool ContainerIndex
+    (
+    ContainerReader     *pReader,
+    const unsigned char *pIndex,
+    size_t               pNum,
+    const unsigned char *pFoot
+    )
+{
+    ContainerChunk *chunk = pReader->mChunks;
+    uint64_t len = 0;
+    size_t i;
+
+    for (i = 0; i < pNum; ++i, ++chunk) {
+        if (!ContainerUnhead(pIndex + i * CONTAINER_HEAD_LEN, i, chunk) || chunk->mOffset != len ||
+            chunk->mLen == 0 || chunk->mLen > pReader->mChunkLen ||
+            (i + 1 < pNum && chunk->mLen != pReader->mChunkLen)) {
+            return false;
+        }
+        len += chunk->mLen;
+    }
+    pReader->mMsgLen = len;
+    return len == ContainerGet64(pFoot + 16) &&
+           ContainerGet64(pFoot) == CONTAINER_FILE_LEN + pNum * CONTAINER_HEAD_LEN + len;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerOpen
+ * DESCR:    Opens the container in the file open on pFd: reads and checks the file header, the footer, and the
+ *           index. The chunks themselves are not read (see ContainerRead()). pFd must be a file, not a pipe,
+ *           and stays open; call ContainerClose() and then close pFd when done.
+ * RETURNS:  true if the file is a container whose header, footer, and index are intact. false if it is not, or
+ *           could not be read, in which case there is nothing to close.
+ *------------------------------------------------------------------------------------------------------------*/
+bool ContainerOpen
+    (
+    ContainerReader *pReader,
+    int              pFd
+    )
+{
+    unsigned char head[CONTAINER_FILE_LEN], foot[CONTAINER_FOOT_LEN], *index;
+    uint64_t size, num;
+    struct stat st;
+    bool ok;
+
+    pReader->mFd = pFd;
+    pReader->mNumChunks = 0;
+    pReader->mChunks = NULL;
+    if (fstat(pFd, &st) < 0 || st.st_size < CONTAINER_FILE_LEN + CONTAINER_FOOT_LEN) return false;
+    size = st.st_size;
+    if (!ContainerReadAt(pFd, head, sizeof(head), 0) || memcmp(head, gContainerFileMagic, 8) ||
+        ContainerGet32(head + 12) != ContainerCrc(0, head, 12)) {
+        return false;
+    }
+    pReader->mChunkLen = ContainerGet32(head + 8);
+    if (pReader->mChunkLen == 0 || pReader->mChunkLen > CONTAINER_CHUNK_MAX) return false;
+    if (!ContainerReadAt(pFd, foot, sizeof(foot), size - CONTAINER_FOOT_LEN) ||
+        memcmp(foot + 28, gContainerFootMagic, 4)) {
+        return false;
+    }
+
+    /* The index is the last thing before the footer, and every chunk has an entry in it. */
+    num = ContainerGet64(foot + 8);
+    if (num > (size - CONTAINER_FILE_LEN - CONTAINER_FOOT_LEN) / CONTAINER_HEAD_LEN ||
+        ContainerGet64(foot) != size - CONTAINER_FOOT_LEN - num * CONTAINER_HEAD_LEN) {
+        return false;
+    }
+    index = malloc(num * CONTAINER_HEAD_LEN + 1);
+    pReader->mChunks = malloc(num * sizeof(ContainerChunk) + 1);
+    ok = index && pReader->mChunks &&
+         ContainerReadAt(pFd, index, num * CONTAINER_HEAD_LEN, ContainerGet64(foot)) &&
+         ContainerGet32(foot + 24) ==
+             ContainerCrc(ContainerCrc(0, index, num * CONTAINER_HEAD_LEN), foot, 24) &&
+         ContainerIndex(pReader, index, num, foot);
+    free(index);
+    if (!ok) ContainerClose(pReader);
+    else pReader->mNumChunks = num;
+    return ok;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerPut32
+ * DESCR:    Encodes a 32-bit number, little-endian.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void ContainerPut32
+    (
+    unsigned char *pBuf,
+    uint32_t       pValue
+    )
+{
+    pBuf[0] = pValue & 0xFF;
+    pBuf[1] = (pValue >> 8) & 0xFF;
+    pBuf[2] = (pValue >> 16) & 0xFF;
+    pBuf[3] = (pValue >> 24) & 0xFF;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerPut64
+ * DESCR:    Encodes a 64-bit number, little-endian.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void ContainerPut64
+    (
+    unsigned char *pBuf,
+    uint64_t       pValue
+    )
+{
+    ContainerPut32(pBuf, (uint32_t)pValue);
+    ContainerPut32(pBuf + 4, (uint32_t)(pValue >> 32));
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerRead
+ * DESCR:    Reads chunk number pChunk of an open container into pBuf, which must have room for mChunkLen bytes,
+ *           and checks it: its header must match its index entry and its bytes must match the CRC. The chunk
+ *           is read with pread(), so any number of threads may read chunks of one container at once. The bytes
+ *           are still ciphertext; decrypt them starting at key index mChunks[pChunk].mPhase.
+ * RETURNS:  The number of bytes in the chunk, or -1 if it could not be read or is damaged.
+ *------------------------------------------------------------------------------------------------------------*/
+long ContainerRead
+    (
+    const ContainerReader *pReader,
+    size_t                 pChunk,
+    char                  *pBuf
+    )
+{
+    unsigned char head[CONTAINER_HEAD_LEN], entry[CONTAINER_HEAD_LEN];
+    const ContainerChunk *chunk;
+    uint64_t pos = CONTAINER_FILE_LEN + (uint64_t)pChunk * (CONTAINER_HEAD_LEN + pReader->mChunkLen);
+
+    if (pChunk >= pReader->mNumChunks) return -1;
+    chunk = &pReader->mChunks[pChunk];
+    ContainerHead(entry, chunk, pChunk);
+    if (!ContainerReadAt(pReader->mFd, head, sizeof(head), pos) || memcmp(head, entry, sizeof(head)) ||
+        !ContainerReadAt(pReader->mFd, pBuf, chunk->mLen, pos + CONTAINER_HEAD_LEN) ||
+        ContainerCrc(0, pBuf, chunk->mLen) != chunk->mCrc) {
+        return -1;
+    }
+    return (long)chunk->mLen;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerReadAt
+ * DESCR:    Reads exactly pLen bytes at byte offset pOffset of pFd with pread(), retrying if interrupted by a
+ *           signal.
+ * RETURNS:  true if all pLen bytes were read, false on a read error or if the file ends first.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool ContainerReadAt
+    (
+    int       pFd,
+    void     *pBuf,
+    size_t    pLen,
+    uint64_t  pOffset
+    )
+{
+    char *buf = pBuf;
+    ssize_t n;
+
+    while (pLen > 0) {
+        n = pread(pFd, buf, pLen, (off_t)pOffset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buf += n;
+        pLen -= n;
+        pOffset += n;
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerUnhead
+ * DESCR:    Decodes the chunk header at pHead into *pChunk, and checks that it is intact and that it is the
+ *           header of chunk number pIndex.
+ * RETURNS:  true if the header is good.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool ContainerUnhead
+    (
+    const unsigned char *pHead,
+    size_t               pIndex,
+    ContainerChunk      *pChunk
+    )
+{
+    pChunk->mOffset = ContainerGet64(pHead);
+    pChunk->mPhase = ContainerGet64(pHead + 8);
+    pChunk->mLen = ContainerGet32(pHead + 16);
+    pChunk->mCrc = ContainerGet32(pHead + 20);
+    return ContainerGet32(pHead + 24) == (uint32_t)pIndex &&
+           ContainerGet32(pHead + 28) == ContainerCrc(0, pHead, 28);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerWrite
+ * DESCR:    Writes the pLen bytes at pBuf, which are already encrypted, as the next chunk of the container, and
+ *           adds its header to the index. pPhase is the key index of the first byte. Every chunk but the last
+ *           must be exactly mChunkLen bytes long.
+ * RETURNS:  true if the chunk was written. false if the write failed, the memory for the index could not be
+ *           allocated, or the chunk is empty, too long, or follows a short chunk.
+ *------------------------------------------------------------------------------------------------------------*/
+bool ContainerWrite
+    (
+    ContainerWriter *pWriter,
+    const char      *pBuf,
+    size_t           pLen,
+    size_t           pPhase
+    )
+{
+    unsigned char *grown, *head;
+    ContainerChunk chunk;
+
+    if (pLen == 0 || pLen > pWriter->mChunkLen) return false;
+    if (pWriter->mMsgLen != pWriter->mNumChunks * (uint64_t)pWriter->mChunkLen) return false;
+    if (pWriter->mNumChunks == pWriter->mSize) {
+        grown = realloc(pWriter->mIndex, (pWriter->mSize * 2 + 16) * CONTAINER_HEAD_LEN);
+        if (!grown) return false;
+        pWriter->mIndex = grown;
+        pWriter->mSize = pWriter->mSize * 2 + 16;
+    }
+    chunk.mOffset = pWriter->mMsgLen;
+    chunk.mPhase = pPhase;
+    chunk.mLen = (uint32_t)pLen;
+    chunk.mCrc = ContainerCrc(0, pBuf, pLen);
+    head = pWriter->mIndex + pWriter->mNumChunks * CONTAINER_HEAD_LEN;
+    ContainerHead(head, &chunk, pWriter->mNumChunks);
+    if (!ContainerWriteAll(pWriter->mFd, head, CONTAINER_HEAD_LEN) ||
+        !ContainerWriteAll(pWriter->mFd, pBuf, pLen)) {
+        return false;
+    }
+    pWriter->mNumChunks++;
+    pWriter->mMsgLen += pLen;
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerWriteAll
+ * DESCR:    Writes all pLen bytes at pBuf to pFd, retrying short writes and writes interrupted by a signal.
+ * RETURNS:  true if every byte was written.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool ContainerWriteAll
+    (
+    int         pFd,
+    const void *pBuf,
+    size_t      pLen
+    )
+{
+    const char *buf = pBuf;
+    ssize_t n;
+
+    while (pLen > 0) {
+        n = write(pFd, buf, pLen);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        buf += n;
+        pLen -= n;
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerWriteBegin
+ * DESCR:    Starts a container with chunks of pChunkLen bytes on pFd, which may be a pipe, since a container is
+ *           written front to back, and writes the file header. Write the chunks with ContainerWrite() and
+ *           finish the container with ContainerWriteEnd().
+ * RETURNS:  true if the header was written. false if the write failed or pChunkLen is 0 or more than
+ *           CONTAINER_CHUNK_MAX, in which case there is nothing to end.
+ *------------------------------------------------------------------------------------------------------------*/
+bool ContainerWriteBegin
+    (
+    ContainerWriter *pWriter,
+    int              pFd,
+    size_t           pChunkLen
+    )
+{
+    unsigned char head[CONTAINER_FILE_LEN];
+
+    pWriter->mFd = pFd;
+    pWriter->mChunkLen = pChunkLen;
+    pWriter->mNumChunks = 0;
+    pWriter->mSize = 0;
+    pWriter->mMsgLen = 0;
+    pWriter->mIndex = NULL;
+    if (pChunkLen == 0 || pChunkLen > CONTAINER_CHUNK_MAX) return false;
+    memcpy(head, gContainerFileMagic, 8);
+    ContainerPut32(head + 8, (uint32_t)pChunkLen);
+    ContainerPut32(head + 12, ContainerCrc(0, head, 12));
+    return ContainerWriteAll(pFd, head, sizeof(head));
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ContainerWriteEnd
+ * DESCR:    Finishes a container: writes the index and the footer, and frees the index.
+ * RETURNS:  true if they were written.
+ *------------------------------------------------------------------------------------------------------------*/
+bool ContainerWriteEnd
+    (
+    ContainerWriter *pWriter
+    )
+{
+    unsigned char foot[CONTAINER_FOOT_LEN];
+    size_t len = pWriter->mNumChunks * CONTAINER_HEAD_LEN;
+    bool ok;
+
+    ContainerPut64(foot, CONTAINER_FILE_LEN + len + pWriter->mMsgLen);
+    ContainerPut64(foot + 8, pWriter->mNumChunks);
+    ContainerPut64(foot + 16, pWriter->mMsgLen);
+    ContainerPut32(foot + 24, ContainerCrc(ContainerCrc(0, pWriter->mIndex, len), foot, 24));
+    memcpy(foot + 28, gContainerFootMagic, 4);
+    ok = ContainerWriteAll(pWriter->mFd, pWriter->mIndex, len) &&
+         ContainerWriteAll(pWriter->mFd, foot, sizeof(foot));
+    free(pWriter->mIndex);
+    pWriter->mIndex = NULL;
+    return ok;
+}
@@ -0,0 +1,146 @@
+/***************************************************************************************************************
+ * FILE: Container.h
+ *
+ * DESCRIPTION
+ * The chunked container format for the ciphertext (the --container option). Raw ciphertext has no framing, so
+ * it cannot be checked, split, or decrypted in pieces without knowing where each piece starts in the key. A
+ * container cuts the ciphertext into chunks of a fixed length (the last one may be shorter), each with a
+ * header that records its byte offset in the message, the key index of its first byte, and the CRC32C of its
+ * bytes, and ends with an index of every chunk header. A reader finds the index from the footer, and can then
+ * read, check, and decrypt any chunk on its own, so the chunks of one file can be checked and decrypted by
+ * many threads at once. The key index is stored rather than computed from the offset, which makes a chunk
+ * independent in text mode too, where the key advances only on letters.
+ *
+ * All numbers are little-endian, whatever the byte order of the CPU:
+ *
+ *     file header   16 bytes   "VGNRCHK1", chunk length (4), CRC32C of the first 12 bytes (4)
+ *     chunk i       32 bytes   offset (8), key index (8), length (4), CRC32C of the bytes (4), i (4),
+ *                              CRC32C of the first 28 bytes of the header (4)
+ *                   length     the ciphertext of the chunk
+ *     index         32 bytes   a copy of the header of each chunk, in order
+ *     footer        32 bytes   file offset of the index (8), number of chunks (8), message length (8),
+ *                              CRC32C of the index and the first 24 bytes of the footer (4), "VGNR"
+ *
+ * Chunk i starts at file offset 16 + i * (32 + chunk length), and its header must match its index entry. The
+ * CRCs cover the ciphertext, so a container can be checked without the key.
+ *
+ * This module only reads and writes the format; it does not encrypt or decrypt, and it reports errors by its
+ * return values rather than terminating, so that it can be used by the library (see VigenereLib.h) as well as
+ * by the vigenere program (see Stream.c). CRC32C is computed with the crc32 instruction of SSE4.2 when the CPU
+ * has it and the kernel tier is sse2 or above (see Kernel.h), and with slice-by-8 table lookups otherwise.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#ifndef _CONTAINER_H_ /* Preprocessor guard to prevent Container.h from being included more than once */
+#define _CONTAINER_H_ /* See comments in Main.h. */
+
+#include <stddef.h>  /* For size_t */
+#include <stdint.h>  /* For uint32_t, uint64_t */
+#include "Types.h"   /* For bool */
+
+/*==============================================================================================================
+ * Global preprocessor macros.
+ *
+ * CONTAINER_CHUNK_LEN is the chunk length the vigenere program writes. CONTAINER_CHUNK_MAX is the longest
+ * chunk a container may have, so a reader never allocates more than that for one chunk.
+ *============================================================================================================*/
+#define CONTAINER_CHUNK_LEN (1 << 20)
+#define CONTAINER_CHUNK_MAX (1 << 30)
+#define CONTAINER_HEAD_LEN  (32)
+
+/*==============================================================================================================
+ * Global type definitions.
+ *
+ * A ContainerChunk is a decoded chunk header. A ContainerReader is an open container: the chunk length and the
+ * index, read and checked by ContainerOpen(). A ContainerWriter is a container being written; its index grows
+ * by one entry for each chunk and is written out by ContainerWriteEnd().
+ *============================================================================================================*/
+typedef struct {
+    uint64_t mOffset;  /* The byte offset of the chunk in the message */
+    uint64_t mPhase;   /* The key index of the first byte of the chunk */
+    uint32_t mLen;     /* The number of bytes in the chunk */
+    uint32_t mCrc;     /* The CRC32C of the bytes of the chunk */
+} ContainerChunk;
+
+typedef struct {
+    int             mFd;         /* The container file, read with pread() */
+    size_t          mChunkLen;   /* The length of every chunk but the last */
+    size_t          mNumChunks;  /* The number of chunks */
+    uint64_t        mMsgLen;     /* The length of the message */
+    ContainerChunk *mChunks;     /* The index, mNumChunks entries */
+} ContainerReader;
+
+typedef struct {
+    int            mFd;         /* Where the container is written */
+    size_t         mChunkLen;   /* The length of every chunk but the last */
+    size_t         mNumChunks;  /* The number of chunks written so far */
+    size_t         mSize;       /* The number of index entries mIndex has room for */
+    uint64_t       mMsgLen;     /* The number of message bytes written so far */
+    unsigned char *mIndex;      /* The headers of the chunks written so far, CONTAINER_HEAD_LEN bytes each */
+} ContainerWriter;
+
+/*==============================================================================================================
+ * Global function declarations.
+ *
+ * See comments in Main.h concerning what global function declarations are for.
+ *============================================================================================================*/
+extern void ContainerClose
+    (
+    ContainerReader *pReader
+    );
+
+extern uint32_t ContainerCrc
+    (
+    uint32_t    pCrc,
+    const void *pBuf,
+    size_t      pLen
+    );
+
+extern bool ContainerOpen
+    (
+    ContainerReader *pReader,
+    int              pFd
+    );
+
+extern long ContainerRead
+    (
+    const ContainerReader *pReader,
+    size_t                 pChunk,
+    char                  *pBuf
+    );
+
+extern bool ContainerWrite
+    (
+    ContainerWriter *pWriter,
+    const char      *pBuf,
+    size_t           pLen,
+    size_t           pPhase
+    );
+
+extern bool ContainerWriteBegin
+    (
+    ContainerWriter *pWriter,
+    int              pFd,
+    size_t           pChunkLen
+    );
+
+extern bool ContainerWriteEnd
+    (
+    ContainerWriter *pWriter
+    );
+
+#endif /* __CONTAINER_H__ */
@@ -20,16 +20,25 @@
  * -------------------------------------------------------------------------------------------------------------
  * 24 Jan 2012 [KRB] Initial revision.
  **************************************************************************************************************/
+#include "Analyze.h"     /* For AnalyzeBest(), AnalyzeClimb(), AnalyzeColumns(), AnalyzeIoc(), ... */
+#include "Armor.h"       /* For ArmorNamed(), ARMOR_NONE */
+#include "Batch.h"       /* For BatchRun() */
 #include "Controller.h"  /* Good to always include the module header file. See comments in Globals.c. */
-#include "File.h"        /* For FileReadStr() */
-#include "Globals.h"     /* For MAX_MSG_LEN, TERM_ERR_CMD_LINE */
+#include "File.h"        /* For FileReadBytes(), FileReadLine(), FileReadStr(), FileMap(), FileUnmap(), ... */
+#include "Globals.h"     /* For MAX_MSG_LEN, TERM_ERR_ALPHA, TERM_ERR_CMD_LINE */
+#include "Kernel.h"      /* For KernelBegin(), KernelSelect() */
 #include "Main.h"        /* For MainTerminate() */
-#include "Model.h"       /* For ModelBegin(), ModelEnd(), ModelSetMode(), ModelSetKeyFilename(), ModelSetKey() */
+#include "Model.h"       /* For ModelBegin(), ModelEnd(), ModelSetAlpha(), ModelGetCtx(), ... */
+#include "Ngram.h"       /* For NgramBegin(), NgramEnd(), NgramLetters(), NgramWrite(), NgramTable, ... */
+#include "Pool.h"        /* For PoolBegin(), PoolEnd(), PoolApply() */
+#include "Stream.h"      /* For StreamRun(), StreamRunContainer(), StreamRunMem(), StreamRunRange() */
 #include "String.h"      /* For streq */
 #include "Types.h"       /* For bool */
-#include "View.h"        /* For ViewBegin(), ViewEnd(), ViewGetChar(), ViewHelp(), ViewVersion(), ViewPrintStr() */
-#include "Vigenere.h"    /* For Vigenere() */
+#include "View.h"        /* For ViewBegin(), ViewEnd(), ViewGetLine(), ViewGetStr(), ViewHelp(), ... */
+#include "Vigenere.h"    /* For VigenereAlphaBegin(), VigenereAlphaBinary(), VigenereAlphaText(), ... */
+#include <ctype.h>       /* For isdigit() */
 #include <stdio.h>
+#include <stdlib.h>      /* For free(), getenv(), strtol(), strtoul() */
 
 /*==============================================================================================================
  * Static function declarations.
@@ -117,13 +126,106 @@
  * any static function from any static/nonstatic function without the compiler bitching at me about the
  * function being undefined.
  *============================================================================================================*/
-static void ControllerEncryptDecrypt(bool  pMode, char *pMsgOut);
+static void ControllerAlpha(char *pName);
+static void ControllerAnalyze();
+static void ControllerEncryptDecrypt(VigenereCtx *pCtx, char *pMsgOut);
+static void ControllerKey(char *pFilename, bool pChain);
+static void ControllerNgrams();
 static void ControllerParseCmdLine(int pArgc, char *pArgv[]);
+static size_t ControllerSize(char *pOption, char *pArg);
+static void ControllerStream(VigenereCtx *pCtx);
 
 /*==============================================================================================================
  * Function definitions. These are in alphabetical order.
  *============================================================================================================*/
 
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ControllerAlpha
+ * DESCR:    Sets the alphabet for the -a option. pName is the name of an alphabet (see VigenereAlphaNamed()) or
+ *           else the name of a file whose first line is the alphabet, spaces included, e.g., "ABCabc 123".
+ *           Fails and terminates with an error message if the alphabet is not valid.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void ControllerAlpha(char *pName)
+{
+    char chars[MAX_MSG_LEN+1];
+    const char *named = VigenereAlphaNamed(pName);
+    VigenereAlpha alpha;
+
+    if (named) strcpy(chars, named);
+    else FileReadLine(pName, chars, sizeof(chars));
+    if (!VigenereAlphaBegin(&alpha, chars, strlen(chars))) {
+        MainTerminate(TERM_ERR_ALPHA, "alphabet '%s' is empty, too long, or has a repeated or non-ASCII "
+                      "char.\n", pName);
+    }
+    ModelSetAlpha(&alpha);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ControllerAnalyze
+ * DESCR:    Analyzes the ciphertext (the -i file, or stdin) for the length of its key, by the IoC on the worker
+ *           threads (see AnalyzeIoc()), or with --kasiski by Kasiski examination (see AnalyzeKasiski()), and
+ *           then recovers the key for that length (see AnalyzeSolve()) in a second pass over the -i file, or
+ *           for the --period length in one pass without the first. With --ngrams the key is recovered by
+ *           quadgram hill climbing (see AnalyzeClimb()) with the quadgrams of the --ngrams file instead. Prints
+ *           the key length, the candidate key lengths, best first, and the key, and writes the key to the -o
+ *           file as a key file. The key is not recovered when the length is found from stdin, which cannot be
+ *           read twice. Fails and terminates with an error message if the ciphertext has too few letters, or
+ *           for Kasiski examination, no repeated trigram.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void ControllerAnalyze()
+{
+    char *in = ModelGetInFilename(), *out = ModelGetOutFilename(), key[MAX_MSG_LEN+2];
+    size_t maxPeriod = ModelGetMaxPeriod(), period = ModelGetPeriod(), letters = 0;
+    AnalyzePeriod *rank = NULL;
+    NgramTable table;
+    uint64_t *counts;
+    int fd;
+
+    if (ModelGetThreads() != 1) PoolBegin(ModelGetThreads());
+    if (!period) {
+        rank = malloc(maxPeriod * sizeof(*rank));
+        if (!rank) MainTerminate(TERM_ERR_BUG, "could not allocate memory for the analysis.\n");
+        fd = in[0] ? FileOpenRead(in) : 0;
+        if (ModelGetKasiski()) letters = AnalyzeKasiski(fd, ModelGetAlpha(), maxPeriod, rank);
+        else letters = AnalyzeIoc(fd, ModelGetAlpha(), maxPeriod, rank);
+        if (in[0]) FileClose(fd);
+        if (letters < 2) MainTerminate(TERM_ERR_ANALYZE, "the ciphertext has too few letters to analyze.\n");
+        if (rank[0].mScore <= 0.0 && ModelGetKasiski()) {
+            MainTerminate(TERM_ERR_ANALYZE, "the ciphertext has no repeated trigrams.\n");
+        } else if (rank[0].mScore <= 0.0) {
+            MainTerminate(TERM_ERR_ANALYZE, "the ciphertext is too short to find a key length.\n");
+        }
+        period = AnalyzeBest(rank, maxPeriod);
+    }
+    key[0] = '\0';
+    if ((ModelGetPeriod() || in[0]) && ModelGetNgramFilename()[0]) {
+        NgramBegin(&table, ModelGetNgramFilename());
+        fd = in[0] ? FileOpenRead(in) : 0;
+        letters = AnalyzeClimb(fd, ModelGetAlpha(), &table, period, key);
+        if (in[0]) FileClose(fd);
+        NgramEnd(&table);
+        if (!key[0]) MainTerminate(TERM_ERR_ANALYZE, "the ciphertext has too few letters to analyze.\n");
+    } else if (ModelGetPeriod() || in[0]) {
+        counts = malloc(period * (ModelGetAlpha()->mLen + 1) * sizeof(*counts));
+        if (!counts) MainTerminate(TERM_ERR_BUG, "could not allocate memory for the analysis.\n");
+        fd = in[0] ? FileOpenRead(in) : 0;
+        letters = AnalyzeColumns(fd, ModelGetAlpha(), period, counts);
+        if (in[0]) FileClose(fd);
+        /* With fewer letters than the period some columns are empty and their key chars would be made up. */
+        if (letters < period) {
+            MainTerminate(TERM_ERR_ANALYZE, "the ciphertext has too few letters for a key of that length.\n");
+        }
+        AnalyzeSolve(ModelGetAlpha(), counts, period, key);
+        free(counts);
+    }
+    PoolEnd();
+    ViewPrintPeriods(ModelGetKasiski() ? "Kasiski" : "IoC", letters, rank, rank ? maxPeriod : 0, period, key);
+    if (out[0]) FileWriteStr(out, strcat(key, "\n"));
+    free(rank);
+}
+
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ControllerBegin
  * DESCR:    Initializes the Controller module. Initializes the Model and View modules, and parses the command
@@ -138,6 +240,9 @@ void ControllerBegin(int pArgc,	char *pArgv[])
     /* Initialize the View. */
     ViewBegin();
 
+    /* Select the fastest Vigenere kernel this CPU supports. The command line may override it. */
+    KernelBegin();
+
     /* Parse the command line for the arguments and options. */
     ControllerParseCmdLine(pArgc, pArgv);
 }
@@ -145,33 +250,83 @@ void ControllerBegin(int pArgc,	char *pArgv[])
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ControllerEncryptDecrypt
  * DESCR:    Encrypts the plaintext to produce the ciphertext or decrypts the ciphertext to produce the plain-
- *           text. The message is read from stdin by calling ViewGetStr().
- * RETURNS:  If pMode is VIGENERE_ENCRYPT, pMsgOut is the ciphertext. If pMode is VIGENERE_DECRYPT, pMstOut is
- *           the plaintext.
+ *           text, with the key and mode of pCtx. The message is read from stdin by calling ViewGetStr(), or
+ *           ViewGetLine() in text mode.
+ * RETURNS:  If the mode of pCtx is VIGENERE_ENCRYPT, pMsgOut is the ciphertext. If it is VIGENERE_DECRYPT,
+ *           pMsgOut is the plaintext.
  *------------------------------------------------------------------------------------------------------------*/
-static void ControllerEncryptDecrypt(bool  pMode,  char *pMsgOut)
+static void ControllerEncryptDecrypt(VigenereCtx *pCtx, char *pMsgOut)
 {
     /* Define a character array named msgIn which has room for MAX_MSG_LEN+1 characters. */
     char msgin[MAX_MSG_LEN+1];
+    size_t len;
 
-    /* Call ViewGetStr() to get the message string to be encrypted or decrypted. */
-    ViewGetStr(msgin);
+    /*
+     * Call ViewGetStr() to get the message string to be encrypted or decrypted. In text mode the message is
+     * a whole line, with its spaces and punctuation, so call ViewGetLine() instead.
+     */
+    if (ModelGetAlpha()->mText) ViewGetLine(msgin, MAX_MSG_LEN);
+    else ViewGetStr(msgin, MAX_MSG_LEN);
 
-    /* Call Vigenere() to encrypt or decrypt the message. */
-    Vigenere(pMode, ModelGetKey(), msgin, pMsgOut);
+    /* Call VigenereCtxRun() to encrypt or decrypt the message. */
+    len = strlen(msgin);
+    VigenereCtxRun(pCtx, msgin, pMsgOut, len);
+    pMsgOut[len] = '\0';
 }
 
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ControllerEnd
- * DESCR:    Called when the Controller module is about to die. Ends the View and Model modules.
+ * DESCR:    Called when the Controller module is about to die. Stops the worker threads and ends the View and
+ *           Model modules.
  * RETURNS:  Nothing.
  *------------------------------------------------------------------------------------------------------------*/
 void ControllerEnd()
 {
+    PoolEnd();
     ViewEnd();
 	ModelEnd();
 }
 
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ControllerKey
+ * DESCR:    Reads the key in the file named pFilename, the whole file as raw bytes in binary mode and the first
+ *           string of it otherwise, and stores it in the Model as the key, or as the second key if pChain is
+ *           true. Fails and terminates with an error message if the file could not be read or the key is empty.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void ControllerKey(char *pFilename, bool pChain)
+{
+    char key[MAX_MSG_LEN+1], *bytes = key;
+    size_t len;
+
+    if (ModelGetAlpha()->mLen == VIGENERE_ALPHA_BYTES) {
+        bytes = FileReadBytes(pFilename, &len);
+    } else {
+        FileReadStr(pFilename, key, MAX_MSG_LEN);
+        len = strlen(key);
+    }
+    if (len && pChain) ModelSetChainKeyBytes(bytes, len);
+    else if (len) ModelSetKeyBytes(bytes, len);
+    if (bytes != key) free(bytes);
+    if (!len) MainTerminate(TERM_ERR_KEYFILE, "key file '%s' is empty.\n", pFilename);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ControllerNgrams
+ * DESCR:    Compiles the n-gram tables of the -i file, a corpus of English text (or a table file, which is
+ *           copied), into the -o table file (see NgramWrite()), which --ngrams then maps rather than counting
+ *           the corpus on every run.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void ControllerNgrams()
+{
+    NgramTable table;
+
+    NgramBegin(&table, ModelGetInFilename());
+    NgramWrite(&table, ModelGetOutFilename());
+    NgramEnd(&table);
+}
+
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ControllerParseCmdLine()
  * DESCR:    Examines the command line for arguments and options. Information parsed on the command line is
@@ -192,11 +347,64 @@ void ControllerEnd()
  *------------------------------------------------------------------------------------------------------------*/
 static void ControllerParseCmdLine(int pArgc,   char *pArgv[])
 {
-    bool bKeyfile = false, bMode = false;
-    int i;
+    bool bAlpha = false, bBinary = false, bChain = false, bKeyfile = false, bMode = false, bRange = false;
+    bool bRekey = false, bText = false;
+    char *kernel = getenv("VIGENERE_KERNEL");
+    unsigned char letters[NGRAM_LETTERS];
+    VigenereAlpha alpha;
+    int armor, i;
+
+    /* The VIGENERE_KERNEL environment variable forces a kernel tier. The --kernel option overrides it. */
+    if (kernel && !KernelSelect(kernel)) {
+        MainTerminate(TERM_ERR_CMDLINE, "VIGENERE_KERNEL: kernel '%s' is unknown or not supported.\n", kernel);
+    }
 
     for (i = 1; i < pArgc; i++) {
-        if (streq(pArgv[i], "e")) {
+        if (streq(pArgv[i], "-a")) {
+            /* Use a named alphabet or the one in a file rather than 'A'..'Z'. */
+            if (++i >= pArgc) {
+                MainTerminate(TERM_ERR_CMDLINE, "-a option, missing alphabet name or file name.\n");
+            }
+            ControllerAlpha(pArgv[i]);
+            bAlpha = true;
+
+        } else if (streq(pArgv[i], "analyze")) {
+            /* Find the length of the key of the ciphertext rather than encrypt or decrypt it. */
+            ModelSetAnalyze(true);
+            bMode = true;
+
+        } else if (streq(pArgv[i], "--armor")) {
+            /* Write the ciphertext as hex or base64 when encrypting, and read it that way when decrypting. */
+            if (++i >= pArgc) MainTerminate(TERM_ERR_CMDLINE, "--armor option, missing armor name.\n");
+            armor = ArmorNamed(pArgv[i]);
+            if (armor < 0) {
+                MainTerminate(TERM_ERR_CMDLINE, "--armor option, armor '%s' is unknown (use hex or base64).\n",
+                              pArgv[i]);
+            }
+            ModelSetArmor(armor);
+
+        } else if (streq(pArgv[i], "--binary")) {
+            /* Shift every byte of the message mod 256 by the key byte under it. The key file is raw bytes. */
+            VigenereAlphaBinary(&alpha);
+            ModelSetAlpha(&alpha);
+            bBinary = true;
+
+        } else if (streq(pArgv[i], "-b")) {
+            /* Run the jobs listed in a manifest. Each job names its own mode and key file. */
+            if (++i >= pArgc) MainTerminate(TERM_ERR_CMDLINE, "-b option, missing manifest file name.\n");
+            ModelSetBatchFilename(pArgv[i]);
+
+        } else if (streq(pArgv[i], "--chain")) {
+            /* Apply a second key after the -k key, in the same mode, in the same pass. */
+            if (++i >= pArgc) MainTerminate(TERM_ERR_KEYFILE, "--chain option, missing key file name.\n");
+            ModelSetChainFilename(pArgv[i]);
+            bChain = true;
+
+        } else if (streq(pArgv[i], "--container")) {
+            /* Write the ciphertext as a chunked container when encrypting, and read one when decrypting. */
+            ModelSetContainer(true);
+
+        } else if (streq(pArgv[i], "e")) {
             /* Call ModelSetMode() to set the mode to VIGENERE_ENCRYPT */
             ModelSetMode(VIGENERE_ENCRYPT);
 
@@ -217,11 +425,105 @@ static void ControllerParseCmdLine(int pArgc,   char *pArgv[])
             /* Call MainTerminate() with an error code of 0 and "" as the format string. */
             MainTerminate(0, "");
 
+        } else if (streq(pArgv[i], "-i")) {
+            if (++i >= pArgc) MainTerminate(TERM_ERR_CMDLINE, "-i option, missing input file name.\n");
+            ModelSetInFilename(pArgv[i]);
+
+        } else if (streq(pArgv[i], "-j")) {
+            char *end;
+            long threads;
+            if (++i >= pArgc) MainTerminate(TERM_ERR_CMDLINE, "-j option, missing number of threads.\n");
+            threads = strtol(pArgv[i], &end, 10);
+            if (*end || end == pArgv[i] || threads < 0 || threads > 1024) {
+                MainTerminate(TERM_ERR_CMDLINE, "-j option, invalid number of threads: %s\n", pArgv[i]);
+            }
+            ModelSetThreads((int)threads);
+
         } else if (streq(pArgv[i], "-k")) {
             if (++i >= pArgc) MainTerminate(TERM_ERR_KEYFILE, "-k option, missing key file name.\n");
             ModelSetKeyFilename(pArgv[i]);
 
             bKeyfile = true;
+        } else if (streq(pArgv[i], "--kasiski")) {
+            /* Find the key length in analyze mode from the distances between repeated trigrams. */
+            ModelSetKasiski(true);
+
+        } else if (streq(pArgv[i], "--kernel")) {
+            if (++i >= pArgc) MainTerminate(TERM_ERR_CMDLINE, "--kernel option, missing kernel name.\n");
+            if (!KernelSelect(pArgv[i])) {
+                MainTerminate(TERM_ERR_CMDLINE, "kernel '%s' is unknown or not supported.\n", pArgv[i]);
+            }
+
+        } else if (streq(pArgv[i], "--length")) {
+            /* Run only this many bytes of the -i file, starting at --offset. */
+            if (++i >= pArgc) MainTerminate(TERM_ERR_CMDLINE, "--length option, missing number of bytes.\n");
+            ModelSetLength(ControllerSize("--length", pArgv[i]));
+            bRange = true;
+
+        } else if (streq(pArgv[i], "--max-period")) {
+            /* Try key lengths from 1 to this many chars in analyze mode. */
+            if (++i >= pArgc) MainTerminate(TERM_ERR_CMDLINE, "--max-period option, missing key length.\n");
+            ModelSetMaxPeriod(ControllerSize("--max-period", pArgv[i]));
+            if (ModelGetMaxPeriod() < 1 || ModelGetMaxPeriod() > ANALYZE_PERIOD_MAX) {
+                MainTerminate(TERM_ERR_CMDLINE, "--max-period option, key length must be 1..%d: %s\n",
+                              ANALYZE_PERIOD_MAX, pArgv[i]);
+            }
+
+        } else if (streq(pArgv[i], "--ngrams")) {
+            /* Recover the key in analyze mode by quadgram hill climbing, with this corpus or table file. */
+            if (++i >= pArgc) {
+                MainTerminate(TERM_ERR_CMDLINE, "--ngrams option, missing corpus or table file name.\n");
+            }
+            ModelSetNgramFilename(pArgv[i]);
+
+        } else if (streq(pArgv[i], "ngrams")) {
+            /* Compile the n-gram tables of the -i corpus into the -o table file instead of encrypting. */
+            ModelSetNgrams(true);
+            bMode = true;
+
+        } else if (streq(pArgv[i], "--no-splice")) {
+            /* Copy into the output pipe with write() even if both stdin and stdout are pipes. */
+            ModelSetSplice(false);
+
+        } else if (streq(pArgv[i], "--no-uring")) {
+            /* Stream with the threaded pipeline even if the kernel supports io_uring. */
+            ModelSetUring(false);
+
+        } else if (streq(pArgv[i], "--offset")) {
+            /* Start at this byte of the -i file, at the key index it has in the whole file. */
+            if (++i >= pArgc) MainTerminate(TERM_ERR_CMDLINE, "--offset option, missing byte offset.\n");
+            ModelSetOffset(ControllerSize("--offset", pArgv[i]));
+            bRange = true;
+
+        } else if (streq(pArgv[i], "-o")) {
+            if (++i >= pArgc) MainTerminate(TERM_ERR_CMDLINE, "-o option, missing output file name.\n");
+            ModelSetOutFilename(pArgv[i]);
+
+        } else if (streq(pArgv[i], "--period")) {
+            /* Recover the key for this key length in analyze mode rather than find the length first. */
+            if (++i >= pArgc) MainTerminate(TERM_ERR_CMDLINE, "--period option, missing key length.\n");
+            ModelSetPeriod(ControllerSize("--period", pArgv[i]));
+            if (ModelGetPeriod() < 1 || ModelGetPeriod() > (size_t)MAX_MSG_LEN) {
+                MainTerminate(TERM_ERR_CMDLINE, "--period option, key length must be 1..%d: %s\n", MAX_MSG_LEN,
+                              pArgv[i]);
+            }
+
+        } else if (streq(pArgv[i], "--rekey")) {
+            /* Decrypt with the -k key and encrypt with this one, in one pass, with no plaintext in between. */
+            if (++i >= pArgc) MainTerminate(TERM_ERR_KEYFILE, "--rekey option, missing key file name.\n");
+            ModelSetChainFilename(pArgv[i]);
+            bRekey = true;
+
+        } else if (streq(pArgv[i], "-s")) {
+            /* Stream the message from stdin to stdout in blocks rather than reading a single string. */
+            ModelSetStream(true);
+
+        } else if (streq(pArgv[i], "-t")) {
+            /* Encrypt letters of both cases, keeping case, and advance the key only on letters. */
+            VigenereAlphaText(&alpha);
+            ModelSetAlpha(&alpha);
+            bText = true;
+
         } else if (streq(pArgv[i], "-v")) {
             /* Call a certain View module function to display the version information. */
             ViewVersion();
@@ -233,10 +535,66 @@ static void ControllerParseCmdLine(int pArgc,   char *pArgv[])
             MainTerminate(TERM_ERR_CMDLINE, "invalid command line option: %s\n", pArgv[i]);
         }
     }
+    if ((bAlpha ? 1 : 0) + (bBinary ? 1 : 0) + (bText ? 1 : 0) > 1) {
+        MainTerminate(TERM_ERR_CMDLINE, "only one of -a, --binary, and -t can be used.\n");
+    }
+    if (ModelGetBatchFilename()[0] && ModelGetArmor() != ARMOR_NONE) {
+        MainTerminate(TERM_ERR_CMDLINE, "--armor cannot be used with -b.\n");
+    }
+    if (ModelGetContainer() && (ModelGetBatchFilename()[0] || ModelGetArmor() != ARMOR_NONE || bRange)) {
+        MainTerminate(TERM_ERR_CMDLINE, "--container cannot be used with -b, --armor, --offset, or "
+                      "--length.\n");
+    }
+    if (bRange && (ModelGetBatchFilename()[0] || !ModelGetInFilename()[0])) {
+        MainTerminate(TERM_ERR_CMDLINE, "--offset and --length need -i and cannot be used with -b.\n");
+    }
+    if (bRange && (bText || ModelGetArmor() != ARMOR_NONE)) {
+        MainTerminate(TERM_ERR_CMDLINE, "--offset and --length cannot be used with -t or --armor.\n");
+    }
+    if (bChain && bRekey) MainTerminate(TERM_ERR_CMDLINE, "only one of --chain and --rekey can be used.\n");
+    if (ModelGetChainFilename()[0] && ModelGetBatchFilename()[0]) {
+        MainTerminate(TERM_ERR_CMDLINE, "--chain and --rekey cannot be used with -b.\n");
+    }
+    if (bRekey && (ModelGetArmor() != ARMOR_NONE || ModelGetContainer())) {
+        MainTerminate(TERM_ERR_CMDLINE, "--rekey cannot be used with --armor or --container.\n");
+    }
+    if (bRekey && ModelGetMode() != VIGENERE_DECRYPT) {
+        MainTerminate(TERM_ERR_CMDLINE, "--rekey needs mode 'd' (the -k key is the old key).\n");
+    }
+    ModelSetChainMode(bRekey ? VIGENERE_ENCRYPT : ModelGetMode());
+    if (ModelGetAnalyze() && (ModelGetBatchFilename()[0] || bBinary || ModelGetArmor() != ARMOR_NONE ||
+        ModelGetChainFilename()[0] || ModelGetContainer() || bRange)) {
+        MainTerminate(TERM_ERR_CMDLINE, "analyze cannot be used with -b, --armor, --binary, --chain, "
+                      "--container, --offset, --length, or --rekey.\n");
+    }
+    if (ModelGetPeriod() && (!ModelGetAnalyze() || ModelGetKasiski())) {
+        MainTerminate(TERM_ERR_CMDLINE, "--period needs analyze and cannot be used with --kasiski.\n");
+    }
+    if (ModelGetNgramFilename()[0] && (!ModelGetAnalyze() || !NgramLetters(ModelGetAlpha(), letters))) {
+        MainTerminate(TERM_ERR_CMDLINE, "--ngrams needs analyze and an alphabet of the %d letters.\n",
+                      NGRAM_LETTERS);
+    }
+    if (ModelGetAnalyze() && ModelGetOutFilename()[0] && !ModelGetPeriod() && !ModelGetInFilename()[0]) {
+        MainTerminate(TERM_ERR_CMDLINE, "analyze -o (the key file) needs -i or --period.\n");
+    }
+    if (ModelGetAnalyze() && ModelGetOutFilename()[0] &&
+        FileSame(ModelGetInFilename(), ModelGetOutFilename())) {
+        MainTerminate(TERM_ERR_CMDLINE, "analyze cannot be used with -i and -o the same.\n");
+    }
+    if (ModelGetNgrams() && (ModelGetAnalyze() || ModelGetBatchFilename()[0])) {
+        MainTerminate(TERM_ERR_CMDLINE, "ngrams cannot be used with analyze or -b.\n");
+    }
+    if (ModelGetNgrams() && (!ModelGetInFilename()[0] || !ModelGetOutFilename()[0])) {
+        MainTerminate(TERM_ERR_CMDLINE, "ngrams needs -i (the corpus) and -o (the table file).\n");
+    }
+    if (ModelGetNgrams() && FileSame(ModelGetInFilename(), ModelGetOutFilename())) {
+        MainTerminate(TERM_ERR_CMDLINE, "ngrams cannot be used with -i and -o the same.\n");
+    }
+    if (ModelGetBatchFilename()[0]) return;
     if (!bMode) {
         MainTerminate(TERM_ERR_CMDLINE, "missing mode (should be 'e' to encrypt or 'd' to decrypt\n");
     }
-    if (!bKeyfile) {
+    if (!bKeyfile && !ModelGetAnalyze() && !ModelGetNgrams()) {
         MainTerminate(TERM_ERR_CMDLINE, "missing -k 'keyfile' option. Use -h option for help.\n", pArgv[i]);
     }
 }
@@ -244,28 +602,173 @@ static void ControllerParseCmdLine(int pArgc,   char *pArgv[])
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ControllerRun
  * DESCR:    Called after the Controller is initialized in ControllerBegin and after the command line has been
- *           parsed. Reads the key from the specified key file name. Calls ControllerEncryptDecrypt to encrypt
- *           or decrypt a message. Finally calls ViewPrintStr to print the encrypted or decrypted message.
+ *           parsed. In batch mode, runs the jobs of the manifest (see BatchRun()), in analyze mode analyzes the
+ *           ciphertext (see ControllerAnalyze()), and in ngrams mode compiles the n-gram tables of a corpus
+ *           (see ControllerNgrams()). Otherwise reads the key from the specified key file name, and the second
+ *           key of --chain or --rekey, which the Model fuses into the cipher context so that both keys are
+ *           applied in one pass. If streaming, in binary mode (a binary message is not a string), with armor or
+ *           a container, or if an input or output file was named, calls ControllerStream to encrypt or decrypt
+ *           the whole input. Otherwise calls ControllerEncryptDecrypt to encrypt or decrypt a message and then
+ *           ViewPrintStr to print the encrypted or decrypted message.
  * RETURNS:  Nothing.
  * PSEUDOCODE:
- * Define a char array named key which is of length MAX_MSG_LEN+1.
- * Define a char array named msgOut which is of length MAX_MSG_LEN+1.
+ * If ModelGetBatchFilename() is not "" Then
+ *     Start the worker threads if -j was given, call BatchRun(), and return.
+ * End If
+ * If ModelGetAnalyze() Then
+ *     Call ControllerAnalyze() and return. It prints the key length and the key, and writes the key to -o.
+ * End If
+ * If ModelGetNgrams() Then
+ *     Call ControllerNgrams() and return. It writes the table file of the -i corpus to -o.
+ * End If
  * Call ModelGetKeyFilename() to get the key file name that was parsed from the command line.
- * Call FileReadStr() and pass the key file name and the key array as parameters. This will read the key
- *     from the file.
- * Call ModelSetKey() to store the key that was read from the file.
- * Call ModelGetMode() to get the mode from the Model (the mode was parsed from the command line).
- * Call ControllerEncryptDecrypt() and pass the mode and msgOut as parameters.
- * Call ViewPrintStr() and pass msgOut as the parameter.
+ * Call ControllerKey() and pass the key file name. This will read the key from the file (with FileReadStr(),
+ *     or FileReadBytes() for --binary, which reads the whole file as raw bytes) and store it in the Model.
+ * If --chain or --rekey was given, call ControllerKey() to read and store the second key the same way.
+ * Call ModelGetCtx() to get the cipher context for the key and the mode (the mode was parsed from the command
+ *     line).
+ * If ModelGetStream() or --binary or --armor or --container or there is an input or output file name Then
+ *     Start the worker threads if -j was given, and call ControllerStream() and pass the context.
+ * Else
+ *     Define a char array named msgOut which is of length MAX_MSG_LEN+1.
+ *     Call ControllerEncryptDecrypt() and pass the context and msgOut as parameters.
+ *     Call ViewPrintStr() and pass msgOut as the parameter.
+ * End If
  *------------------------------------------------------------------------------------------------------------*/
 void ControllerRun()
 {
-    char key[MAX_MSG_LEN+1];
-    char msgout[MAX_MSG_LEN+1];
-
-    strcpy(key, ModelGetKeyFilename());
-    FileReadStr(key, key);
-    ModelSetKey(key);
-    ControllerEncryptDecrypt(ModelGetMode(), msgout);
-    ViewPrintStr(msgout);
+    bool binary = ModelGetAlpha()->mLen == VIGENERE_ALPHA_BYTES;
+    VigenereCtx *ctx;
+
+    if (ModelGetBatchFilename()[0]) {
+        if (ModelGetThreads() != 1) PoolBegin(ModelGetThreads());
+        BatchRun(ModelGetBatchFilename());
+        PoolEnd();
+        return;
+    }
+    if (ModelGetAnalyze()) {
+        ControllerAnalyze();
+        return;
+    }
+    if (ModelGetNgrams()) {
+        ControllerNgrams();
+        return;
+    }
+    ControllerKey(ModelGetKeyFilename(), false);
+    if (ModelGetChainFilename()[0]) ControllerKey(ModelGetChainFilename(), true);
+    ctx = ModelGetCtx();
+    if (!ctx && ModelGetChainFilename()[0]) {
+        MainTerminate(TERM_ERR_KEYFILE, "key file '%s' or '%s' has a char that is not in the alphabet, or the "
+                      "keys are too long to fuse.\n", ModelGetKeyFilename(), ModelGetChainFilename());
+    }
+    if (!ctx) {
+        MainTerminate(TERM_ERR_KEYFILE, "key file '%s' has a char that is not in the alphabet.\n",
+                      ModelGetKeyFilename());
+    }
+    if (ModelGetStream() || binary || ModelGetArmor() != ARMOR_NONE || ModelGetContainer() ||
+        ModelGetInFilename()[0] || ModelGetOutFilename()[0]) {
+        if (ModelGetThreads() != 1) PoolBegin(ModelGetThreads());
+        ControllerStream(ctx);
+        PoolEnd();
+    } else {
+        char msgout[MAX_MSG_LEN+1];
+        ControllerEncryptDecrypt(ctx, msgout);
+        ViewPrintStr(msgout);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ControllerSize
+ * DESCR:    Converts pArg, the argument of the option pOption, to a byte count. Fails and terminates with an
+ *           error message if pArg is not a decimal number.
+ * RETURNS:  The byte count.
+ *------------------------------------------------------------------------------------------------------------*/
+static size_t ControllerSize(char *pOption, char *pArg)
+{
+    char *end;
+    unsigned long n = strtoul(pArg, &end, 10);
+
+    if (*end || !isdigit((unsigned char)pArg[0])) {
+        MainTerminate(TERM_ERR_CMDLINE, "%s option, invalid number of bytes: %s\n", pOption, pArg);
+    }
+    return (size_t)n;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ControllerStream
+ * DESCR:    Encrypts or decrypts every byte of the input (the -i file, or stdin) to the output (the -o file, or
+ *           stdout). Files are memory-mapped so that the kernel reads and writes the page cache directly, and a
+ *           mapped file is split across the worker threads (see PoolApply()). The key index starts at the
+ *           stream offset of pCtx. With --armor the output is not as long as the input, so it is never mapped:
+ *
+ *           --container                    The input (-i, or stdin when encrypting) is read in chunks and the
+ *                                          container is written to -o or stdout (see StreamRunContainer()).
+ *                                          -i and -o must not be the same file.
+ *           --offset or --length           Only that range of the -i file is read, with pread(), and the
+ *                                          result is written to -o or stdout. The key index starts at the one
+ *                                          the first byte has in the whole file (see StreamRunRange()).
+ *           -i and -o name the same file   The file is mapped once, shared and writable, and is encrypted in
+ *                                          place. No second copy of the data exists anywhere. Not allowed
+ *                                          with --armor.
+ *           -i and -o name different files Both are mapped and the kernel runs from one mapping to the other.
+ *                                          With --armor, the input is mapped and the result written to -o.
+ *           -i only                        The input is mapped and the result is written to stdout.
+ *           -o only, or neither            stdin is streamed in blocks to the output file or stdout, with
+ *                                          reads and writes overlapping the transform (see StreamRun()). If
+ *                                          stdin and stdout are both pipes, the output is spliced into the
+ *                                          pipe rather than copied.
+ *
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void ControllerStream(VigenereCtx *pCtx)
+{
+    char *in = ModelGetInFilename(), *out = ModelGetOutFilename();
+    char *inMap, *outMap;
+    size_t len;
+    int fd, inFd, armor = ModelGetArmor();
+
+    if (ModelGetContainer()) {
+        if (in[0] && out[0] && FileSame(in, out)) {
+            MainTerminate(TERM_ERR_CMDLINE, "--container cannot be used with -i and -o the same.\n");
+        }
+        inFd = in[0] ? FileOpenRead(in) : 0;
+        fd = out[0] ? FileOpenWrite(out) : 1;
+        StreamRunContainer(pCtx, inFd, fd);
+        if (out[0]) FileClose(fd);
+        if (in[0]) FileClose(inFd);
+    } else if (ModelGetOffset() != 0 || ModelGetLength() != (size_t)-1) {
+        if (out[0] && FileSame(in, out)) {
+            MainTerminate(TERM_ERR_CMDLINE, "--offset and --length cannot be used with -i and -o the same.\n");
+        }
+        inFd = FileOpenRead(in);
+        fd = out[0] ? FileOpenWrite(out) : 1;
+        StreamRunRange(pCtx, inFd, ModelGetOffset(), ModelGetLength(), fd);
+        if (out[0]) FileClose(fd);
+        FileClose(inFd);
+    } else if (in[0] && out[0] && FileSame(in, out)) {
+        if (armor != ARMOR_NONE) {
+            MainTerminate(TERM_ERR_CMDLINE, "--armor cannot be used with -i and -o the same.\n");
+        }
+        inMap = FileMap(in, true, &len);
+        pCtx->mPhase = PoolApply(&pCtx->mSched, pCtx->mPhase, inMap, inMap, len);
+        FileUnmap(inMap, len);
+    } else if (in[0] && out[0] && armor == ARMOR_NONE) {
+        inMap = FileMap(in, false, &len);
+        outMap = FileMapNew(out, len);
+        pCtx->mPhase = PoolApply(&pCtx->mSched, pCtx->mPhase, inMap, outMap, len);
+        FileUnmap(outMap, len);
+        FileUnmap(inMap, len);
+    } else if (in[0]) {
+        /* 1 is the file descriptor of stdout. */
+        inMap = FileMap(in, false, &len);
+        fd = out[0] ? FileOpenWrite(out) : 1;
+        StreamRunMem(pCtx, inMap, len, fd, armor);
+        if (out[0]) FileClose(fd);
+        FileUnmap(inMap, len);
+    } else {
+        /* 0 and 1 are the file descriptors of stdin and stdout. */
+        fd = out[0] ? FileOpenWrite(out) : 1;
+        StreamRun(pCtx, 0, fd, armor, ModelGetUring(), ModelGetSplice());
+        if (out[0]) FileClose(fd);
+    }
 }
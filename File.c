@@ -20,30 +20,235 @@
  * -------------------------------------------------------------------------------------------------------------
  * 24 Jan 2012 [KRB] Initial revision.
  **************************************************************************************************************/
-#include <stdio.h>    /* For FILE, fopen(), fscanf(), fclose(), fprintf() */
-#include <string.h>   /* For strlen() */
+/*
+ * open(), mmap(), and friends are POSIX, not ANSI C, so with -ansi they are not declared unless we ask for
+ * them. This must come before any #include.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>     /* For isspace() */
+#include <fcntl.h>     /* For open(), O_RDONLY, O_RDWR, O_CREAT, O_TRUNC */
+#include <stdio.h>     /* For FILE, fopen(), fgetc(), fgets(), fread(), fscanf(), fclose(), sprintf() */
+#include <stdlib.h>    /* For realloc() */
+#include <string.h>    /* For strcspn(), strlen() */
+#include <sys/mman.h>  /* For mmap(), munmap(), posix_madvise() */
+#include <sys/stat.h>  /* For fstat(), stat() */
+#include <unistd.h>    /* For close(), ftruncate() */
 #include "File.h"     /* Good to always include the module header file. See comments in Globals.c. */
-#include "Globals.h"  /* For TERM_ERR_FILE */
+#include "Globals.h"  /* For TERM_ERR_BUG, TERM_ERR_FILE */
 #include "Main.h"     /* For MainTerminate() */
 
 /*==============================================================================================================
  * Function definitions.
  *============================================================================================================*/
 
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: FileClose
+ * DESCR:    Closes a file descriptor that was returned by FileOpenRead() or FileOpenWrite().
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void FileClose
+    (
+    int pFd
+    )
+{
+    close(pFd);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: FileMap
+ * DESCR:    Maps the whole file named by pFilename into memory. If pWrite is true the mapping is shared and
+ *           writable, so bytes stored into it are written back to the file; this is how a file is encrypted
+ *           in place. Otherwise the mapping is read-only and the kernel is told that it will be read from
+ *           front to back. Fails and terminates with an error message if the file could not be mapped.
+ * RETURNS:  The address of the first byte of the file, and the length of the file in *pLen. An empty file
+ *           cannot be mapped, so for an empty file NULL is returned and *pLen is 0. Call FileUnmap() when done.
+ *------------------------------------------------------------------------------------------------------------*/
+char *FileMap
+    (
+    char   *pFilename,
+    bool    pWrite,
+    size_t *pLen
+    )
+{
+    struct stat st;
+    void *addr;
+    int fd = open(pFilename, pWrite ? O_RDWR : O_RDONLY);
+
+    if (fd < 0) {
+        MainTerminate(TERM_ERR_FILE, "could not open '%s' for %s.\n", pFilename, pWrite ? "update" : "reading");
+    }
+    if (fstat(fd, &st) < 0) MainTerminate(TERM_ERR_FILE, "could not stat '%s'.\n", pFilename);
+    *pLen = st.st_size;
+    if (*pLen == 0) {
+        close(fd);
+        return NULL;
+    }
+    addr = mmap(NULL, *pLen, pWrite ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) MainTerminate(TERM_ERR_FILE, "could not map '%s'.\n", pFilename);
+
+    /* The mapping holds its own reference to the file, so the descriptor is no longer needed. */
+    close(fd);
+    posix_madvise(addr, *pLen, POSIX_MADV_SEQUENTIAL);
+    return addr;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: FileMapNew
+ * DESCR:    Creates (or truncates) the file named by pFilename, sizes it to pLen bytes, and maps it shared and
+ *           writable. Fails and terminates with an error message if the file could not be created or mapped.
+ * RETURNS:  The address of the first byte of the file, or NULL if pLen is 0 (the file is created empty). Call
+ *           FileUnmap() when done.
+ *------------------------------------------------------------------------------------------------------------*/
+char *FileMapNew
+    (
+    char   *pFilename,
+    size_t  pLen
+    )
+{
+    void *addr;
+    int fd = open(pFilename, O_RDWR | O_CREAT | O_TRUNC, 0666);
+
+    if (fd < 0) MainTerminate(TERM_ERR_FILE, "could not open '%s' for writing.\n", pFilename);
+    if (pLen == 0) {
+        close(fd);
+        return NULL;
+    }
+    if (ftruncate(fd, pLen) < 0) MainTerminate(TERM_ERR_FILE, "could not size '%s'.\n", pFilename);
+    addr = mmap(NULL, pLen, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) MainTerminate(TERM_ERR_FILE, "could not map '%s'.\n", pFilename);
+    close(fd);
+    return addr;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: FileMapRandom
+ * DESCR:    Maps the whole file named by pFilename into memory, read-only, for lookups at random places, e.g.,
+ *           a table. The mapping is shared, so every process that maps the file uses the same copy of it in the
+ *           page cache, and the kernel is told not to read ahead, so only the pages that are looked up are
+ *           read. Fails and terminates with an error message if the file could not be mapped.
+ * RETURNS:  See FileMap().
+ *------------------------------------------------------------------------------------------------------------*/
+char *FileMapRandom
+    (
+    char   *pFilename,
+    size_t *pLen
+    )
+{
+    char *addr = FileMap(pFilename, false, pLen);
+
+    if (addr) posix_madvise(addr, *pLen, POSIX_MADV_RANDOM);
+    return addr;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: FileOpenRead
+ * DESCR:    Opens the file named by pFilename for reading. Fails and terminates with an error message if the
+ *           file could not be opened.
+ * RETURNS:  The file descriptor of the open file.
+ *------------------------------------------------------------------------------------------------------------*/
+int FileOpenRead
+    (
+    char *pFilename
+    )
+{
+    int fd = open(pFilename, O_RDONLY);
+
+    if (fd < 0) MainTerminate(TERM_ERR_FILE, "could not open '%s' for reading.\n", pFilename);
+    return fd;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: FileOpenWrite
+ * DESCR:    Creates (or truncates) the file named by pFilename for writing. Fails and terminates with an error
+ *           message if the file could not be opened.
+ * RETURNS:  The file descriptor of the open file.
+ *------------------------------------------------------------------------------------------------------------*/
+int FileOpenWrite
+    (
+    char *pFilename
+    )
+{
+    int fd = open(pFilename, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+
+    if (fd < 0) MainTerminate(TERM_ERR_FILE, "could not open '%s' for writing.\n", pFilename);
+    return fd;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: FileReadBytes
+ * DESCR:    Reads every byte of the file named pFilename, as raw bytes: nothing is skipped, NULs included, and
+ *           no newline is translated or removed. Fails and terminates with an error message if the file could
+ *           not be opened or the memory could not be allocated.
+ * RETURNS:  A buffer holding the bytes, which the caller frees with free(), and the number of bytes in *pLen.
+ *           The buffer is not null-terminated.
+ *------------------------------------------------------------------------------------------------------------*/
+char *FileReadBytes
+    (
+    char   *pFilename,
+    size_t *pLen
+    )
+{
+    FILE *in = fopen(pFilename, "rb");
+    char *buf = NULL, *grown;
+    size_t size = 0, n;
+
+    if (!in) MainTerminate(TERM_ERR_FILE, "could not open '%s' for reading.\n", pFilename);
+    *pLen = 0;
+    do {
+        if (*pLen == size) {
+            size = size ? 2 * size : 4096;
+            grown = realloc(buf, size);
+            if (!grown) MainTerminate(TERM_ERR_BUG, "could not allocate memory for '%s'.\n", pFilename);
+            buf = grown;
+        }
+        n = fread(buf + *pLen, 1, size - *pLen, in);
+        *pLen += n;
+    } while (n > 0);
+    fclose(in);
+    return buf;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: FileReadLine
+ * DESCR:    Reads the first line of the file named pFilename into pString, which has room for pSize chars.
+ *           Unlike FileReadStr(), spaces are kept. The newline (and a carriage return before it) is not. A line
+ *           that does not fit is cut off at pSize - 1 chars.
+ * RETURNS:  Nothing. pString is "" if the file is empty.
+ *------------------------------------------------------------------------------------------------------------*/
+void FileReadLine
+    (
+    char   *pFilename,
+    char   *pString,
+    size_t  pSize
+    )
+{
+    FILE *in = fopen(pFilename, "rt");
+
+    if (!in) MainTerminate(TERM_ERR_FILE, "could not open '%s' for reading.\n", pFilename);
+    if (!fgets(pString, (int)pSize, in)) pString[0] = '\0';
+    pString[strcspn(pString, "\r\n")] = '\0';
+    fclose(in);
+}
+
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: FileReadStr
  * DESCR:    Reads a string from the file named by pFilename and returns the string in pString. Fails and termi-
- *           nates with an error message if the file could not be opened for reading.
+ *           nates with an error message if the file could not be opened for reading, or if the string is longer
+ *           than pMaxLen chars.
  * RETURNS:  Nothing directly. pString is an array of chars where the string that is read will be stored. It
- *           had better be defined to be large enough to store the string that is read. It is an output param.
+ *           must have room for at least pMaxLen+1 chars. It is an output param.
  *------------------------------------------------------------------------------------------------------------*/
 void FileReadStr
     (
-    char *pFilename,
-    char *pString
+    char   *pFilename,
+    char   *pString,
+    size_t  pMaxLen
     )
 {
     FILE *in;
+    char fmt[32];
+    int c;
 
     /*
      * Open the file with name specified by pFilename. "rt" means "read text". To open a text file for writing
@@ -61,22 +266,63 @@ void FileReadStr
     /*
      * Read the string from the file. Note: the string does not contain embedded spaces, so we can use fscanf()
      * to read the string. If the string contained embedded spaces, we would have to read the string a different
-     * way. We'll see that later on.
+     * way. We'll see that later on. If the file is empty, fscanf() does not touch pString, so make sure that
+     * an empty string is returned in that case. The conversion is limited to pMaxLen chars, so a longer string
+     * cannot overflow pString; if the char after them is not whitespace, the string was too long.
      */
-	fscanf(in, "%s", pString);
+    sprintf(fmt, "%%%lus", (unsigned long)pMaxLen);
+    pString[0] = '\0';
+	fscanf(in, fmt, pString);
+    c = fgetc(in);
 
     /*
      * You should always close a file after you are finished reading from it or writing to it.
      */
     fclose(in);
+    if (c != EOF && !isspace(c)) {
+        MainTerminate(TERM_ERR_FILE, "'%s' has a string longer than %d chars.\n", pFilename, (int)pMaxLen);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: FileSame
+ * DESCR:    Determines if pFilename1 and pFilename2 name the same file, e.g., "a.txt" and "./a.txt", by
+ *           comparing the device and inode numbers of the two files.
+ * RETURNS:  true if both files exist and are the same file.
+ *------------------------------------------------------------------------------------------------------------*/
+bool FileSame
+    (
+    char *pFilename1,
+    char *pFilename2
+    )
+{
+    struct stat st1, st2;
+
+    if (stat(pFilename1, &st1) < 0 || stat(pFilename2, &st2) < 0) return false;
+    return st1.st_dev == st2.st_dev && st1.st_ino == st2.st_ino;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: FileUnmap
+ * DESCR:    Unmaps a file that was mapped by FileMap(), FileMapNew(), or FileMapRandom(). Changes to a writable
+ *           mapping have already been made to the file, so nothing else needs to be done to save them.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void FileUnmap
+    (
+    char   *pAddr,
+    size_t  pLen
+    )
+{
+    if (pAddr) munmap(pAddr, pLen);
 }
 
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: FileWriteStr
  * DESCR:    Writes the string pString to the file named by pFilename. Fails and terminates with an error
- *           message if the file could not be opened for writing.
+ *           message if the file could not be opened for writing. Used to write the key that analyze mode
+ *           recovers.
  * RETURNS:  Nothing.
- * NOTE:     This function is currently unused but is placed here for future use.
  *------------------------------------------------------------------------------------------------------------*/
 void FileWriteStr
     (
@@ -2,7 +2,9 @@
  * FILE: File.h
  *
  * DESCRIPTION
- * File I/O routines.
+ * File I/O routines. Besides reading and writing strings, a file can be memory-mapped so the Vigenere kernel
+ * can read the message straight out of the page cache and write the result straight into the output file,
+ * without copying every byte through stdio.
  *
  * AUTHOR INFORMATION
  * Kevin R. Burger [KRB]
@@ -23,6 +25,9 @@
 #ifndef _FILE_H_ /* Preprocessor guard to File.h from being included more than once */
 #define _FILE_H_ /* See comments in Main.h. */
 
+#include <stddef.h>  /* For size_t */
+#include "Types.h"   /* For bool */
+
 /*==============================================================================================================
  * Global function declarations.
  *
@@ -30,10 +35,60 @@
  *============================================================================================================*/
 
 /* Look at the function definitions in File.c to see what declarations you should write here. */
+void FileClose
+    (
+    int pFd
+    );
+char *FileMap
+    (
+    char   *pFilename,
+    bool    pWrite,
+    size_t *pLen
+    );
+char *FileMapNew
+    (
+    char   *pFilename,
+    size_t  pLen
+    );
+char *FileMapRandom
+    (
+    char   *pFilename,
+    size_t *pLen
+    );
+int FileOpenRead
+    (
+    char *pFilename
+    );
+int FileOpenWrite
+    (
+    char *pFilename
+    );
+char *FileReadBytes
+    (
+    char   *pFilename,
+    size_t *pLen
+    );
+void FileReadLine
+    (
+    char   *pFilename,
+    char   *pString,
+    size_t  pSize
+    );
 void FileReadStr
     (
-    char *pFilename,
-    char *pString
+    char   *pFilename,
+    char   *pString,
+    size_t  pMaxLen
+    );
+bool FileSame
+    (
+    char *pFilename1,
+    char *pFilename2
+    );
+void FileUnmap
+    (
+    char   *pAddr,
+    size_t  pLen
     );
 void FileWriteStr
     (
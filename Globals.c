@@ -228,9 +228,13 @@ const char *COPY            = "2012";
 const char *VERSION         = "1.0";
 
 const int MAX_MSG_LEN       = 4096;
+const int STREAM_BLOCK_LEN  = 1 << 20;
 const int TERM_ERR_ALPHA    =   -1;
+const int TERM_ERR_ANALYZE  =   -9;
+const int TERM_ERR_ARMOR    =   -7;
 const int TERM_ERR_BUG      =   -2;
 const int TERM_ERR_CMDLINE  =   -3;
+const int TERM_ERR_CONTAINER =  -8;
 const int TERM_ERR_FILE     =   -4;
 const int TERM_ERR_KEYFILE  =   -5;
 const int TERM_ERR_MODE     =   -6;
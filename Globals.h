@@ -43,9 +43,13 @@ extern const char *COPY;
 extern const char *VERSION;
 
 extern const int MAX_MSG_LEN;
+extern const int STREAM_BLOCK_LEN;
 extern const int TERM_ERR_ALPHA;
+extern const int TERM_ERR_ANALYZE;
+extern const int TERM_ERR_ARMOR;
 extern const int TERM_ERR_BUG;
 extern const int TERM_ERR_CMDLINE;
+extern const int TERM_ERR_CONTAINER;
 extern const int TERM_ERR_FILE;
 extern const int TERM_ERR_KEYFILE;
 extern const int TERM_ERR_MODE;
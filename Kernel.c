@@ -0,0 +1,736 @@
+/***************************************************************************************************************
+ * FILE: Kernel.c
+ *
+ * DESCRIPTION
+ * See comments in Kernel.h.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#include <string.h>  /* For memcpy() */
+#include <stdint.h>  /* For uint64_t */
+#include "Kernel.h"  /* Good to always include the module header file. See comments in Globals.c. */
+#include "String.h"  /* For streq */
+
+/*
+ * The vector kernels are only written for x86. Each one is compiled for its own instruction set with the
+ * target attribute, so the rest of the program can still be built for (and run on) a plain x86 machine. On
+ * any other machine only the scalar and swar tiers exist.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+#define KERNEL_X86
+#include <cpuid.h>      /* For __get_cpuid(), __get_cpuid_count(), bit_SSE2, bit_AVX2, ... */
+#include <immintrin.h>  /* For the SSE2, AVX2, and AVX-512 intrinsics */
+#endif
+
+/*==============================================================================================================
+ * Preprocessor macros for the swar kernel. SWAR_ONES has a 1 in every byte of a 64-bit word and SWAR_HIGH has
+ * the high bit of every byte set. SWAR_BYTES(b) is a word with b in every byte.
+ *============================================================================================================*/
+#define SWAR_ONES     (~(uint64_t)0 / 255)
+#define SWAR_HIGH     (SWAR_ONES * 0x80)
+#define SWAR_BYTES(b) (SWAR_ONES * (b))
+
+/*==============================================================================================================
+ * Static function declarations.
+ *============================================================================================================*/
+#ifdef KERNEL_X86
+static size_t KernelAvx2(const VigenereSched *pSched, size_t *pPhase, const char *pIn, char *pOut, size_t pLen);
+static __m256i KernelAvx2Lookup(const __m256i *pTable, __m256i pX);
+static size_t KernelAvx2Table(const VigenereSched *pSched, size_t *pPhase, const char *pIn, char *pOut,
+    size_t pLen);
+static size_t KernelAvx2Text(const VigenereSched *pSched, size_t *pPhase, const char *pIn, char *pOut,
+    size_t pLen);
+static size_t KernelAvx512(const VigenereSched *pSched, size_t *pPhase, const char *pIn, char *pOut,
+    size_t pLen);
+static __m512i KernelAvx512Lookup(const __m512i *pTable, __m512i pX);
+static size_t KernelAvx512Table(const VigenereSched *pSched, size_t *pPhase, const char *pIn, char *pOut,
+    size_t pLen);
+static size_t KernelAvx512Text(const VigenereSched *pSched, size_t *pPhase, const char *pIn, char *pOut,
+    size_t pLen);
+static size_t KernelSse2(const VigenereSched *pSched, size_t *pPhase, const char *pIn, char *pOut, size_t pLen);
+#endif
+static size_t KernelScalar(const VigenereSched *pSched, size_t *pPhase, const char *pIn, char *pOut,
+    size_t pLen);
+static bool KernelSupported(int pTier);
+static size_t KernelSwar(const VigenereSched *pSched, size_t *pPhase, const char *pIn, char *pOut, size_t pLen);
+
+/*==============================================================================================================
+ * Static global variables.
+ *
+ * gKernelTiers lists the tiers from slowest to fastest. On a machine without x86 the vector tiers have a NULL
+ * function and are never supported. gKernel is the index in gKernelTiers of the tier that is in use, or -1 if
+ * KernelBegin() has not been called yet. The library may be called from several threads at once, so gKernel is
+ * only read and written with the __atomic builtins.
+ *============================================================================================================*/
+typedef size_t (*KernelFunc)(const VigenereSched *, size_t *, const char *, char *, size_t);
+
+static const struct {
+    const char *mName;  /* The name of the tier, for KernelSelect() and KernelGetName() */
+    KernelFunc  mFunc;  /* The kernel for the tier */
+} gKernelTiers[] = {
+    { "scalar",   KernelScalar },
+    { "swar",     KernelSwar   },
+#ifdef KERNEL_X86
+    { "sse2",     KernelSse2   },
+    { "avx2",     KernelAvx2   },
+    { "avx512bw", KernelAvx512 }
+#else
+    { "sse2",     NULL         },
+    { "avx2",     NULL         },
+    { "avx512bw", NULL         }
+#endif
+};
+
+#define KERNEL_TIERS ((int)(sizeof(gKernelTiers) / sizeof(gKernelTiers[0])))
+
+static int gKernel = -1;
+
+/*==============================================================================================================
+ * Function definitions.
+ *============================================================================================================*/
+
+#ifdef KERNEL_X86
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelAvx2
+ * DESCR:    Same as KernelSse2() but 32 chars at a time, using the AVX2 blend in place of and/andnot/or. An
+ *           alphabet that is not a range is done by KernelAvx2Table(), and the text alphabet by
+ *           KernelAvx2Text().
+ * RETURNS:  The number of chars done, which is pLen rounded down to a multiple of 32.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static size_t KernelAvx2
+    (
+    const VigenereSched *pSched,
+    size_t              *pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    )
+{
+    const VigenereAlpha *alph = &pSched->mAlpha;
+    __m256i a, last, n, key;
+    size_t i, k = *pPhase, step = 32 % pSched->mLen;
+
+    if (alph->mText) return KernelAvx2Text(pSched, pPhase, pIn, pOut, pLen);
+    if (!alph->mRange) return KernelAvx2Table(pSched, pPhase, pIn, pOut, pLen);
+    a    = _mm256_set1_epi8((char)alph->mBase);
+    last = _mm256_set1_epi8((char)(alph->mLen - 1));
+    n    = _mm256_set1_epi8((char)alph->mLen);
+    key  = _mm256_loadu_si256((const __m256i *)(pSched->mShift + k));
+    for (i = 0; i + 32 <= pLen; i += 32) {
+        __m256i x     = _mm256_loadu_si256((const __m256i *)(pIn + i));
+        __m256i col   = _mm256_sub_epi8(x, a);
+        __m256i alpha = _mm256_cmpeq_epi8(_mm256_min_epu8(col, last), col);
+        __m256i r     = _mm256_add_epi8(col, key);
+        r = _mm256_add_epi8(_mm256_min_epu8(r, _mm256_sub_epi8(r, n)), a);
+        _mm256_storeu_si256((__m256i *)(pOut + i), _mm256_blendv_epi8(x, r, alpha));
+        if (step) {
+            k += step;
+            if (k >= pSched->mLen) k -= pSched->mLen;
+            key = _mm256_loadu_si256((const __m256i *)(pSched->mShift + k));
+        }
+    }
+    *pPhase = k;
+    return i;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelAvx2Lookup
+ * DESCR:    Looks each byte of pX up in the 128-entry table pTable, which is given as 8 rows of 16 entries,
+ *           each row in both 128-bit lanes. The low nibble of a byte picks the entry with a shuffle in every
+ *           row, and the high nibble picks the row with a compare and a blend, so there is no branch and no
+ *           gather.
+ * RETURNS:  The looked up bytes. A byte >= 0x80 gives VIGENERE_ALPHA_NONE.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static __m256i KernelAvx2Lookup
+    (
+    const __m256i *pTable,
+    __m256i        pX
+    )
+{
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i lo  = _mm256_and_si256(pX, low);
+    __m256i hi  = _mm256_and_si256(_mm256_srli_epi16(pX, 4), low);
+    __m256i out = _mm256_set1_epi8((char)VIGENERE_ALPHA_NONE);
+    int row;
+
+    for (row = 0; row < 8; ++row) {
+        __m256i sel = _mm256_cmpeq_epi8(hi, _mm256_set1_epi8((char)row));
+        out = _mm256_blendv_epi8(out, _mm256_shuffle_epi8(pTable[row], lo), sel);
+    }
+    return out;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelAvx2Table
+ * DESCR:    Encrypts/decrypts 32 chars at a time for an alphabet that is not a range, with the lookup tables of
+ *           the alphabet (see VigenereAlpha). For each lane,
+ *
+ *           col   <- mIndex[char]                         -- VIGENERE_ALPHA_NONE if not in the alphabet
+ *           alpha <- min(col, n - 1) == col
+ *           r     <- min(col + row, col + row - n)        -- as in KernelSse2()
+ *           out   <- alpha ? mChar[r] : char
+ *
+ * RETURNS:  The number of chars done, which is pLen rounded down to a multiple of 32.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static size_t KernelAvx2Table
+    (
+    const VigenereSched *pSched,
+    size_t              *pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    )
+{
+    const VigenereAlpha *alph = &pSched->mAlpha;
+    const __m256i last = _mm256_set1_epi8((char)(alph->mLen - 1)), n = _mm256_set1_epi8((char)alph->mLen);
+    __m256i index[8], chars[8], key;
+    size_t i, k = *pPhase, step = 32 % pSched->mLen;
+    int row;
+
+    for (row = 0; row < 8; ++row) {
+        index[row] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(alph->mIndex + 16 * row)));
+        chars[row] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(alph->mChar + 16 * row)));
+    }
+    key = _mm256_loadu_si256((const __m256i *)(pSched->mShift + k));
+    for (i = 0; i + 32 <= pLen; i += 32) {
+        __m256i x     = _mm256_loadu_si256((const __m256i *)(pIn + i));
+        __m256i col   = KernelAvx2Lookup(index, x);
+        __m256i alpha = _mm256_cmpeq_epi8(_mm256_min_epu8(col, last), col);
+        __m256i r     = _mm256_add_epi8(col, key);
+        r = KernelAvx2Lookup(chars, _mm256_min_epu8(r, _mm256_sub_epi8(r, n)));
+        _mm256_storeu_si256((__m256i *)(pOut + i), _mm256_blendv_epi8(x, r, alpha));
+        if (step) {
+            k += step;
+            if (k >= pSched->mLen) k -= pSched->mLen;
+            key = _mm256_loadu_si256((const __m256i *)(pSched->mShift + k));
+        }
+    }
+    *pPhase = k;
+    return i;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelAvx2Text
+ * DESCR:    Encrypts/decrypts 32 chars at a time for the text alphabet, where the key advances only on letters,
+ *           so the key index of a lane depends on how many letters come before it in the vector. That count is
+ *           a prefix sum of the letter mask, done in log2(16) shift-and-adds within each 128-bit lane plus one
+ *           add of the low lane's total into the high lane. For each lane,
+ *
+ *           col   <- (char | 0x20) - 'a'                  -- the case bit is folded away
+ *           alpha <- min(col, 25) == col
+ *           j     <- the number of letters in the lanes before this one
+ *           row   <- mShift[k + j]                        -- two 16-entry shuffles and a blend, as j < 32
+ *           r     <- min(col + row, col + row - 26)
+ *           out   <- alpha ? ('A' + r) | (char & 0x20) : char
+ *
+ *           k then advances by the number of letters in the vector, which is the last prefix sum. A key of at
+ *           most 32 chars can wrap more than once per vector, so for those the new k is looked up in a table
+ *           of k mod the key length rather than divided.
+ * RETURNS:  The number of chars done, which is pLen rounded down to a multiple of 32.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("avx2")))
+static size_t KernelAvx2Text
+    (
+    const VigenereSched *pSched,
+    size_t              *pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    )
+{
+    const __m256i a = _mm256_set1_epi8('a'), last = _mm256_set1_epi8(25), n = _mm256_set1_epi8(26);
+    const __m256i one = _mm256_set1_epi8(1), fold = _mm256_set1_epi8(0x20), upper = _mm256_set1_epi8('A');
+    const __m256i fifteen = _mm256_set1_epi8(15);
+    unsigned char wrap[64];
+    size_t i, k = *pPhase, len = pSched->mLen;
+
+    if (len <= 32 && pLen >= 32) for (i = 0; i < 64; ++i) wrap[i] = (unsigned char)(i % len);
+    for (i = 0; i + 32 <= pLen; i += 32) {
+        __m256i x     = _mm256_loadu_si256((const __m256i *)(pIn + i));
+        __m256i col   = _mm256_sub_epi8(_mm256_or_si256(x, fold), a);
+        __m256i alpha = _mm256_cmpeq_epi8(_mm256_min_epu8(col, last), col);
+        __m256i ones  = _mm256_and_si256(alpha, one);
+        __m256i pre   = ones, j, lo, hi, key, r;
+        pre = _mm256_add_epi8(pre, _mm256_slli_si256(pre, 1));
+        pre = _mm256_add_epi8(pre, _mm256_slli_si256(pre, 2));
+        pre = _mm256_add_epi8(pre, _mm256_slli_si256(pre, 4));
+        pre = _mm256_add_epi8(pre, _mm256_slli_si256(pre, 8));
+        pre = _mm256_add_epi8(pre, _mm256_permute2x128_si256(_mm256_shuffle_epi8(pre, fifteen), pre, 0x08));
+        j   = _mm256_sub_epi8(pre, ones);
+        lo  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(pSched->mShift + k)));
+        hi  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(pSched->mShift + k + 16)));
+        key = _mm256_blendv_epi8(_mm256_shuffle_epi8(lo, j), _mm256_shuffle_epi8(hi, j),
+                                 _mm256_cmpgt_epi8(j, fifteen));
+        r   = _mm256_add_epi8(col, key);
+        r   = _mm256_add_epi8(_mm256_min_epu8(r, _mm256_sub_epi8(r, n)), upper);
+        r   = _mm256_or_si256(r, _mm256_and_si256(x, fold));
+        _mm256_storeu_si256((__m256i *)(pOut + i), _mm256_blendv_epi8(x, r, alpha));
+        k += (unsigned char)_mm256_extract_epi8(pre, 31);
+        if (len <= 32) k = wrap[k];
+        else if (k >= len) k -= len;
+    }
+    *pPhase = k;
+    return i;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelAvx512
+ * DESCR:    Same as KernelSse2() but 64 chars at a time. The letter test produces a mask register which drives
+ *           a masked blend. The chars after the last whole vector are done with a masked load and store, so
+ *           unlike the other kernels this one always finishes the message. An alphabet that is not a range is
+ *           done by KernelAvx512Table(), and the text alphabet by KernelAvx512Text().
+ * RETURNS:  pLen.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("avx512bw")))
+static size_t KernelAvx512
+    (
+    const VigenereSched *pSched,
+    size_t              *pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    )
+{
+    const VigenereAlpha *alph = &pSched->mAlpha;
+    __m512i a, last, n, key;
+    size_t i, k = *pPhase, step = 64 % pSched->mLen;
+    __mmask64 tail = ~(__mmask64)0;
+
+    if (alph->mText) return KernelAvx512Text(pSched, pPhase, pIn, pOut, pLen);
+    if (!alph->mRange) return KernelAvx512Table(pSched, pPhase, pIn, pOut, pLen);
+    a    = _mm512_set1_epi8((char)alph->mBase);
+    last = _mm512_set1_epi8((char)(alph->mLen - 1));
+    n    = _mm512_set1_epi8((char)alph->mLen);
+    key  = _mm512_loadu_si512(pSched->mShift + k);
+    for (i = 0; i < pLen; i += 64) {
+        __m512i x, col, r;
+        __mmask64 alpha;
+        if (pLen - i < 64) tail = ((__mmask64)1 << (pLen - i)) - 1;
+        x     = _mm512_maskz_loadu_epi8(tail, pIn + i);
+        col   = _mm512_sub_epi8(x, a);
+        alpha = _mm512_cmple_epu8_mask(col, last);
+        r     = _mm512_add_epi8(col, key);
+        r     = _mm512_add_epi8(_mm512_min_epu8(r, _mm512_sub_epi8(r, n)), a);
+        _mm512_mask_storeu_epi8(pOut + i, tail, _mm512_mask_blend_epi8(alpha, x, r));
+        if (pLen - i < 64) {
+            k = (k + (pLen - i)) % pSched->mLen;
+        } else if (step) {
+            k += step;
+            if (k >= pSched->mLen) k -= pSched->mLen;
+            key = _mm512_loadu_si512(pSched->mShift + k);
+        }
+    }
+    *pPhase = k;
+    return pLen;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelAvx512Lookup
+ * DESCR:    Same as KernelAvx2Lookup() but 64 bytes at a time, with mask registers for the row select.
+ * RETURNS:  The looked up bytes. A byte >= 0x80 gives VIGENERE_ALPHA_NONE.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("avx512bw")))
+static __m512i KernelAvx512Lookup
+    (
+    const __m512i *pTable,
+    __m512i        pX
+    )
+{
+    const __m512i low = _mm512_set1_epi8(0x0F);
+    __m512i lo  = _mm512_and_si512(pX, low);
+    __m512i hi  = _mm512_and_si512(_mm512_srli_epi16(pX, 4), low);
+    __m512i out = _mm512_set1_epi8((char)VIGENERE_ALPHA_NONE);
+    int row;
+
+    for (row = 0; row < 8; ++row) {
+        __mmask64 sel = _mm512_cmpeq_epi8_mask(hi, _mm512_set1_epi8((char)row));
+        out = _mm512_mask_shuffle_epi8(out, sel, pTable[row], lo);
+    }
+    return out;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelAvx512Table
+ * DESCR:    Same as KernelAvx2Table() but 64 chars at a time, with a masked load and store for the chars after
+ *           the last whole vector, as in KernelAvx512().
+ * RETURNS:  pLen.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("avx512bw")))
+static size_t KernelAvx512Table
+    (
+    const VigenereSched *pSched,
+    size_t              *pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    )
+{
+    const VigenereAlpha *alph = &pSched->mAlpha;
+    const __m512i last = _mm512_set1_epi8((char)(alph->mLen - 1)), n = _mm512_set1_epi8((char)alph->mLen);
+    __m512i index[8], chars[8], key;
+    size_t i, k = *pPhase, step = 64 % pSched->mLen;
+    __mmask64 tail = ~(__mmask64)0;
+    int row;
+
+    for (row = 0; row < 8; ++row) {
+        index[row] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)(alph->mIndex + 16 * row)));
+        chars[row] = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)(alph->mChar + 16 * row)));
+    }
+    key = _mm512_loadu_si512(pSched->mShift + k);
+    for (i = 0; i < pLen; i += 64) {
+        __m512i x, col, r;
+        __mmask64 alpha;
+        if (pLen - i < 64) tail = ((__mmask64)1 << (pLen - i)) - 1;
+        x     = _mm512_maskz_loadu_epi8(tail, pIn + i);
+        col   = KernelAvx512Lookup(index, x);
+        alpha = _mm512_cmple_epu8_mask(col, last);
+        r     = _mm512_add_epi8(col, key);
+        r     = KernelAvx512Lookup(chars, _mm512_min_epu8(r, _mm512_sub_epi8(r, n)));
+        _mm512_mask_storeu_epi8(pOut + i, tail, _mm512_mask_blend_epi8(alpha, x, r));
+        if (pLen - i < 64) {
+            k = (k + (pLen - i)) % pSched->mLen;
+        } else if (step) {
+            k += step;
+            if (k >= pSched->mLen) k -= pSched->mLen;
+            key = _mm512_loadu_si512(pSched->mShift + k);
+        }
+    }
+    *pPhase = k;
+    return pLen;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelAvx512Text
+ * DESCR:    Same as KernelAvx2Text() but 64 chars at a time. The prefix sum of the letter mask is done within
+ *           each 128-bit lane as in KernelAvx2Text(), and the totals of the four lanes are then summed across
+ *           lanes with two lane shuffles, and shifted up a lane with a third. The row for each lane is picked
+ *           from 64 entries of the key schedule with four 16-entry shuffles under masks. The chars after the
+ *           last whole vector are done with a masked load and store, as in KernelAvx512().
+ * RETURNS:  pLen.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("avx512bw,popcnt")))
+static size_t KernelAvx512Text
+    (
+    const VigenereSched *pSched,
+    size_t              *pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    )
+{
+    const __m512i a = _mm512_set1_epi8('a'), last = _mm512_set1_epi8(25), n = _mm512_set1_epi8(26);
+    const __m512i one = _mm512_set1_epi8(1), fold = _mm512_set1_epi8(0x20), upper = _mm512_set1_epi8('A');
+    const __m512i fifteen = _mm512_set1_epi8(15);
+    unsigned char wrap[128];
+    size_t i, k = *pPhase, len = pSched->mLen;
+    __mmask64 tail = ~(__mmask64)0;
+
+    if (len <= 64 && pLen > 0) for (i = 0; i < 128; ++i) wrap[i] = (unsigned char)(i % len);
+    for (i = 0; i < pLen; i += 64) {
+        __m512i x, col, ones, pre, sum, j, key, r;
+        __mmask64 alpha;
+        if (pLen - i < 64) tail = ((__mmask64)1 << (pLen - i)) - 1;
+        x     = _mm512_maskz_loadu_epi8(tail, pIn + i);
+        col   = _mm512_sub_epi8(_mm512_or_si512(x, fold), a);
+        alpha = _mm512_cmple_epu8_mask(col, last);
+        ones  = _mm512_maskz_mov_epi8(alpha, one);
+        pre   = _mm512_add_epi8(ones, _mm512_bslli_epi128(ones, 1));
+        pre   = _mm512_add_epi8(pre, _mm512_bslli_epi128(pre, 2));
+        pre   = _mm512_add_epi8(pre, _mm512_bslli_epi128(pre, 4));
+        pre   = _mm512_add_epi8(pre, _mm512_bslli_epi128(pre, 8));
+        sum   = _mm512_shuffle_epi8(pre, fifteen);
+        sum   = _mm512_add_epi8(sum, _mm512_maskz_shuffle_i32x4(0xFFF0, sum, sum, 0x90));
+        sum   = _mm512_add_epi8(sum, _mm512_maskz_shuffle_i32x4(0xFF00, sum, sum, 0x40));
+        j     = _mm512_sub_epi8(_mm512_add_epi8(pre, _mm512_maskz_shuffle_i32x4(0xFFF0, sum, sum, 0x90)), ones);
+        key   = _mm512_shuffle_epi8(
+                    _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)(pSched->mShift + k))), j);
+        key   = _mm512_mask_shuffle_epi8(key, _mm512_cmpgt_epu8_mask(j, fifteen),
+                    _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)(pSched->mShift + k + 16))), j);
+        key   = _mm512_mask_shuffle_epi8(key, _mm512_cmpgt_epu8_mask(j, _mm512_set1_epi8(31)),
+                    _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)(pSched->mShift + k + 32))), j);
+        key   = _mm512_mask_shuffle_epi8(key, _mm512_cmpgt_epu8_mask(j, _mm512_set1_epi8(47)),
+                    _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)(pSched->mShift + k + 48))), j);
+        r     = _mm512_add_epi8(col, key);
+        r     = _mm512_add_epi8(_mm512_min_epu8(r, _mm512_sub_epi8(r, n)), upper);
+        r     = _mm512_or_si512(r, _mm512_and_si512(x, fold));
+        _mm512_mask_storeu_epi8(pOut + i, tail, _mm512_mask_blend_epi8(alpha, x, r));
+        k += (size_t)__builtin_popcountll(alpha);
+        if (len <= 64) k = wrap[k];
+        else if (k >= len) k -= len;
+    }
+    *pPhase = k;
+    return pLen;
+}
+#endif
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelBegin
+ * DESCR:    Initializes the Kernel module by selecting the fastest tier that this CPU supports. Calling it
+ *           again does nothing, so a tier forced with KernelSelect() stays in effect.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void KernelBegin
+    (
+    )
+{
+    int tier, unset = -1;
+
+    if (__atomic_load_n(&gKernel, __ATOMIC_ACQUIRE) >= 0) return;
+    for (tier = KERNEL_TIERS - 1; !KernelSupported(tier); --tier) ;
+    /* Threads that get here at the same time all pick the same tier. Only store it if no tier is set yet. */
+    __atomic_compare_exchange_n(&gKernel, &unset, tier, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelGetName
+ * DESCR:    Returns the name of the tier that is in use.
+ * RETURNS:  One of "scalar", "swar", "sse2", "avx2", or "avx512bw".
+ *------------------------------------------------------------------------------------------------------------*/
+const char *KernelGetName
+    (
+    )
+{
+    return gKernelTiers[KernelGetTier()].mName;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelGetTier
+ * DESCR:    Returns the tier that is in use.
+ * RETURNS:  One of KERNEL_SCALAR, KERNEL_SWAR, KERNEL_SSE2, KERNEL_AVX2, or KERNEL_AVX512BW.
+ *------------------------------------------------------------------------------------------------------------*/
+int KernelGetTier
+    (
+    )
+{
+    KernelBegin();
+    return __atomic_load_n(&gKernel, __ATOMIC_ACQUIRE);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelScalar
+ * DESCR:    The kernel for the scalar tier. It does nothing so that VigenereApply() does the whole message.
+ * RETURNS:  0.
+ *------------------------------------------------------------------------------------------------------------*/
+static size_t KernelScalar
+    (
+    const VigenereSched *pSched,
+    size_t              *pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    )
+{
+    return 0;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelSelect
+ * DESCR:    Forces the tier named pName to be used, e.g., KernelSelect("swar"). It may only be called before
+ *           the first encryption/decryption. A thread that is already running a kernel keeps the tier it
+ *           started with, so selecting a tier while other threads use the Kernel module mixes tiers.
+ * RETURNS:  true if the tier was selected. false if there is no tier named pName or this CPU does not support
+ *           it, in which case the tier in use is not changed.
+ *------------------------------------------------------------------------------------------------------------*/
+bool KernelSelect
+    (
+    const char *pName
+    )
+{
+    int tier;
+
+    for (tier = 0; tier < KERNEL_TIERS; ++tier) {
+        if (streq(gKernelTiers[tier].mName, pName) && KernelSupported(tier)) {
+            __atomic_store_n(&gKernel, tier, __ATOMIC_RELEASE);
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef KERNEL_X86
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelSse2
+ * DESCR:    Encrypts/decrypts 16 chars at a time, for an alphabet that is the range of n chars starting at
+ *           base ('A' and 26 by default). For each lane,
+ *
+ *           col   <- char - base                          -- 0..n-1 for a letter, anything else otherwise
+ *           alpha <- min(col, n - 1) == col               -- unsigned, so true iff the char is a letter
+ *           r     <- col + row                            -- 0..2n-2 for a letter, which fits in a byte
+ *           r     <- min(r, r - n)                        -- unsigned, so this is r mod n for r in 0..2n-1
+ *           out   <- alpha ? base + r : char
+ *
+ *           The rows for the 16 lanes are loaded from the padded key schedule starting at key index k. When
+ *           the key length divides 16 the rows are the same for every vector and stay in a register. SSE2 has
+ *           no byte shuffle, so an alphabet that is not a range, and the text alphabet, whose rows are picked
+ *           by a shuffle (see KernelAvx2Text()), are left to VigenereApply().
+ * RETURNS:  The number of chars done, which is pLen rounded down to a multiple of 16 (0 if the alphabet is not
+ *           a range or is the text alphabet). *pPhase is advanced past them.
+ *------------------------------------------------------------------------------------------------------------*/
+__attribute__((target("sse2")))
+static size_t KernelSse2
+    (
+    const VigenereSched *pSched,
+    size_t              *pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    )
+{
+    const VigenereAlpha *alph = &pSched->mAlpha;
+    __m128i a, last, n, key;
+    size_t i, k = *pPhase, step = 16 % pSched->mLen;
+
+    if (!alph->mRange || alph->mText) return 0;
+    a    = _mm_set1_epi8((char)alph->mBase);
+    last = _mm_set1_epi8((char)(alph->mLen - 1));
+    n    = _mm_set1_epi8((char)alph->mLen);
+    key  = _mm_loadu_si128((const __m128i *)(pSched->mShift + k));
+    for (i = 0; i + 16 <= pLen; i += 16) {
+        __m128i x     = _mm_loadu_si128((const __m128i *)(pIn + i));
+        __m128i col   = _mm_sub_epi8(x, a);
+        __m128i alpha = _mm_cmpeq_epi8(_mm_min_epu8(col, last), col);
+        __m128i r     = _mm_add_epi8(col, key);
+        r = _mm_add_epi8(_mm_min_epu8(r, _mm_sub_epi8(r, n)), a);
+        _mm_storeu_si128((__m128i *)(pOut + i),
+                         _mm_or_si128(_mm_and_si128(alpha, r), _mm_andnot_si128(alpha, x)));
+        if (step) {
+            k += step;
+            if (k >= pSched->mLen) k -= pSched->mLen;
+            key = _mm_loadu_si128((const __m128i *)(pSched->mShift + k));
+        }
+    }
+    *pPhase = k;
+    return i;
+}
+#endif
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelSupported
+ * DESCR:    Determines if this CPU supports tier pTier. The x86 tiers are checked with cpuid. For AVX2 and
+ *           AVX-512 the OS must also save the wider registers on a context switch, which is checked by reading
+ *           XCR0 with xgetbv.
+ * RETURNS:  true if the tier can be used.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool KernelSupported
+    (
+    int pTier
+    )
+{
+#ifdef KERNEL_X86
+    unsigned eax, ebx, ecx, edx, xcr0 = 0, leaf7 = 0;
+#endif
+
+    if (!gKernelTiers[pTier].mFunc) return false;
+    if (gKernelTiers[pTier].mFunc == KernelScalar || gKernelTiers[pTier].mFunc == KernelSwar) return true;
+#ifdef KERNEL_X86
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    if (gKernelTiers[pTier].mFunc == KernelSse2) return (edx & bit_SSE2) != 0;
+    if (ecx & bit_OSXSAVE) __asm__ volatile ("xgetbv" : "=a" (xcr0), "=d" (edx) : "c" (0));
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) leaf7 = ebx;
+    if (gKernelTiers[pTier].mFunc == KernelAvx2) {
+        return (xcr0 & 0x06) == 0x06 && (leaf7 & bit_AVX2);
+    }
+    if (gKernelTiers[pTier].mFunc == KernelAvx512) {
+        return (xcr0 & 0xE6) == 0xE6 && (leaf7 & bit_AVX512F) && (leaf7 & bit_AVX512BW);
+    }
+#endif
+    return false;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelSwar
+ * DESCR:    Encrypts/decrypts 8 chars at a time in a 64-bit word. The steps are the same as KernelSse2(), but
+ *           there are no byte-wise compares or minimums, so each one is done with the high bit of each byte
+ *           as a flag. Setting the high bit of every byte before a subtract guarantees that no byte borrows
+ *           from its neighbor, and the high bit of the result tells if the byte was >= the value subtracted.
+ *
+ *           alpha <- x >= base && x < base + n && x < 0x80 -- as a high bit flag, then as a 0x00/0xFF mask
+ *           col   <- x - base                             -- only meaningful in the letter bytes
+ *           r     <- col + row                            -- at most 0x7F + n - 1, so no carry out of the byte
+ *           r     <- r >= n ? r - n : r
+ *           out   <- alpha ? base + r : x                 -- r is masked first so that base + r cannot carry
+ *
+ *           The r >= n test only works while r < 0x80, i.e., for a letter byte when n <= 64. So, an alphabet
+ *           that has more than 64 chars, is not a range, or is the text alphabet, is left to VigenereApply().
+ *           The exception is the binary alphabet, where every byte is a letter and r mod 256 is a plain add
+ *           that must not carry into the next byte: add the low 7 bits of each byte, then xor in the sum of
+ *           the high bits, which is their xor.
+ * RETURNS:  The number of chars done, which is pLen rounded down to a multiple of 8 (or 0, see above).
+ *------------------------------------------------------------------------------------------------------------*/
+static size_t KernelSwar
+    (
+    const VigenereSched *pSched,
+    size_t              *pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    )
+{
+    size_t i, k = *pPhase, step = 8 % pSched->mLen;
+    uint64_t key, base = pSched->mAlpha.mBase, n = pSched->mAlpha.mLen;
+
+    if (!pSched->mAlpha.mRange || pSched->mAlpha.mText || (n > 64 && n != VIGENERE_ALPHA_BYTES)) return 0;
+    memcpy(&key, pSched->mShift + k, 8);
+    for (i = 0; i + 8 <= pLen; i += 8) {
+        uint64_t x, alpha, col, r;
+        memcpy(&x, pIn + i, 8);
+        if (n == VIGENERE_ALPHA_BYTES) {
+            r = ((x & ~SWAR_HIGH) + (key & ~SWAR_HIGH)) ^ ((x ^ key) & SWAR_HIGH);
+        } else {
+            alpha = ((x | SWAR_HIGH) - SWAR_BYTES(base)) & ~((x | SWAR_HIGH) - SWAR_BYTES(base + n)) & ~x &
+                    SWAR_HIGH;
+            alpha = (alpha >> 7) * 0xFF;
+            col   = ((x | SWAR_HIGH) - SWAR_BYTES(base)) & ~SWAR_HIGH;
+            r     = col + key;
+            r    -= ((((r | SWAR_HIGH) - SWAR_BYTES(n)) & SWAR_HIGH) >> 7) * n;
+            r     = (((r & alpha) + SWAR_BYTES(base)) & alpha) | (x & ~alpha);
+        }
+        memcpy(pOut + i, &r, 8);
+        if (step) {
+            k += step;
+            if (k >= pSched->mLen) k -= pSched->mLen;
+            memcpy(&key, pSched->mShift + k, 8);
+        }
+    }
+    *pPhase = k;
+    return i;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: KernelVector
+ * DESCR:    Runs the kernel of the selected tier over as much of pIn as fills whole vectors. pPhase is the key
+ *           index of pIn[0] on entry and is advanced past the chars that were done. pIn and pOut may be the
+ *           same buffer.
+ * RETURNS:  The number of chars done. The caller does the remaining pLen - (return value) chars.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t KernelVector
+    (
+    const VigenereSched *pSched,
+    size_t              *pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    )
+{
+    int tier = __atomic_load_n(&gKernel, __ATOMIC_ACQUIRE);
+
+    if (tier < 0) tier = KernelGetTier();
+    return gKernelTiers[tier].mFunc(pSched, pPhase, pIn, pOut, pLen);
+}
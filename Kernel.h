@@ -0,0 +1,98 @@
+/***************************************************************************************************************
+ * FILE: Kernel.h
+ *
+ * DESCRIPTION
+ * Vector kernels for the Vigenere cipher. Once the key schedule has been built (see Vigenere.h) encrypting and
+ * decrypting are the same operation: add the row of the key char to the column of the message char, mod n,
+ * for an alphabet of n chars. The kernels here do that for many chars at once. The mod n is done with a
+ * subtract and an unsigned minimum rather than a division, and chars outside the alphabet are blended back in
+ * unchanged, so the result is the same, char for char, as the table lookup in VigenereApply().
+ *
+ * When the alphabet is a range of bytes ('A'..'Z', 'a'..'z', ' '..'~', ...) the column of a char is the char
+ * minus the first char of the range. Otherwise (e.g., alphanumerics) the avx2 and avx512bw tiers look the
+ * column and the result up in the tables of the alphabet with byte shuffles. For the text alphabet, where the
+ * key advances only on letters, they find the key index of each lane with a prefix sum of the letter mask and
+ * pick its row from the key schedule with byte shuffles. The sse2 tier has no byte shuffle, and swar only
+ * handles ranges of at most 64 chars, so they leave those alphabets to VigenereApply(). The binary alphabet
+ * is the range of all 256 bytes, and n = 256 wraps to 0 in a byte, so the range arithmetic turns into a plain
+ * wrapping add for it; swar does that add directly.
+ *
+ * There is one kernel per tier of CPU. From slowest to fastest the tiers are,
+ *
+ *     scalar    No kernel at all. VigenereApply() does every char with the tabula recta.
+ *     swar      8 chars per 64-bit word ("SIMD within a register"). Works on any CPU.
+ *     sse2      16 chars per instruction. Every x86-64 CPU has SSE2.
+ *     avx2      32 chars per instruction.
+ *     avx512bw  64 chars per instruction. The final partial vector is done with a masked load/store.
+ *
+ * KernelBegin() asks the CPU (with cpuid) which instruction sets it supports and picks the fastest tier, once.
+ * KernelSelect() forces a particular tier, which is useful for benchmarking one tier against another. It may
+ * only be called before the first encryption/decryption; after that the tier is read by threads without a lock.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#ifndef _KERNEL_H_ /* Preprocessor guard to prevent Kernel.h from being included more than once */
+#define _KERNEL_H_ /* See comments in Main.h. */
+
+#include <stddef.h>    /* For size_t */
+#include "Types.h"     /* For bool */
+#include "Vigenere.h"  /* For VigenereSched */
+
+/*==============================================================================================================
+ * Global preprocessor macros.
+ *
+ * The tiers, from slowest to fastest, as returned by KernelGetTier(). Other modules with vector code of their
+ * own (see Armor.c) use the tier to follow KernelSelect().
+ *============================================================================================================*/
+#define KERNEL_SCALAR   (0)
+#define KERNEL_SWAR     (1)
+#define KERNEL_SSE2     (2)
+#define KERNEL_AVX2     (3)
+#define KERNEL_AVX512BW (4)
+
+/*==============================================================================================================
+ * Global function declarations.
+ *
+ * See comments in Main.h concerning what global function declarations are for.
+ *============================================================================================================*/
+extern void KernelBegin
+    (
+    );
+
+extern const char *KernelGetName
+    (
+    );
+
+extern int KernelGetTier
+    (
+    );
+
+extern bool KernelSelect
+    (
+    const char *pName
+    );
+
+extern size_t KernelVector
+    (
+    const VigenereSched *pSched,
+    size_t              *pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    );
+
+#endif /* __KERNEL_H__ */
@@ -20,8 +20,15 @@
  * -------------------------------------------------------------------------------------------------------------
  * 24 Jan 2012 [KRB] Initial revision.
  **************************************************************************************************************/
-#include "Model.h"  /* Good to always include the module header file. See comments in Globals.c. */
+#include "Analyze.h"   /* For ANALYZE_PERIOD_LEN */
+#include "Armor.h"     /* For ARMOR_NONE */
+#include "Globals.h"   /* For TERM_ERR_BUG */
+#include "Main.h"      /* For MainTerminate() */
+#include "Model.h"     /* Good to always include the module header file. See comments in Globals.c. */
+#include "String.h"    /* For memcpy(), strlen() */
+#include "Vigenere.h"  /* For VigenereCtxBegin(), VigenereCtxEnd(), VigenereCtxFuse() */
 #include <stdio.h>
+#include <stdlib.h>    /* For malloc(), free() */
 
 /*==============================================================================================================
  * Static global variables.
@@ -35,45 +42,243 @@
  * which permit to read and write the global variable. All accesses to global variables are made through the
  * appropriate accessor/mutator function.
  *
+ * The cipher itself does not need any of this. Everything an encryption needs is in a VigenereCtx (see
+ * Vigenere.h), which any code can create and pass around explicitly. mCtx is just the one context the command
+ * line program uses, built from mKey and mMode, and kept here for convenience.
+ *
  * Burger's Rule Concerning Global Variables: Don't, unless you have to. If you have to, do it they way I am
  * doing it here. You will make far fewer mistakes and introduce far fewer bugs into the code if you do it my
  * way. This is about as OO as you can get in a C program.
  *============================================================================================================*/
 struct {
-    char *mKey;          /* The encryption/decryption key */
+    VigenereAlpha mAlpha;  /* The alphabet (the -a option) */
+    bool  mAnalyze;      /* true to analyze the ciphertext rather than encrypt or decrypt it (analyze mode) */
+    int   mArmor;        /* The armor of the ciphertext (the --armor option), ARMOR_NONE if there is none */
+    char *mBatchFilename;  /* The name of the batch manifest (the -b option), or "" if not in batch mode */
+    char *mChain;        /* The second key (--chain or --rekey), a copy owned by the Model, or NULL if none */
+    char *mChainFilename;  /* The name of the file containing the second key, or "" if there is none */
+    size_t mChainLen;    /* The number of chars in mChain */
+    bool  mChainMode;    /* The mode the second key is applied in, VIGENERE_ENCRYPT or VIGENERE_DECRYPT */
+    bool  mContainer;    /* true if the ciphertext is a chunked container (the --container option) */
+    VigenereCtx mCtx;    /* The cipher context for mKey and mMode, and mChain, see ModelGetCtx() */
+    bool  mCtxValid;     /* true if mCtx has been built and the keys and modes have not changed since */
+    char *mInFilename;   /* The name of the file to read the message from (-i), or "" for stdin */
+    bool  mKasiski;      /* true to find the key length by Kasiski examination (the --kasiski option) */
+    char *mKey;          /* The encryption/decryption key, a copy owned by the Model */
+    size_t mKeyLen;      /* The number of chars in mKey, which may include NULs for the binary alphabet */
     char *mKeyFilename;  /* The name of the file containing the key */
+    size_t mLength;      /* The number of bytes to run (the --length option), (size_t)-1 for the rest */
+    size_t mMaxPeriod;   /* The longest key length analyze tries (the --max-period option) */
     bool  mMode;         /* mMode is VIGENERE_ENCRYPT or VIGENERE_DECRYPT */
+    char *mNgramFilename;  /* The corpus or table file of the quadgram solver (the --ngrams option), or "" */
+    bool  mNgrams;       /* true to compile an n-gram table file (the ngrams mode) */
+    size_t mOffset;      /* The byte offset of the input to start at (the --offset option) */
+    char *mOutFilename;  /* The name of the file to write the result to (-o), or "" for stdout */
+    size_t mPeriod;      /* The key length to recover the key for (the --period option), 0 to find it */
+    bool  mSplice;       /* true if streaming between pipes may use vmsplice (turned off by --no-splice) */
+    bool  mStream;       /* true if the message is streamed from stdin in blocks (the -s option) */
+    int   mThreads;      /* The number of worker threads (the -j option), 0 for one per CPU */
+    bool  mUring;        /* true if streaming may use io_uring (turned off by the --no-uring option) */
 } gModelDbase;
 
+/*==============================================================================================================
+ * Static function declarations.
+ *============================================================================================================*/
+static void ModelCtxReset();
+
 /*==============================================================================================================
  * Function definitions.
  *============================================================================================================*/
 
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelCtxReset
+ * DESCR:    Frees the cipher context, if it has been built, so that ModelGetCtx() builds it again from the
+ *           current key and mode.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void ModelCtxReset
+    (
+    )
+{
+    if (gModelDbase.mCtxValid) VigenereCtxEnd(&gModelDbase.mCtx);
+    gModelDbase.mCtxValid = false;
+}
+
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ModelBegin
- * DESCR:    Called to initialize the Model data base. Sets the alphabet, the key file name to "", and the
- *           mode to -1.
+ * DESCR:    Called to initialize the Model data base. Sets the alphabet to 'A'..'Z', the armor to none, the
+ *           key, batch, chain key, input, n-gram corpus, and output file names to "", the mode to -1, the range
+ *           to the whole input, turns analysis, Kasiski examination, compiling n-grams, the container, and
+ *           streaming off, sets the longest key length to analyze to ANALYZE_PERIOD_LEN, the key length to
+ *           recover the key for to 0 (found by the analysis), and the number of threads to 1, and allows
+ *           io_uring and vmsplice. There is no second key until ModelSetChainKeyBytes() is called.
  * RETURNS:  Nothing.
  *------------------------------------------------------------------------------------------------------------*/
 void ModelBegin
 	(
 	)
 {
+    ModelSetAlpha(NULL);
+    ModelSetAnalyze(false);
+    ModelSetArmor(ARMOR_NONE);
+    ModelSetBatchFilename("");
+    ModelSetChainFilename("");
+    ModelSetChainMode(VIGENERE_ENCRYPT);
+    ModelSetContainer(false);
+    ModelSetInFilename("");
+    ModelSetKasiski(false);
+    ModelSetKey("");
     ModelSetKeyFilename("");
+    ModelSetLength((size_t)-1);
+    ModelSetMaxPeriod(ANALYZE_PERIOD_LEN);
     ModelSetMode(-1);
+    ModelSetNgramFilename("");
+    ModelSetNgrams(false);
+    ModelSetOffset(0);
+    ModelSetOutFilename("");
+    ModelSetPeriod(0);
+    ModelSetSplice(true);
+    ModelSetStream(false);
+    ModelSetThreads(1);
+    ModelSetUring(true);
 }
 
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ModelEnd
- * DESCR:    Called to deallocate the Model data base.
+ * DESCR:    Called to deallocate the Model data base. Frees the copies of the keys and the cipher context.
  * RETURNS:  Nothing.
  *------------------------------------------------------------------------------------------------------------*/
 void ModelEnd
 	(
 	)
 {
-   /* gModelDbase.mKey=NULL;
-    gModelDbase.mKeyFilename=NULL;*/
+    ModelCtxReset();
+    free(gModelDbase.mKey);
+    gModelDbase.mKey = NULL;
+    free(gModelDbase.mChain);
+    gModelDbase.mChain = NULL;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetAlpha
+ * DESCR:    Returns the alphabet. Note: this is an accessor function for mAlpha.
+ * RETURNS:  A pointer to the alphabet, which stays valid until ModelSetAlpha() is called.
+ *------------------------------------------------------------------------------------------------------------*/
+const VigenereAlpha *ModelGetAlpha
+    (
+    )
+{
+    return &gModelDbase.mAlpha;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetAnalyze
+ * DESCR:    Returns the analyze flag. Note: this is an accessor function for mAnalyze.
+ * RETURNS:  true if the ciphertext is analyzed rather than encrypted or decrypted.
+ *------------------------------------------------------------------------------------------------------------*/
+bool ModelGetAnalyze
+    (
+    )
+{
+    return gModelDbase.mAnalyze;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetArmor
+ * DESCR:    Returns the armor of the ciphertext. Note: this is an accessor function for mArmor.
+ * RETURNS:  ARMOR_NONE, ARMOR_HEX, or ARMOR_BASE64.
+ *------------------------------------------------------------------------------------------------------------*/
+int ModelGetArmor
+    (
+    )
+{
+    return gModelDbase.mArmor;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetBatchFilename
+ * DESCR:    Returns the batch manifest file name. Note: this is an accessor function for mBatchFilename.
+ * RETURNS:  A C-string which is the name of the manifest, or "" if not in batch mode.
+ *------------------------------------------------------------------------------------------------------------*/
+char *ModelGetBatchFilename
+    (
+    )
+{
+    return gModelDbase.mBatchFilename;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetChainFilename
+ * DESCR:    Returns the name of the file of the second key. Note: this is an accessor function for
+ *           mChainFilename.
+ * RETURNS:  A C-string which is the file name of the second key file, or "" if there is no second key.
+ *------------------------------------------------------------------------------------------------------------*/
+char *ModelGetChainFilename
+    (
+    )
+{
+    return gModelDbase.mChainFilename;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetContainer
+ * DESCR:    Returns the container flag. Note: this is an accessor function for mContainer.
+ * RETURNS:  true if the ciphertext is a chunked container.
+ *------------------------------------------------------------------------------------------------------------*/
+bool ModelGetContainer
+    (
+    )
+{
+    return gModelDbase.mContainer;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetCtx
+ * DESCR:    Returns the cipher context for the key, mode, and alphabet. It is built the first time it is asked
+ *           for after the key, mode, or alphabet is set, with its stream offset at the start of the message. If
+ *           there is a second key, it is fused into the context (see VigenereCtxFuse()), so that one run
+ *           through the context applies the key in its mode and then the second key in its mode.
+ * RETURNS:  The context, or NULL if a key is empty or has a char that is not in the alphabet, the fused key
+ *           would be too long, or the context could not be allocated.
+ *------------------------------------------------------------------------------------------------------------*/
+VigenereCtx *ModelGetCtx
+    (
+    )
+{
+    if (!gModelDbase.mCtxValid) {
+        gModelDbase.mCtxValid = VigenereCtxBegin(&gModelDbase.mCtx, gModelDbase.mMode, gModelDbase.mKey,
+                                                 gModelDbase.mKeyLen, &gModelDbase.mAlpha);
+        if (gModelDbase.mCtxValid && gModelDbase.mChain &&
+            !VigenereCtxFuse(&gModelDbase.mCtx, gModelDbase.mChainMode, gModelDbase.mChain,
+                             gModelDbase.mChainLen)) {
+            ModelCtxReset();
+        }
+    }
+    return gModelDbase.mCtxValid ? &gModelDbase.mCtx : NULL;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetInFilename
+ * DESCR:    Returns the input file name string. Note: this is an accessor function for the mInFilename global.
+ * RETURNS:  A C-string which is the name of the input file, or "" if the message is read from stdin.
+ *------------------------------------------------------------------------------------------------------------*/
+char *ModelGetInFilename
+    (
+    )
+{
+    return gModelDbase.mInFilename;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetKasiski
+ * DESCR:    Returns the Kasiski flag. Note: this is an accessor function for mKasiski.
+ * RETURNS:  true if analyze finds the key length by Kasiski examination rather than by IoC.
+ *------------------------------------------------------------------------------------------------------------*/
+bool ModelGetKasiski
+    (
+    )
+{
+    return gModelDbase.mKasiski;
 }
 
 /*--------------------------------------------------------------------------------------------------------------
@@ -88,6 +293,18 @@ char *ModelGetKey
     return gModelDbase.mKey;
 }
 
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetKeyLen
+ * DESCR:    Returns the length of the key. Note: this is an accessor function for the mKeyLen global variable.
+ * RETURNS:  The number of chars in the key, which is strlen(ModelGetKey()) unless the key has NULs in it.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t ModelGetKeyLen
+    (
+    )
+{
+    return gModelDbase.mKeyLen;
+}
+
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ModelGetKeyFilename
  * DESCR:    Returns the key file name string. Note: this is an accessor function for the mKeyFilename global.
@@ -100,6 +317,30 @@ char *ModelGetKeyFilename
     return gModelDbase.mKeyFilename;
 }
 
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetLength
+ * DESCR:    Returns the length of the range to run. Note: this is an accessor function for mLength.
+ * RETURNS:  The number of bytes, or (size_t)-1 for the rest of the input.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t ModelGetLength
+    (
+    )
+{
+    return gModelDbase.mLength;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetMaxPeriod
+ * DESCR:    Returns the longest key length to try. Note: this is an accessor function for mMaxPeriod.
+ * RETURNS:  The longest key length the analysis tries.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t ModelGetMaxPeriod
+    (
+    )
+{
+    return gModelDbase.mMaxPeriod;
+}
+
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ModelGetMode
  * DESCR:    Returns the mode. Note: this is an accessor function for the mMode global variable.
@@ -112,9 +353,243 @@ bool ModelGetMode
     return gModelDbase.mMode;
 }
 
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetOffset
+ * DESCR:    Returns the byte offset of the range to run. Note: this is an accessor function for mOffset.
+ * RETURNS:  The byte offset, 0 if the whole input is run.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t ModelGetOffset
+    (
+    )
+{
+    return gModelDbase.mOffset;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetNgramFilename
+ * DESCR:    Returns the name of the n-gram corpus or table file. Note: this is an accessor function for
+ *           mNgramFilename.
+ * RETURNS:  A C-string which is the name of the n-gram file, or "" if analyze recovers the key by letter
+ *           frequencies.
+ *------------------------------------------------------------------------------------------------------------*/
+char *ModelGetNgramFilename
+    (
+    )
+{
+    return gModelDbase.mNgramFilename;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetNgrams
+ * DESCR:    Returns the ngrams flag. Note: this is an accessor function for mNgrams.
+ * RETURNS:  mNgrams.
+ *------------------------------------------------------------------------------------------------------------*/
+bool ModelGetNgrams
+    (
+    )
+{
+    return gModelDbase.mNgrams;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetOutFilename
+ * DESCR:    Returns the output file name string. Note: this is an accessor function for the mOutFilename
+ *           global.
+ * RETURNS:  A C-string which is the name of the output file, or "" if the result is written to stdout.
+ *------------------------------------------------------------------------------------------------------------*/
+char *ModelGetOutFilename
+    (
+    )
+{
+    return gModelDbase.mOutFilename;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetPeriod
+ * DESCR:    Returns the key length to recover the key for. Note: this is an accessor function for mPeriod.
+ * RETURNS:  The key length, or 0 if analyze is to find it.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t ModelGetPeriod
+    (
+    )
+{
+    return gModelDbase.mPeriod;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetSplice
+ * DESCR:    Returns the vmsplice flag. Note: this is an accessor function for mSplice.
+ * RETURNS:  true if streaming between pipes may use vmsplice.
+ *------------------------------------------------------------------------------------------------------------*/
+bool ModelGetSplice
+    (
+    )
+{
+    return gModelDbase.mSplice;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetStream
+ * DESCR:    Returns the streaming flag. Note: this is an accessor function for the mStream global variable.
+ * RETURNS:  true if the message is to be streamed.
+ *------------------------------------------------------------------------------------------------------------*/
+bool ModelGetStream
+    (
+    )
+{
+    return gModelDbase.mStream;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetThreads
+ * DESCR:    Returns the number of worker threads. Note: this is an accessor function for mThreads.
+ * RETURNS:  The number of worker threads, or 0 for one per CPU.
+ *------------------------------------------------------------------------------------------------------------*/
+int ModelGetThreads
+    (
+    )
+{
+    return gModelDbase.mThreads;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelGetUring
+ * DESCR:    Returns the io_uring flag. Note: this is an accessor function for mUring.
+ * RETURNS:  true if streaming may use io_uring.
+ *------------------------------------------------------------------------------------------------------------*/
+bool ModelGetUring
+    (
+    )
+{
+    return gModelDbase.mUring;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetAlpha
+ * DESCR:    Sets the alphabet to a copy of pAlpha, or to 'A'..'Z' if pAlpha is NULL. Note: this is a mutator
+ *           function for mAlpha.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetAlpha
+    (
+    const VigenereAlpha *pAlpha
+    )
+{
+    const char *upper = VigenereAlphaNamed(NULL);
+
+    if (pAlpha) gModelDbase.mAlpha = *pAlpha;
+    else VigenereAlphaBegin(&gModelDbase.mAlpha, upper, strlen(upper));
+    ModelCtxReset();
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetAnalyze
+ * DESCR:    Sets the analyze flag. Note: this is a mutator function for mAnalyze.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetAnalyze(bool pAnalyze)
+{
+    gModelDbase.mAnalyze = pAnalyze;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetArmor
+ * DESCR:    Sets the armor of the ciphertext. Note: this is a mutator function for mArmor.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetArmor(int pArmor)
+{
+    gModelDbase.mArmor = pArmor;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetBatchFilename
+ * DESCR:    Sets the batch manifest file name. Note: this is a mutator function for mBatchFilename.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetBatchFilename(char *pBatchFilename)
+{
+    gModelDbase.mBatchFilename = pBatchFilename;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetChainFilename
+ * DESCR:    Sets the name of the file of the second key. Note: this is a mutator function for mChainFilename.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetChainFilename(char *pChainFilename)
+{
+    gModelDbase.mChainFilename = pChainFilename;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetChainKeyBytes
+ * DESCR:    Sets the second key to the pLen chars of pKey, as ModelSetKeyBytes() does for the key. Note: this
+ *           is a mutator function for mChain and mChainLen. Fails and terminates with an error message if the
+ *           copy could not be allocated.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetChainKeyBytes
+    (
+    const char *pKey,
+    size_t      pLen
+    )
+{
+    char *key = malloc(pLen + 1);
+
+    if (!key) MainTerminate(TERM_ERR_BUG, "could not allocate the key.\n");
+    memcpy(key, pKey, pLen);
+    key[pLen] = '\0';
+    free(gModelDbase.mChain);
+    gModelDbase.mChain = key;
+    gModelDbase.mChainLen = pLen;
+    ModelCtxReset();
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetChainMode
+ * DESCR:    Sets the mode the second key is applied in. Note: this is a mutator function for mChainMode.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetChainMode(bool pChainMode)
+{
+    gModelDbase.mChainMode = pChainMode;
+    ModelCtxReset();
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetContainer
+ * DESCR:    Sets the container flag. Note: this is a mutator function for mContainer.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetContainer(bool pContainer)
+{
+    gModelDbase.mContainer = pContainer;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetInFilename
+ * DESCR:    Sets the input file name string. Note: this is a mutator function for mInFilename.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetInFilename(char *pInFilename)
+{
+    gModelDbase.mInFilename = pInFilename;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetKasiski
+ * DESCR:    Sets the Kasiski flag. Note: this is a mutator function for mKasiski.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetKasiski(bool pKasiski)
+{
+    gModelDbase.mKasiski = pKasiski;
+}
+
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ModelSetKey
- * DESCR:    Sets the key string. Note: this is a mutator function for mKey.
+ * DESCR:    Sets the key string. Note: this is a mutator function for mKey. See ModelSetKeyBytes().
  * RETURNS:  Nothing.
  *------------------------------------------------------------------------------------------------------------*/
 void ModelSetKey
@@ -122,8 +597,32 @@ void ModelSetKey
     char *pKey
     )
 {
-    /*should use string copy use here?*/
-    gModelDbase.mKey=pKey;
+    ModelSetKeyBytes(pKey, strlen(pKey));
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetKeyBytes
+ * DESCR:    Sets the key to the pLen chars of pKey, which may include NULs (a binary key). Note: this is a
+ *           mutator function for mKey and mKeyLen. The Model keeps its own copy of pKey, null-terminated, so
+ *           the caller's buffer may be reused, and the cipher context is rebuilt when next asked for. Fails and
+ *           terminates with an error message if the copy could not be allocated.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetKeyBytes
+    (
+    const char *pKey,
+    size_t      pLen
+    )
+{
+    char *key = malloc(pLen + 1);
+
+    if (!key) MainTerminate(TERM_ERR_BUG, "could not allocate the key.\n");
+    memcpy(key, pKey, pLen);
+    key[pLen] = '\0';
+    free(gModelDbase.mKey);
+    gModelDbase.mKey = key;
+    gModelDbase.mKeyLen = pLen;
+    ModelCtxReset();
 }
 
 /*--------------------------------------------------------------------------------------------------------------
@@ -136,12 +635,125 @@ void ModelSetKeyFilename(char *pKeyFilename)
     gModelDbase.mKeyFilename = pKeyFilename;
 }
 
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetLength
+ * DESCR:    Sets the length of the range to run. Note: this is a mutator function for mLength.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetLength(size_t pLength)
+{
+    gModelDbase.mLength = pLength;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetMaxPeriod
+ * DESCR:    Sets the longest key length to try. Note: this is a mutator function for mMaxPeriod.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetMaxPeriod(size_t pMaxPeriod)
+{
+    gModelDbase.mMaxPeriod = pMaxPeriod;
+}
+
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ModelSetMode
- * DESCR:    Sets the mode integer. Note: this is a mutator function for mMode.
+ * DESCR:    Sets the mode integer. Note: this is a mutator function for mMode. The cipher context is rebuilt
+ *           when next asked for.
  * RETURNS:  Nothing.
  *------------------------------------------------------------------------------------------------------------*/
 void ModelSetMode(bool pMode)
 {
     gModelDbase.mMode = pMode;
+    ModelCtxReset();
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetNgramFilename
+ * DESCR:    Sets the name of the n-gram corpus or table file. Note: this is a mutator function for
+ *           mNgramFilename.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetNgramFilename(char *pNgramFilename)
+{
+    gModelDbase.mNgramFilename = pNgramFilename;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetNgrams
+ * DESCR:    Sets the ngrams flag. Note: this is a mutator function for mNgrams.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetNgrams(bool pNgrams)
+{
+    gModelDbase.mNgrams = pNgrams;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetOffset
+ * DESCR:    Sets the byte offset of the range to run. Note: this is a mutator function for mOffset.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetOffset(size_t pOffset)
+{
+    gModelDbase.mOffset = pOffset;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetOutFilename
+ * DESCR:    Sets the output file name string. Note: this is a mutator function for mOutFilename.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetOutFilename(char *pOutFilename)
+{
+    gModelDbase.mOutFilename = pOutFilename;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetPeriod
+ * DESCR:    Sets the key length to recover the key for. Note: this is a mutator function for mPeriod.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetPeriod(size_t pPeriod)
+{
+    gModelDbase.mPeriod = pPeriod;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetSplice
+ * DESCR:    Sets the vmsplice flag. Note: this is a mutator function for mSplice.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetSplice(bool pSplice)
+{
+    gModelDbase.mSplice = pSplice;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetStream
+ * DESCR:    Sets the streaming flag. Note: this is a mutator function for mStream.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetStream(bool pStream)
+{
+    gModelDbase.mStream = pStream;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetThreads
+ * DESCR:    Sets the number of worker threads. Note: this is a mutator function for mThreads.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetThreads(int pThreads)
+{
+    gModelDbase.mThreads = pThreads;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ModelSetUring
+ * DESCR:    Sets the io_uring flag. Note: this is a mutator function for mUring.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void ModelSetUring(bool pUring)
+{
+    gModelDbase.mUring = pUring;
 }
@@ -23,7 +23,8 @@
 #ifndef _MODEL_H_ /* Preprocessor guard to prevent Model.h from being included more than once */
 #define _MODEL_H_ /* See comments in Main.h. */
 
-#include "Types.h" /* For bool */
+#include "Types.h"    /* For bool */
+#include "Vigenere.h" /* For VigenereAlpha, VigenereCtx */
 
 /*==============================================================================================================
  * Global function declarations.
@@ -38,31 +39,227 @@ extern void ModelEnd
     (
     );
 
+extern const VigenereAlpha *ModelGetAlpha
+    (
+    );
+
+extern bool ModelGetAnalyze
+    (
+    );
+
+extern int ModelGetArmor
+    (
+    );
+
+extern char *ModelGetBatchFilename
+    (
+    );
+
+extern char *ModelGetChainFilename
+    (
+    );
+
+extern bool ModelGetContainer
+    (
+    );
+
+extern VigenereCtx *ModelGetCtx
+    (
+    );
+
+extern char *ModelGetInFilename
+    (
+    );
+
+extern bool ModelGetKasiski
+    (
+    );
+
 extern char *ModelGetKey
     (
     );
 
+extern size_t ModelGetKeyLen
+    (
+    );
+
 extern char *ModelGetKeyFilename
     (
     );
 
+extern size_t ModelGetLength
+    (
+    );
+
+extern size_t ModelGetMaxPeriod
+    (
+    );
+
 extern bool ModelGetMode
     (
     );
 
+extern char *ModelGetNgramFilename
+    (
+    );
+
+extern bool ModelGetNgrams
+    (
+    );
+
+extern size_t ModelGetOffset
+    (
+    );
+
+extern char *ModelGetOutFilename
+    (
+    );
+
+extern size_t ModelGetPeriod
+    (
+    );
+
+extern bool ModelGetSplice
+    (
+    );
+
+extern bool ModelGetStream
+    (
+    );
+
+extern int ModelGetThreads
+    (
+    );
+
+extern bool ModelGetUring
+    (
+    );
+
+extern void ModelSetAlpha
+    (
+    const VigenereAlpha *pAlpha
+    );
+
+extern void ModelSetAnalyze
+    (
+    bool pAnalyze
+    );
+
+extern void ModelSetArmor
+    (
+    int pArmor
+    );
+
+extern void ModelSetBatchFilename
+    (
+    char *pBatchFilename
+    );
+
+extern void ModelSetChainFilename
+    (
+    char *pChainFilename
+    );
+
+extern void ModelSetChainKeyBytes
+    (
+    const char *pKey,
+    size_t      pLen
+    );
+
+extern void ModelSetChainMode
+    (
+    bool pChainMode
+    );
+
+extern void ModelSetContainer
+    (
+    bool pContainer
+    );
+
+extern void ModelSetInFilename
+    (
+    char *pInFilename
+    );
+
+extern void ModelSetKasiski
+    (
+    bool pKasiski
+    );
+
 extern void ModelSetKey
     (
     char *pKey
     );
 
+extern void ModelSetKeyBytes
+    (
+    const char *pKey,
+    size_t      pLen
+    );
+
 extern void ModelSetKeyFilename
     (
     char *pKeyfilename
     );
 
+extern void ModelSetLength
+    (
+    size_t pLength
+    );
+
+extern void ModelSetMaxPeriod
+    (
+    size_t pMaxPeriod
+    );
+
 extern void ModelSetMode
     (
     bool pMode
     );
 
+extern void ModelSetNgramFilename
+    (
+    char *pNgramFilename
+    );
+
+extern void ModelSetNgrams
+    (
+    bool pNgrams
+    );
+
+extern void ModelSetOffset
+    (
+    size_t pOffset
+    );
+
+extern void ModelSetOutFilename
+    (
+    char *pOutFilename
+    );
+
+extern void ModelSetPeriod
+    (
+    size_t pPeriod
+    );
+
+extern void ModelSetSplice
+    (
+    bool pSplice
+    );
+
+extern void ModelSetStream
+    (
+    bool pStream
+    );
+
+extern void ModelSetThreads
+    (
+    int pThreads
+    );
+
+extern void ModelSetUring
+    (
+    bool pUring
+    );
+
 #endif /* __MODEL_H__ */
@@ -0,0 +1,250 @@
+/***************************************************************************************************************
+ * FILE: Ngram.c
+ *
+ * DESCRIPTION
+ * See comments in Ngram.h.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>     /* For toupper() */
+#include <math.h>      /* For log10() */
+#include <stdint.h>    /* For uint32_t */
+#include <stdlib.h>    /* For calloc(), free(), malloc(), posix_memalign() */
+#include <string.h>    /* For memcmp(), memcpy(), memset() */
+#include "File.h"      /* For FileClose(), FileMapNew(), FileMapRandom(), FileOpenRead(), FileUnmap() */
+#include "Globals.h"   /* For TERM_ERR_ANALYZE, TERM_ERR_BUG, TERM_ERR_FILE */
+#include "Main.h"      /* For MainTerminate() */
+#include "Ngram.h"     /* Good to always include the module header file. See comments in Globals.c. */
+#include "Stream.h"    /* For StreamFill() */
+
+/*==============================================================================================================
+ * Preprocessor macros.
+ *
+ * NGRAM_BLOCK_LEN is the number of bytes of the corpus that are read at a time. NGRAM_MAGIC starts a table
+ * file, and NGRAM_CHECK is stored after the number of letters to tell the byte order (see Ngram.h).
+ *============================================================================================================*/
+#define NGRAM_BLOCK_LEN (1 << 16)
+#define NGRAM_CHECK     (1.0f)
+#define NGRAM_MAGIC     "VGNRNGR1"
+#define NGRAM_MAGIC_LEN (8)
+
+/*==============================================================================================================
+ * Static function declarations.
+ *============================================================================================================*/
+static void NgramCount(NgramTable *pTable, char *pFilename);
+static size_t NgramOffset(int pOrder);
+static void NgramPoint(NgramTable *pTable);
+
+/*==============================================================================================================
+ * Function definitions.
+ *============================================================================================================*/
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: NgramBegin
+ *
+ * DESCR:    Loads the tables of pTable from the file named pFilename: a table file (see Ngram.h) is mapped, and
+ *           any other file is taken to be a corpus of English text and counted. Fails and terminates with an
+ *           error message if the file could not be read, a table file is not whole or has another byte order,
+ *           or a corpus has no quadgram.
+ *
+ * RETURNS:  Nothing. The caller frees the tables with NgramEnd().
+ *------------------------------------------------------------------------------------------------------------*/
+void NgramBegin
+    (
+    NgramTable *pTable,
+    char       *pFilename
+    )
+{
+    size_t len;
+    char *base = FileMapRandom(pFilename, &len);
+    uint32_t letters;
+    float check;
+
+    if (len < NGRAM_ALIGN || memcmp(base, NGRAM_MAGIC, NGRAM_MAGIC_LEN) != 0) {
+        FileUnmap(base, len);
+        NgramCount(pTable, pFilename);
+        return;
+    }
+    memcpy(&letters, base + NGRAM_MAGIC_LEN, sizeof(letters));
+    memcpy(&check, base + NGRAM_MAGIC_LEN + sizeof(letters), sizeof(check));
+    if (len != NgramOffset(NGRAM_ORDERS + 1) || letters != NGRAM_LETTERS || check != NGRAM_CHECK) {
+        MainTerminate(TERM_ERR_FILE, "n-gram table '%s' is damaged or was built on a CPU with another byte "
+                      "order.\n", pFilename);
+    }
+    pTable->mBase = base;
+    pTable->mLen = len;
+    pTable->mMapped = true;
+    NgramPoint(pTable);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: NgramCount
+ *
+ * DESCR:    Builds the tables of pTable from the corpus, the English text in the file named pFilename (see
+ *           Ngram.h), in memory laid out like a table file, header and all, so that it can be written out as it
+ *           is by NgramWrite(). The counts are 32-bit, so the corpus should have fewer than 2^32 letters. Fails
+ *           and terminates with an error message if the file could not be read, the memory could not be
+ *           allocated, or the corpus has no quadgram.
+ *
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void NgramCount(NgramTable *pTable, char *pFilename)
+{
+    size_t first[NGRAM_ORDERS], i, k, len = NgramOffset(NGRAM_ORDERS + 1), mod, run = 0;
+    uint32_t *counts = calloc((len - NGRAM_ALIGN) / sizeof(float), sizeof(*counts)), code = 0;
+    uint32_t letters = NGRAM_LETTERS;
+    char *buf = malloc(NGRAM_BLOCK_LEN);
+    double total[NGRAM_ORDERS];
+    float check = NGRAM_CHECK, *table;
+    void *base = NULL;
+    int fd = FileOpenRead(pFilename), c;
+
+    if (!counts || !buf || posix_memalign(&base, NGRAM_ALIGN, len) != 0) {
+        MainTerminate(TERM_ERR_BUG, "could not allocate the n-gram table.\n");
+    }
+    for (k = 0; k < NGRAM_ORDERS; ++k) {
+        first[k] = (NgramOffset((int)k + 1) - NGRAM_ALIGN) / sizeof(float);
+        total[k] = 0.0;
+    }
+
+    /* code is the number of the last four letters in base 26; the last k of them are code mod 26^k. */
+    while ((len = StreamFill(fd, buf, NGRAM_BLOCK_LEN)) > 0) {
+        for (i = 0; i < len; ++i) {
+            c = toupper((unsigned char)buf[i]);
+            if (c < 'A' || c > 'Z') continue;
+            code = (code * NGRAM_LETTERS + (uint32_t)(c - 'A')) % NGRAM_QUADS;
+            if (run < NGRAM_ORDERS) ++run;
+            for (k = 0, mod = NGRAM_LETTERS; k < run; ++k, mod *= NGRAM_LETTERS) {
+                ++counts[first[k] + code % mod];
+                total[k] += 1.0;
+            }
+        }
+    }
+    FileClose(fd);
+    if (total[NGRAM_ORDERS - 1] == 0.0) {
+        MainTerminate(TERM_ERR_ANALYZE, "n-gram corpus '%s' has no quadgrams.\n", pFilename);
+    }
+    pTable->mBase = base;
+    pTable->mLen = NgramOffset(NGRAM_ORDERS + 1);
+    pTable->mMapped = false;
+    memset(pTable->mBase, 0, pTable->mLen);
+    memcpy(pTable->mBase, NGRAM_MAGIC, NGRAM_MAGIC_LEN);
+    memcpy(pTable->mBase + NGRAM_MAGIC_LEN, &letters, sizeof(letters));
+    memcpy(pTable->mBase + NGRAM_MAGIC_LEN + sizeof(letters), &check, sizeof(check));
+    for (k = 0, mod = NGRAM_LETTERS; k < NGRAM_ORDERS; ++k, mod *= NGRAM_LETTERS) {
+        table = (float *)(pTable->mBase + NgramOffset((int)k + 1));
+        for (i = 0; i < mod; ++i) {
+            table[i] = (float)log10((counts[first[k] + i] ? counts[first[k] + i] : NGRAM_FLOOR) / total[k]);
+        }
+    }
+    free(buf);
+    free(counts);
+    NgramPoint(pTable);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: NgramEnd
+ * DESCR:    Unmaps the table file of pTable, or frees the memory of its tables.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void NgramEnd
+    (
+    NgramTable *pTable
+    )
+{
+    if (pTable->mMapped) FileUnmap(pTable->mBase, pTable->mLen);
+    else free(pTable->mBase);
+    memset(pTable, 0, sizeof(*pTable));
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: NgramLetters
+ * DESCR:    Maps the alphabet pAlpha to the letters of the quadgram table: pLetters[i] is 0 for 'A' to 25 for
+ *           'Z' for the char at index i, of either case. The table only fits an alphabet that is the 26
+ *           letters, in any order and of either case, e.g., the default alphabet, the text alphabet, or lower.
+ * RETURNS:  true if pAlpha is such an alphabet, false if it is not.
+ *------------------------------------------------------------------------------------------------------------*/
+bool NgramLetters
+    (
+    const VigenereAlpha *pAlpha,
+    unsigned char       *pLetters
+    )
+{
+    bool seen[NGRAM_LETTERS];
+    size_t i;
+    int c;
+
+    if (pAlpha->mLen != NGRAM_LETTERS) return false;
+    memset(seen, 0, sizeof(seen));
+    for (i = 0; i < NGRAM_LETTERS; ++i) {
+        c = toupper(pAlpha->mChar[i]);
+        if (c < 'A' || c > 'Z' || seen[c - 'A']) return false;
+        seen[c - 'A'] = true;
+        pLetters[i] = (unsigned char)(c - 'A');
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: NgramOffset
+ * DESCR:    Lays out a table file (see Ngram.h): the header, then the table of each order from 1 to
+ *           NGRAM_ORDERS, each starting on a multiple of NGRAM_ALIGN bytes.
+ * RETURNS:  The byte offset of the table of order pOrder, or the length of the file for NGRAM_ORDERS + 1.
+ *------------------------------------------------------------------------------------------------------------*/
+static size_t NgramOffset(int pOrder)
+{
+    size_t offset = NGRAM_ALIGN, entries = NGRAM_LETTERS;
+    int k;
+
+    for (k = 1; k < pOrder; ++k, entries *= NGRAM_LETTERS) {
+        offset += (entries * sizeof(float) + NGRAM_ALIGN - 1) / NGRAM_ALIGN * NGRAM_ALIGN;
+    }
+    return offset;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: NgramPoint
+ * DESCR:    Points the tables of pTable into mBase.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void NgramPoint(NgramTable *pTable)
+{
+    pTable->mUni = (const float *)(pTable->mBase + NgramOffset(1));
+    pTable->mBi = (const float *)(pTable->mBase + NgramOffset(2));
+    pTable->mTri = (const float *)(pTable->mBase + NgramOffset(3));
+    pTable->mQuad = (const float *)(pTable->mBase + NgramOffset(4));
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: NgramWrite
+ * DESCR:    Writes the tables of pTable to a table file named pFilename (see Ngram.h), which NgramBegin() can
+ *           then map. Fails and terminates with an error message if the file could not be written.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void NgramWrite
+    (
+    const NgramTable *pTable,
+    char             *pFilename
+    )
+{
+    char *out = FileMapNew(pFilename, pTable->mLen);
+
+    memcpy(out, pTable->mBase, pTable->mLen);
+    FileUnmap(out, pTable->mLen);
+}
@@ -0,0 +1,109 @@
+/***************************************************************************************************************
+ * FILE: Ngram.h
+ *
+ * DESCRIPTION
+ * The n-gram statistics of English that the quadgram solver of analyze mode scores a candidate plaintext with
+ * (the --ngrams option, see AnalyzeClimb()). A quadgram is four consecutive letters, and the log probability
+ * of a text is the sum of the log probabilities of its quadgrams, so a text that reads like English scores far
+ * higher than one that does not, even when the letter frequencies of the two are the same.
+ *
+ * NgramBegin() counts the unigrams, bigrams, trigrams, and quadgrams of an English text file, the corpus, and
+ * turns the counts into dense tables of base 10 log probabilities, one for each order k, of 26^k floats indexed
+ * by the n-gram as a k-digit number in base 26. The letters are counted without regard to case and every other
+ * char is skipped, so an n-gram may span a space or a line break, as it does in a ciphertext that has its
+ * spaces removed. An n-gram that never occurs in the corpus is given the log probability of NGRAM_FLOOR
+ * occurrences rather than minus infinity, so that one rare quadgram does not rule a plaintext out.
+ *
+ * Counting a large corpus takes longer than the analysis, so NgramWrite() saves the tables to a table file (the
+ * ngrams mode of the vigenere program, or "make corpus.ngr"), and NgramBegin() given a table file maps it
+ * instead of counting. The file is the tables exactly as they are used, in the byte order of the CPU it was
+ * built on:
+ *
+ *     header        64 bytes       "VGNRNGR1", number of letters (4), 1.0 as a float (4), zeros
+ *     order k       26^k floats    the log probability of each k-gram, for k = 1 to 4
+ *
+ * Each table starts on a multiple of NGRAM_ALIGN bytes, a cache line, with zeros between. The file is mapped
+ * read-only and shared, so it is ready as soon as it is mapped, only the pages of the table that a solve looks
+ * up are ever read from disk, and every process that analyzes at once uses the one copy in the page cache.
+ * The 1.0 is how a file built on a CPU with another byte order is told apart, and it is rejected.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#ifndef _NGRAM_H_ /* Preprocessor guard to prevent Ngram.h from being included more than once */
+#define _NGRAM_H_ /* See comments in Main.h. */
+
+#include <stddef.h>    /* For size_t */
+#include "Types.h"     /* For bool */
+#include "Vigenere.h"  /* For VigenereAlpha */
+
+/*==============================================================================================================
+ * Global preprocessor macros.
+ *
+ * NGRAM_ORDERS is the number of tables, unigrams to quadgrams.
+ *============================================================================================================*/
+#define NGRAM_ALIGN   (64)
+#define NGRAM_FLOOR   (0.01)
+#define NGRAM_LETTERS (26)
+#define NGRAM_ORDERS  (4)
+#define NGRAM_QUADS   (NGRAM_LETTERS * NGRAM_LETTERS * NGRAM_LETTERS * NGRAM_LETTERS)
+
+/*==============================================================================================================
+ * Global type definitions.
+ *
+ * An NgramTable is the tables of one corpus, laid out in memory exactly as in a table file (see above), either
+ * in the mapped file or in memory of its own. mQuad[((a * 26 + b) * 26 + c) * 26 + d] is the log probability of
+ * the quadgram of letters a, b, c, and d, each 0 for 'A' to 25 for 'Z', and likewise for the other orders.
+ *============================================================================================================*/
+typedef struct {
+    char        *mBase;    /* The header and the tables, NGRAM_ALIGN-aligned */
+    size_t       mLen;     /* The number of bytes at mBase, the length of a table file */
+    bool         mMapped;  /* true if mBase is a mapped table file, false if it was allocated and counted */
+    const float *mUni;     /* The log probability of each unigram, NGRAM_LETTERS entries */
+    const float *mBi;      /* The log probability of each bigram */
+    const float *mTri;     /* The log probability of each trigram */
+    const float *mQuad;    /* The log probability of each quadgram, NGRAM_QUADS entries */
+} NgramTable;
+
+/*==============================================================================================================
+ * Global function declarations.
+ *
+ * See comments in Main.h concerning what global function declarations are for.
+ *============================================================================================================*/
+extern void NgramBegin
+    (
+    NgramTable *pTable,
+    char       *pFilename
+    );
+
+extern void NgramEnd
+    (
+    NgramTable *pTable
+    );
+
+extern bool NgramLetters
+    (
+    const VigenereAlpha *pAlpha,
+    unsigned char       *pLetters
+    );
+
+extern void NgramWrite
+    (
+    const NgramTable *pTable,
+    char             *pFilename
+    );
+
+#endif /* __NGRAM_H__ */
@@ -0,0 +1,481 @@
+/***************************************************************************************************************
+ * FILE: Pool.c
+ *
+ * DESCRIPTION
+ * See comments in Pool.h.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+
+/*
+ * POSIX threads are not ANSI C, so with -ansi they are not declared unless we ask for them. This must come
+ * before any #include.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>   /* For pthread_create(), pthread_join(), pthread_key_t, pthread_mutex_t, ... */
+#include <stdlib.h>    /* For malloc(), calloc(), free() */
+#include <unistd.h>    /* For sysconf() */
+#include "Globals.h"   /* For TERM_ERR_BUG */
+#include "Main.h"      /* For MainTerminate() */
+#include "Pool.h"      /* Good to always include the module header file. See comments in Globals.c. */
+
+/*==============================================================================================================
+ * Static global variables.
+ *
+ * Each worker thread has its own deque (double-ended queue) of tasks, a growable circular array of mCap
+ * entries of which mCount, starting at mTop, are in use. A worker pushes the tasks it submits onto the bottom
+ * of its own deque and pops them from the bottom, so it keeps working on what it just split off, which is
+ * still in its cache. A worker whose deque is empty steals from the top of another worker's deque, i.e., it
+ * takes the oldest task, which is usually the biggest piece of work left. Tasks submitted by a thread that is
+ * not a worker are dealt out to the deques in turn. Each deque is protected by its own mLock, so workers only
+ * contend when one is stealing from another.
+ *
+ * mQueued counts the tasks in all of the deques, and the mPending of each group the tasks of the group that
+ * have been submitted but not yet finished; both are updated atomically. A worker that finds nothing to do
+ * sleeps on mWork, and PoolWait() sleeps on mDone for the mPending of its group to drop to 0. Both sleep under
+ * mLock, which is taken by submitters and workers only to wake them up.
+ *
+ * POOL_MIN_SLICE is the smallest slice of a buffer that PoolApply() will hand to a thread. Below that the cost
+ * of waking a thread is more than the cost of the kernel.
+ *============================================================================================================*/
+#define POOL_MIN_SLICE (64 * 1024)
+
+typedef struct {
+    PoolTask   mTask;   /* The function to run */
+    void      *mArg;    /* The argument to pass to it */
+    PoolGroup *mGroup;  /* The group the task belongs to */
+} PoolEntry;
+
+typedef struct {
+    pthread_mutex_t  mLock;   /* Protects everything below */
+    PoolEntry       *mQueue;  /* The circular array of tasks */
+    size_t           mCap;    /* The number of entries in mQueue */
+    size_t           mTop;    /* The index of the oldest task, the one that is stolen next */
+    size_t           mCount;  /* The number of tasks in mQueue */
+} PoolDeque;
+
+static struct {
+    pthread_mutex_t  mLock;     /* Protects mEnding, and is held while waiting on mWork or mDone */
+    pthread_cond_t   mWork;     /* Signaled when a task is queued or the pool is ending */
+    pthread_cond_t   mDone;     /* Signaled when the mPending of a group drops to 0 */
+    pthread_key_t    mSelf;     /* In a worker thread, a pointer to its own PoolDeque */
+    pthread_t       *mThreads;  /* The worker threads */
+    PoolDeque       *mDeques;   /* One deque per worker thread */
+    int              mNum;      /* The number of worker threads, 0 if the pool has not been started */
+    size_t           mNext;     /* The deque that the next task from a non-worker thread is dealt to */
+    size_t           mQueued;   /* The number of tasks in all of the deques */
+    bool             mEnding;   /* true when PoolEnd() is telling the workers to exit */
+} gPool = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER };
+
+/*
+ * A PoolSlice is the argument of PoolApplyTask(): one thread's share of the buffer passed to PoolApply().
+ */
+typedef struct {
+    const VigenereSched *mSched;  /* The key schedule */
+    size_t               mPhase;  /* The key index of mIn[0] */
+    const char          *mIn;     /* The first input byte of the slice */
+    char                *mOut;    /* The first output byte of the slice */
+    size_t               mLen;    /* The number of bytes in the slice */
+    size_t               mCount;  /* How far the key advances over the slice, see PoolCountTask() */
+} PoolSlice;
+
+/*==============================================================================================================
+ * Static function declarations.
+ *============================================================================================================*/
+static void PoolApplyTask(void *pArg);
+static void PoolCountTask(void *pArg);
+static bool PoolPop(PoolDeque *pDeque, PoolEntry *pEntry);
+static void PoolPush(PoolDeque *pDeque, const PoolEntry *pEntry);
+static void PoolRun(const PoolEntry *pEntry);
+static bool PoolSteal(PoolDeque *pDeque, PoolEntry *pEntry);
+static bool PoolTake(PoolDeque *pSelf, PoolEntry *pEntry);
+static void *PoolWorker(void *pArg);
+
+/*==============================================================================================================
+ * Function definitions.
+ *============================================================================================================*/
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolApply
+ * DESCR:    Same as VigenereApply(), but the buffer is split into slices which are run on the worker threads.
+ *           Slice s starts at byte offset o and key index (pPhase + o) % (key length). Each slice is a multiple
+ *           of 64 bytes long (except the last) so that every thread runs whole vectors. If the pool has only
+ *           one thread, or the buffer is too small to be worth splitting, VigenereApply() is called directly.
+ *
+ *           For the text alphabet the key advances only on letters, so the key index of a slice is pPhase plus
+ *           the number of letters in the slices before it. Those are counted first, in parallel, by one
+ *           PoolCountTask() per slice, and then the slices are run as above.
+ * RETURNS:  The key index of the byte following pIn[pLen-1].
+ *------------------------------------------------------------------------------------------------------------*/
+size_t PoolApply
+    (
+    const VigenereSched *pSched,
+    size_t               pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    )
+{
+    size_t n = pLen / POOL_MIN_SLICE, len, off, s, phase = pPhase;
+    PoolGroup pending = { 0 };
+    PoolSlice *slices;
+
+    if (n > (size_t)PoolGetThreads()) n = PoolGetThreads();
+    if (n < 2) return VigenereApply(pSched, pPhase, pIn, pOut, pLen);
+    slices = malloc(n * sizeof(PoolSlice));
+    if (!slices) return VigenereApply(pSched, pPhase, pIn, pOut, pLen);
+    /* Round the ceiling of pLen / n up, so that the slices never number more than the n allocated. */
+    len = ((pLen + n - 1) / n + 63) & ~(size_t)63;
+    n = (pLen + len - 1) / len;
+    for (s = 0, off = 0; s < n; ++s, off += len) {
+        slices[s].mSched = pSched;
+        slices[s].mIn    = pIn + off;
+        slices[s].mOut   = pOut + off;
+        slices[s].mLen   = s < n - 1 ? len : pLen - off;
+        slices[s].mCount = slices[s].mLen;
+        if (pSched->mAlpha.mText) PoolSubmit(&pending, PoolCountTask, &slices[s]);
+    }
+    PoolWait(&pending);
+    for (s = 0; s < n; ++s) {
+        slices[s].mPhase = phase;
+        phase = (phase + slices[s].mCount) % pSched->mLen;
+        PoolSubmit(&pending, PoolApplyTask, &slices[s]);
+    }
+    PoolWait(&pending);
+    free(slices);
+    return phase;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolApplyTask
+ * DESCR:    The task run by a worker thread for one slice of PoolApply().
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void PoolApplyTask
+    (
+    void *pArg
+    )
+{
+    PoolSlice *slice = pArg;
+
+    VigenereApply(slice->mSched, slice->mPhase, slice->mIn, slice->mOut, slice->mLen);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolBegin
+ * DESCR:    Starts pThreads worker threads, each with an empty deque. If pThreads is 0, one thread is started
+ *           per online CPU. Fails and terminates with an error message if a thread could not be started.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void PoolBegin
+    (
+    int pThreads
+    )
+{
+    int i;
+
+    if (pThreads <= 0) pThreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (pThreads <= 0) pThreads = 1;
+    gPool.mThreads = malloc(pThreads * sizeof(pthread_t));
+    gPool.mDeques = calloc(pThreads, sizeof(PoolDeque));
+    if (!gPool.mThreads || !gPool.mDeques || pthread_key_create(&gPool.mSelf, NULL) != 0) {
+        MainTerminate(TERM_ERR_BUG, "could not allocate the thread pool.\n");
+    }
+    for (i = 0; i < pThreads; ++i) pthread_mutex_init(&gPool.mDeques[i].mLock, NULL);
+    gPool.mEnding = false;
+    gPool.mNext = 0;
+    for (i = 0; i < pThreads; ++i) {
+        if (pthread_create(&gPool.mThreads[i], NULL, PoolWorker, &gPool.mDeques[i]) != 0) {
+            MainTerminate(TERM_ERR_BUG, "could not start worker thread %d.\n", i);
+        }
+        gPool.mNum = i + 1;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolCountTask
+ * DESCR:    The task run by a worker thread to count how far the key advances over one slice of PoolApply().
+ * RETURNS:  Nothing. The count is stored in the slice.
+ *------------------------------------------------------------------------------------------------------------*/
+static void PoolCountTask
+    (
+    void *pArg
+    )
+{
+    PoolSlice *slice = pArg;
+
+    slice->mCount = VigenereAdvance(slice->mSched, slice->mIn, slice->mLen);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolEnd
+ * DESCR:    Tells the worker threads to exit once every deque is empty and waits for them. Does nothing if the
+ *           pool was never started.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void PoolEnd
+    (
+    )
+{
+    int i, num;
+
+    pthread_mutex_lock(&gPool.mLock);
+    gPool.mEnding = true;
+    num = gPool.mNum;
+    pthread_cond_broadcast(&gPool.mWork);
+    pthread_mutex_unlock(&gPool.mLock);
+    if (num == 0) return;
+    for (i = 0; i < num; ++i) pthread_join(gPool.mThreads[i], NULL);
+    for (i = 0; i < num; ++i) {
+        pthread_mutex_destroy(&gPool.mDeques[i].mLock);
+        free(gPool.mDeques[i].mQueue);
+    }
+    pthread_key_delete(gPool.mSelf);
+    free(gPool.mThreads);
+    free(gPool.mDeques);
+    gPool.mThreads = NULL;
+    gPool.mDeques = NULL;
+    gPool.mNum = 0;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolGetThreads
+ * DESCR:    Returns the number of worker threads.
+ * RETURNS:  The number of worker threads, or 1 if the pool has not been started (the calling thread does the
+ *           work itself in that case).
+ *------------------------------------------------------------------------------------------------------------*/
+int PoolGetThreads
+    (
+    )
+{
+    return gPool.mNum > 0 ? gPool.mNum : 1;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolPop
+ * DESCR:    Takes the newest task off the bottom of pDeque. Only the worker that owns pDeque pops from it.
+ * RETURNS:  true if there was a task, which is returned in *pEntry.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool PoolPop
+    (
+    PoolDeque *pDeque,
+    PoolEntry *pEntry
+    )
+{
+    bool found;
+
+    pthread_mutex_lock(&pDeque->mLock);
+    found = pDeque->mCount > 0;
+    if (found) *pEntry = pDeque->mQueue[(pDeque->mTop + --pDeque->mCount) % pDeque->mCap];
+    pthread_mutex_unlock(&pDeque->mLock);
+    return found;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolPush
+ * DESCR:    Puts the task pEntry on the bottom of pDeque, growing it if it is full. Fails and terminates with
+ *           an error message if it could not be grown.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void PoolPush
+    (
+    PoolDeque       *pDeque,
+    const PoolEntry *pEntry
+    )
+{
+    pthread_mutex_lock(&pDeque->mLock);
+    if (pDeque->mCount == pDeque->mCap) {
+        size_t cap = pDeque->mCap ? 2 * pDeque->mCap : 64, i;
+        PoolEntry *queue = malloc(cap * sizeof(PoolEntry));
+        if (!queue) MainTerminate(TERM_ERR_BUG, "could not grow the task queue.\n");
+        for (i = 0; i < pDeque->mCount; ++i) queue[i] = pDeque->mQueue[(pDeque->mTop + i) % pDeque->mCap];
+        free(pDeque->mQueue);
+        pDeque->mQueue = queue;
+        pDeque->mCap = cap;
+        pDeque->mTop = 0;
+    }
+    pDeque->mQueue[(pDeque->mTop + pDeque->mCount) % pDeque->mCap] = *pEntry;
+    ++pDeque->mCount;
+    pthread_mutex_unlock(&pDeque->mLock);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolRun
+ * DESCR:    Runs the task pEntry, which has been taken off a deque, on the calling worker thread, and wakes the
+ *           threads waiting in PoolWait() if it was the last unfinished task of its group.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void PoolRun
+    (
+    const PoolEntry *pEntry
+    )
+{
+    __atomic_sub_fetch(&gPool.mQueued, 1, __ATOMIC_SEQ_CST);
+    pEntry->mTask(pEntry->mArg);
+
+    /* The group may be gone as soon as its count is 0, so it is not touched after that. */
+    if (__atomic_sub_fetch(&pEntry->mGroup->mPending, 1, __ATOMIC_SEQ_CST) == 0) {
+        pthread_mutex_lock(&gPool.mLock);
+        pthread_cond_broadcast(&gPool.mDone);
+        pthread_mutex_unlock(&gPool.mLock);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolSteal
+ * DESCR:    Takes the oldest task off the top of pDeque, which belongs to some other worker.
+ * RETURNS:  true if there was a task, which is returned in *pEntry.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool PoolSteal
+    (
+    PoolDeque *pDeque,
+    PoolEntry *pEntry
+    )
+{
+    bool found;
+
+    pthread_mutex_lock(&pDeque->mLock);
+    found = pDeque->mCount > 0;
+    if (found) {
+        *pEntry = pDeque->mQueue[pDeque->mTop];
+        pDeque->mTop = (pDeque->mTop + 1) % pDeque->mCap;
+        --pDeque->mCount;
+    }
+    pthread_mutex_unlock(&pDeque->mLock);
+    return found;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolSubmit
+ * DESCR:    Queues pTask, a task of the group pGroup, to be run with argument pArg. A worker thread queues it
+ *           on its own deque; any other thread queues it on the next deque in turn. Idle workers will steal it
+ *           from there. If the pool has not been started, pTask is run right away by the calling thread.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void PoolSubmit
+    (
+    PoolGroup *pGroup,
+    PoolTask   pTask,
+    void      *pArg
+    )
+{
+    PoolDeque *deque;
+    PoolEntry entry;
+
+    if (gPool.mNum == 0) {
+        pTask(pArg);
+        return;
+    }
+    deque = pthread_getspecific(gPool.mSelf);
+    if (!deque) deque = &gPool.mDeques[__atomic_fetch_add(&gPool.mNext, 1, __ATOMIC_RELAXED) % gPool.mNum];
+    entry.mTask = pTask;
+    entry.mArg = pArg;
+    entry.mGroup = pGroup;
+    __atomic_add_fetch(&pGroup->mPending, 1, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&gPool.mQueued, 1, __ATOMIC_SEQ_CST);
+    PoolPush(deque, &entry);
+
+    /* Taking the lock means a worker cannot miss the wakeup between seeing mQueued == 0 and sleeping. */
+    pthread_mutex_lock(&gPool.mLock);
+    pthread_cond_signal(&gPool.mWork);
+    pthread_mutex_unlock(&gPool.mLock);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolTake
+ * DESCR:    Finds a task for the worker that owns pSelf: the newest task in its own deque, or else the oldest
+ *           task in the first other deque that has one, looking at the deques in order from pSelf on.
+ * RETURNS:  true if a task was found, which is returned in *pEntry.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool PoolTake
+    (
+    PoolDeque *pSelf,
+    PoolEntry *pEntry
+    )
+{
+    int i, self = pSelf - gPool.mDeques;
+
+    if (PoolPop(pSelf, pEntry)) return true;
+    for (i = 1; i < gPool.mNum; ++i) {
+        if (PoolSteal(&gPool.mDeques[(self + i) % gPool.mNum], pEntry)) return true;
+    }
+    return false;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolWait
+ * DESCR:    Waits until every task of the group pGroup has finished. On a worker thread, i.e., when a task
+ *           waits for tasks it submitted, the worker runs queued tasks (of any group) while it waits rather
+ *           than sleeping, and only sleeps while no task is queued, when the rest of the group is running on
+ *           other threads.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void PoolWait
+    (
+    PoolGroup *pGroup
+    )
+{
+    PoolDeque *self = gPool.mNum > 0 ? pthread_getspecific(gPool.mSelf) : NULL;
+    PoolEntry entry;
+
+    while (__atomic_load_n(&pGroup->mPending, __ATOMIC_SEQ_CST) > 0) {
+        if (self && PoolTake(self, &entry)) {
+            PoolRun(&entry);
+            continue;
+        }
+        pthread_mutex_lock(&gPool.mLock);
+        while (__atomic_load_n(&pGroup->mPending, __ATOMIC_SEQ_CST) > 0 &&
+               (!self || __atomic_load_n(&gPool.mQueued, __ATOMIC_SEQ_CST) == 0)) {
+            pthread_cond_wait(&gPool.mDone, &gPool.mLock);
+        }
+        pthread_mutex_unlock(&gPool.mLock);
+    }
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: PoolWorker
+ * DESCR:    The body of each worker thread. pArg is the worker's own deque. Takes tasks (see PoolTake()) and
+ *           runs them, sleeping while there are none, until PoolEnd() says to exit and every deque is empty.
+ * RETURNS:  NULL.
+ *------------------------------------------------------------------------------------------------------------*/
+static void *PoolWorker
+    (
+    void *pArg
+    )
+{
+    PoolDeque *self = pArg;
+    PoolEntry entry;
+
+    pthread_setspecific(gPool.mSelf, self);
+    for (;;) {
+        if (PoolTake(self, &entry)) {
+            PoolRun(&entry);
+            continue;
+        }
+        pthread_mutex_lock(&gPool.mLock);
+        while (__atomic_load_n(&gPool.mQueued, __ATOMIC_SEQ_CST) == 0 && !gPool.mEnding) {
+            pthread_cond_wait(&gPool.mWork, &gPool.mLock);
+        }
+        if (__atomic_load_n(&gPool.mQueued, __ATOMIC_SEQ_CST) == 0) {
+            pthread_mutex_unlock(&gPool.mLock);
+            break;
+        }
+        pthread_mutex_unlock(&gPool.mLock);
+    }
+    return NULL;
+}
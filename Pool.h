@@ -0,0 +1,95 @@
+/***************************************************************************************************************
+ * FILE: Pool.h
+ *
+ * DESCRIPTION
+ * A pool of worker threads. PoolBegin() starts the threads, PoolSubmit() queues a task (a function and its
+ * argument) in a group for the next free thread, and PoolWait() waits until every task of the group is
+ * finished. Each worker has its own queue of tasks and steals from the others when its own runs dry, so a task
+ * may submit more tasks (e.g., split a big job into pieces) and idle workers will pick the pieces up.
+ *
+ * A group only counts its own tasks, so callers on different threads do not wait for each other's work, and a
+ * task may wait for a group of its own, e.g., a batch job may call PoolApply(). A worker that waits does not
+ * sleep while there are tasks queued: it runs them itself until its group is finished, so the pool cannot
+ * deadlock with every worker waiting on tasks that no one is left to run.
+ *
+ * PoolApply() uses the pool to run the Vigenere kernel on a large buffer. Each output byte depends only on the
+ * input byte at the same position and on the key index at that position, which is the position mod the key
+ * length. So the buffer is split into one slice per thread and each slice is started at its own key index.
+ * The slices write to disjoint parts of the output, so the output is the same as a single-threaded run no
+ * matter in which order the threads finish.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#ifndef _POOL_H_ /* Preprocessor guard to prevent Pool.h from being included more than once */
+#define _POOL_H_ /* See comments in Main.h. */
+
+#include <stddef.h>    /* For size_t */
+#include "Vigenere.h"  /* For VigenereSched */
+
+/*==============================================================================================================
+ * Global type definitions.
+ *
+ * A PoolTask is a function that is run by one of the worker threads. It is passed the pArg that was passed to
+ * PoolSubmit(). A PoolGroup is a set of tasks that are waited for together. It must be zeroed before its first
+ * task is submitted, e.g., PoolGroup pending = { 0 };, and it must live until PoolWait() on it returns.
+ *============================================================================================================*/
+typedef void (*PoolTask)(void *pArg);
+
+typedef struct {
+    size_t mPending;  /* The number of tasks of the group that have been submitted but not finished */
+} PoolGroup;
+
+/*==============================================================================================================
+ * Global function declarations.
+ *
+ * See comments in Main.h concerning what global function declarations are for.
+ *============================================================================================================*/
+extern size_t PoolApply
+    (
+    const VigenereSched *pSched,
+    size_t               pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    );
+
+extern void PoolBegin
+    (
+    int pThreads
+    );
+
+extern void PoolEnd
+    (
+    );
+
+extern int PoolGetThreads
+    (
+    );
+
+extern void PoolSubmit
+    (
+    PoolGroup *pGroup,
+    PoolTask   pTask,
+    void      *pArg
+    );
+
+extern void PoolWait
+    (
+    PoolGroup *pGroup
+    );
+
+#endif /* __POOL_H__ */
@@ -0,0 +1,1113 @@
+/***************************************************************************************************************
+ * FILE: Stream.c
+ *
+ * DESCRIPTION
+ * See comments in Stream.h.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+
+/*
+ * read(), write(), and POSIX threads are not ANSI C, and io_uring is reached through syscall() and pipes are
+ * spliced with vmsplice(), which are GNU extensions, so with -ansi none of them are declared unless we ask for
+ * them. This must come before any #include.
+ */
+#define _GNU_SOURCE
+
+#include <errno.h>      /* For errno, EINTR, EAGAIN */
+#include <fcntl.h>      /* For fcntl(), O_APPEND, vmsplice(), F_GETPIPE_SZ, F_SETPIPE_SZ, SPLICE_F_GIFT */
+#include <pthread.h>    /* For pthread_create(), pthread_join(), pthread_mutex_t, pthread_cond_t */
+#include <stdlib.h>     /* For calloc(), malloc(), free() */
+#include <string.h>     /* For memset() */
+#include <sys/stat.h>   /* For fstat(), S_ISFIFO(), S_ISREG() */
+#include <sys/uio.h>    /* For struct iovec */
+#include <unistd.h>     /* For read(), write(), lseek(), sysconf() */
+#include "Armor.h"      /* For ArmorBegin(), ArmorEnd(), ArmorMaxLen(), ArmorRun(), ARMOR_NONE */
+#include "Container.h"  /* For ContainerOpen(), ContainerRead(), ContainerWrite(), CONTAINER_CHUNK_LEN, ... */
+#include "Globals.h"    /* For STREAM_BLOCK_LEN, TERM_ERR_CONTAINER, TERM_ERR_FILE */
+#include "Main.h"       /* For MainTerminate() */
+#include "Pool.h"       /* For PoolApply(), PoolGroup, PoolSubmit(), PoolWait() */
+#include "Stream.h"     /* Good to always include the module header file. See comments in Globals.c. */
+
+/*
+ * io_uring and vmsplice() only exist on Linux. Everywhere else StreamRun() goes straight to the threaded
+ * pipeline.
+ */
+#if defined(__linux__)
+#define STREAM_SPLICE
+#include <sys/mman.h>       /* For mmap(), munmap() */
+#include <sys/syscall.h>    /* For __NR_io_uring_setup, __NR_io_uring_enter, __NR_io_uring_register */
+#if defined(__NR_io_uring_setup)
+#define STREAM_URING
+#include <linux/io_uring.h> /* For struct io_uring_params, struct io_uring_sqe, struct io_uring_cqe */
+#endif
+#endif
+
+/*==============================================================================================================
+ * Preprocessor macros.
+ *
+ * The pipeline keeps STREAM_SLOTS blocks of STREAM_BLOCK_LEN bytes, so its memory use is fixed. At any moment
+ * some slots are being read into, one is being transformed, and the rest are being written out. The state of
+ * a slot moves FREE -> READING -> READ -> WRITING -> FREE.
+ *============================================================================================================*/
+#define STREAM_SLOTS   (4)
+#define STREAM_FREE    (0)
+#define STREAM_READING (1)
+#define STREAM_READ    (2)
+#define STREAM_WRITING (3)
+
+/*==============================================================================================================
+ * Static types.
+ *
+ * A StreamSlot is one block of the pipeline. A StreamPipe is one run of a pipeline: the slots, and, for the
+ * threaded pipeline, the lock and condition variable that protect their states and the file descriptors the
+ * threads read and write. Each call to StreamRun() has its own StreamPipe, so several streams can run at once.
+ * A StreamChunk is one chunk of a container being checked and decrypted by a worker thread.
+ *============================================================================================================*/
+typedef struct {
+    const ContainerReader *mReader;  /* The container */
+    const VigenereSched   *mSched;   /* The key schedule */
+    size_t                 mChunk;   /* The number of the chunk */
+    char                  *mBuf;     /* mReader->mChunkLen bytes */
+    long                   mLen;     /* The number of bytes in mBuf, or -1 if the chunk is damaged */
+} StreamChunk;
+
+typedef struct {
+    char   *mBuf;       /* STREAM_BLOCK_LEN bytes */
+    size_t  mLen;       /* The number of bytes read into mBuf */
+    char   *mArmored;   /* The buffer the armor is encoded or decoded into, NULL without armor */
+    char   *mOut;       /* The bytes to write: mBuf, or mArmored with armor (see StreamTransform()) */
+    size_t  mOutLen;    /* The number of bytes to write */
+    size_t  mDone;      /* The number of bytes of mOut that have been written (io_uring only) */
+    off_t   mOff;       /* The file offset of mBuf[0] in the input or output file (io_uring only) */
+    int     mState;     /* STREAM_FREE, STREAM_READING, STREAM_READ, or STREAM_WRITING */
+} StreamSlot;
+
+typedef struct {
+    pthread_mutex_t mLock;                /* Protects mState of every slot */
+    pthread_cond_t  mChange;              /* Signaled when the state of a slot changes */
+    StreamSlot      mSlot[STREAM_SLOTS];  /* The blocks of the pipeline */
+    ArmorState      mArmor;               /* The armor stage, see StreamTransform() */
+    int             mInFd;                /* The file descriptor being read */
+    int             mOutFd;               /* The file descriptor being written */
+} StreamPipe;
+
+#ifdef STREAM_URING
+/*
+ * A StreamRing is an io_uring: the submission queue (SQ) of requests for the kernel and the completion queue
+ * (CQ) of results, both shared with the kernel through mmap(). The head and tail pointers point into the
+ * shared memory.
+ */
+typedef struct {
+    int                  mFd;                                  /* The ring's file descriptor */
+    unsigned            *mSqHead, *mSqTail, *mSqMask, *mSqArray;
+    struct io_uring_sqe *mSqes;                                /* The submission queue entries */
+    unsigned            *mCqHead, *mCqTail, *mCqMask;
+    struct io_uring_cqe *mCqes;                                /* The completion queue entries */
+    void                *mSqMap, *mCqMap;                      /* The shared ring memory */
+    size_t               mSqMapLen, mCqMapLen, mSqesLen;
+    unsigned             mToSubmit;                            /* SQEs queued but not yet submitted */
+} StreamRing;
+#endif
+
+/*==============================================================================================================
+ * Static function declarations.
+ *============================================================================================================*/
+static void StreamChunkTask(void *pArg);
+#ifdef STREAM_SPLICE
+static bool StreamIsPipe(int pFd);
+#endif
+static void StreamPosition(int pFd, bool pWrite, bool *pSeekable, off_t *pOff);
+static ssize_t StreamRead(int pFd, char *pBuf, size_t pLen);
+static ssize_t StreamReadAt(int pFd, char *pBuf, size_t pLen, size_t pOffset);
+static void *StreamReader(void *pArg);
+#ifdef STREAM_URING
+static void StreamRingEnd(StreamRing *pRing);
+static void StreamRingEnter(StreamRing *pRing, unsigned pWait);
+static bool StreamRingBegin(StreamRing *pRing, unsigned pEntries);
+static void StreamRingQueue(StreamRing *pRing, int pOp, int pFd, char *pBuf, size_t pLen, off_t pOff,
+                            unsigned long pData);
+#endif
+#ifdef STREAM_SPLICE
+static bool StreamRunSplice(const VigenereSched *pSched, int pInFd, int pOutFd, size_t *pPhase);
+#endif
+static size_t StreamRunSync(StreamPipe *pPipe, const VigenereSched *pSched, size_t pPhase);
+static size_t StreamRunThreads(const VigenereSched *pSched, const ArmorState *pArmor, int pInFd, int pOutFd,
+                               size_t pPhase);
+#ifdef STREAM_URING
+static bool StreamRunUring(const VigenereSched *pSched, const ArmorState *pArmor, int pInFd, int pOutFd,
+                           size_t *pPhase);
+#endif
+static void StreamSlotsEnd(StreamPipe *pPipe);
+static bool StreamSlotsBegin(StreamPipe *pPipe, const ArmorState *pArmor);
+static size_t StreamTransform(StreamPipe *pPipe, StreamSlot *pSlot, const VigenereSched *pSched, size_t pPhase);
+static void *StreamWriter(void *pArg);
+
+/*==============================================================================================================
+ * Function definitions.
+ *============================================================================================================*/
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamChunkTask
+ * DESCR:    Reads and checks one chunk of a container and decrypts it in place, starting at the key index its
+ *           header records. pArg is the StreamChunk. Runs on a worker thread (see StreamRunContainer()).
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void StreamChunkTask
+    (
+    void *pArg
+    )
+{
+    StreamChunk *chunk = pArg;
+    size_t phase = chunk->mReader->mChunks[chunk->mChunk].mPhase % chunk->mSched->mLen;
+
+    chunk->mLen = ContainerRead(chunk->mReader, chunk->mChunk, chunk->mBuf);
+    if (chunk->mLen > 0) VigenereApply(chunk->mSched, phase, chunk->mBuf, chunk->mBuf, chunk->mLen);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamFill
+ * DESCR:    Reads from pFd into pBuf until all pLen bytes have been read or end of file is reached. A read of a
+ *           pipe returns only what the producer has written so far, so it may take several reads to fill pBuf.
+ * RETURNS:  The number of bytes read, which is less than pLen only at end of file.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t StreamFill
+    (
+    int     pFd,
+    char   *pBuf,
+    size_t  pLen
+    )
+{
+    size_t len = 0;
+    ssize_t n;
+
+    while (len < pLen && (n = StreamRead(pFd, pBuf + len, pLen - len)) > 0) len += n;
+    return len;
+}
+
+#ifdef STREAM_SPLICE
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamIsPipe
+ * DESCR:    Determines if pFd is a pipe (or a FIFO, which is the same thing with a name).
+ * RETURNS:  true if pFd is a pipe.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool StreamIsPipe
+    (
+    int pFd
+    )
+{
+    struct stat st;
+
+    return fstat(pFd, &st) == 0 && S_ISFIFO(st.st_mode);
+}
+#endif
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamPosition
+ * DESCR:    Determines if the kernel may be given explicit file offsets for pFd, i.e., if it is a regular file
+ *           (and, if it is written, not opened for appending). If so, several reads or writes can be in flight
+ *           at once because each one says where its bytes go. Otherwise (a pipe, a terminal, a socket, or an
+ *           appended file) the bytes must be transferred one request at a time in order.
+ * RETURNS:  *pSeekable, and in *pOff the current file offset of pFd if it is seekable.
+ *------------------------------------------------------------------------------------------------------------*/
+static void StreamPosition
+    (
+    int    pFd,
+    bool   pWrite,
+    bool  *pSeekable,
+    off_t *pOff
+    )
+{
+    struct stat st;
+
+    *pSeekable = false;
+    *pOff = 0;
+    if (fstat(pFd, &st) < 0 || !S_ISREG(st.st_mode)) return;
+    if (pWrite && (fcntl(pFd, F_GETFL) & O_APPEND)) return;
+    *pOff = lseek(pFd, 0, SEEK_CUR);
+    *pSeekable = *pOff >= 0;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamRead
+ * DESCR:    Reads up to pLen bytes from pFd into pBuf, retrying if interrupted by a signal. Terminates with an
+ *           error message if the read fails.
+ * RETURNS:  The number of bytes read, 0 at end of file.
+ *------------------------------------------------------------------------------------------------------------*/
+static ssize_t StreamRead
+    (
+    int     pFd,
+    char   *pBuf,
+    size_t  pLen
+    )
+{
+    ssize_t n;
+
+    do {
+        n = read(pFd, pBuf, pLen);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) MainTerminate(TERM_ERR_FILE, "could not read the message.\n");
+    return n;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamReadAt
+ * DESCR:    Reads up to pLen bytes at byte offset pOffset of pFd into pBuf with pread(), which leaves the file
+ *           position alone, retrying if interrupted by a signal. Terminates with an error message if the read
+ *           fails.
+ * RETURNS:  The number of bytes read, 0 at end of file.
+ *------------------------------------------------------------------------------------------------------------*/
+static ssize_t StreamReadAt
+    (
+    int     pFd,
+    char   *pBuf,
+    size_t  pLen,
+    size_t  pOffset
+    )
+{
+    ssize_t n;
+
+    do {
+        n = pread(pFd, pBuf, pLen, (off_t)pOffset);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) MainTerminate(TERM_ERR_FILE, "could not read the message.\n");
+    return n;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamReader
+ * DESCR:    The reader thread of the threaded pipeline. pArg is the StreamPipe. Fills the slots in order,
+ *           waiting for each one to be free. A slot of length 0 marks the end of the input.
+ * RETURNS:  NULL.
+ *------------------------------------------------------------------------------------------------------------*/
+static void *StreamReader
+    (
+    void *pArg
+    )
+{
+    StreamPipe *stream = pArg;
+    size_t seq;
+    StreamSlot *slot;
+
+    for (seq = 0; ; ++seq) {
+        slot = &stream->mSlot[seq % STREAM_SLOTS];
+        pthread_mutex_lock(&stream->mLock);
+        while (slot->mState != STREAM_FREE) pthread_cond_wait(&stream->mChange, &stream->mLock);
+        pthread_mutex_unlock(&stream->mLock);
+        slot->mLen = StreamRead(stream->mInFd, slot->mBuf, STREAM_BLOCK_LEN);
+        pthread_mutex_lock(&stream->mLock);
+        slot->mState = STREAM_READ;
+        pthread_cond_broadcast(&stream->mChange);
+        pthread_mutex_unlock(&stream->mLock);
+        if (slot->mLen == 0) break;
+    }
+    return NULL;
+}
+
+#ifdef STREAM_URING
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamRingBegin
+ * DESCR:    Creates an io_uring with room for pEntries requests and maps its queues. The kernel must support
+ *           the IORING_OP_READ and IORING_OP_WRITE requests, which is checked with a probe.
+ * RETURNS:  true if the ring is ready. false if io_uring is not available (not compiled into the kernel,
+ *           blocked by a sandbox, too old, ...), in which case nothing needs to be freed.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool StreamRingBegin
+    (
+    StreamRing *pRing,
+    unsigned    pEntries
+    )
+{
+    struct io_uring_params params;
+    struct io_uring_probe *probe;
+    size_t probeLen = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    bool ok;
+
+    memset(pRing, 0, sizeof(StreamRing));
+    memset(&params, 0, sizeof(params));
+    pRing->mFd = syscall(__NR_io_uring_setup, pEntries, &params);
+    if (pRing->mFd < 0) return false;
+
+    probe = calloc(1, probeLen);
+    ok = probe && syscall(__NR_io_uring_register, pRing->mFd, IORING_REGISTER_PROBE, probe, 256) == 0 &&
+         probe->last_op >= IORING_OP_WRITE && (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) &&
+         (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+    free(probe);
+    if (!ok) {
+        close(pRing->mFd);
+        return false;
+    }
+
+    pRing->mSqMapLen = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    pRing->mCqMapLen = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    pRing->mSqesLen = params.sq_entries * sizeof(struct io_uring_sqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (pRing->mCqMapLen > pRing->mSqMapLen) pRing->mSqMapLen = pRing->mCqMapLen;
+        pRing->mCqMapLen = 0;
+    }
+    pRing->mSqMap = mmap(NULL, pRing->mSqMapLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pRing->mFd,
+                         IORING_OFF_SQ_RING);
+    pRing->mCqMap = pRing->mCqMapLen == 0 ? pRing->mSqMap :
+                    mmap(NULL, pRing->mCqMapLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pRing->mFd,
+                         IORING_OFF_CQ_RING);
+    pRing->mSqes = mmap(NULL, pRing->mSqesLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pRing->mFd,
+                        IORING_OFF_SQES);
+    if (pRing->mSqMap == MAP_FAILED || pRing->mCqMap == MAP_FAILED || pRing->mSqes == MAP_FAILED) {
+        StreamRingEnd(pRing);
+        return false;
+    }
+    pRing->mSqHead  = (unsigned *)((char *)pRing->mSqMap + params.sq_off.head);
+    pRing->mSqTail  = (unsigned *)((char *)pRing->mSqMap + params.sq_off.tail);
+    pRing->mSqMask  = (unsigned *)((char *)pRing->mSqMap + params.sq_off.ring_mask);
+    pRing->mSqArray = (unsigned *)((char *)pRing->mSqMap + params.sq_off.array);
+    pRing->mCqHead  = (unsigned *)((char *)pRing->mCqMap + params.cq_off.head);
+    pRing->mCqTail  = (unsigned *)((char *)pRing->mCqMap + params.cq_off.tail);
+    pRing->mCqMask  = (unsigned *)((char *)pRing->mCqMap + params.cq_off.ring_mask);
+    pRing->mCqes    = (struct io_uring_cqe *)((char *)pRing->mCqMap + params.cq_off.cqes);
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamRingEnd
+ * DESCR:    Unmaps the queues of an io_uring and closes it.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void StreamRingEnd
+    (
+    StreamRing *pRing
+    )
+{
+    if (pRing->mSqes && pRing->mSqes != MAP_FAILED) munmap(pRing->mSqes, pRing->mSqesLen);
+    if (pRing->mCqMapLen && pRing->mCqMap && pRing->mCqMap != MAP_FAILED) {
+        munmap(pRing->mCqMap, pRing->mCqMapLen);
+    }
+    if (pRing->mSqMap && pRing->mSqMap != MAP_FAILED) munmap(pRing->mSqMap, pRing->mSqMapLen);
+    close(pRing->mFd);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamRingEnter
+ * DESCR:    Submits the requests that have been queued with StreamRingQueue() and, if pWait is nonzero, waits
+ *           until at least pWait results are in the completion queue. Terminates with an error message if the
+ *           kernel refuses.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void StreamRingEnter
+    (
+    StreamRing *pRing,
+    unsigned    pWait
+    )
+{
+    long n;
+
+    if (pRing->mToSubmit == 0 && pWait == 0) return;
+    do {
+        n = syscall(__NR_io_uring_enter, pRing->mFd, pRing->mToSubmit, pWait,
+                    pWait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) MainTerminate(TERM_ERR_FILE, "io_uring_enter failed.\n");
+    pRing->mToSubmit -= n;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamRingQueue
+ * DESCR:    Queues a read (pOp is IORING_OP_READ) or write (IORING_OP_WRITE) of pLen bytes at pBuf from or to
+ *           pFd at file offset pOff, or at the current file position if pOff is -1. pData comes back with the
+ *           result so the caller can tell which request finished. The request is not seen by the kernel until
+ *           StreamRingEnter() is called.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void StreamRingQueue
+    (
+    StreamRing    *pRing,
+    int            pOp,
+    int            pFd,
+    char          *pBuf,
+    size_t         pLen,
+    off_t          pOff,
+    unsigned long  pData
+    )
+{
+    unsigned tail = *pRing->mSqTail, index = tail & *pRing->mSqMask;
+    struct io_uring_sqe *sqe = &pRing->mSqes[index];
+
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->opcode = pOp;
+    sqe->fd = pFd;
+    sqe->addr = (unsigned long)pBuf;
+    sqe->len = pLen;
+    sqe->off = (unsigned long long)pOff;
+    sqe->user_data = pData;
+    pRing->mSqArray[index] = index;
+
+    /* The entry must be visible to the kernel before the new tail is. */
+    __atomic_store_n(pRing->mSqTail, tail + 1, __ATOMIC_RELEASE);
+    ++pRing->mToSubmit;
+}
+#endif
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamRun
+ * DESCR:    Reads the message from file descriptor pInFd until end of file, one block at a time, runs each
+ *           block through the key schedule of pCtx (on the worker threads, if there are any) and writes it to
+ *           pOutFd. The key index starts at the stream offset of pCtx and is carried from block to block.
+ *
+ *           pArmor (see Armor.h) is ARMOR_NONE, or the armor of the ciphertext: encryption encodes each block
+ *           after it is transformed and decryption decodes each block before it is transformed, in the same
+ *           pass (see StreamTransform()).
+ *
+ *           If pSplice is true, there is no armor, and both pInFd and pOutFd are pipes, i.e., we are a filter
+ *           in a shell pipeline, the transformed blocks are handed to the output pipe with vmsplice() rather
+ *           than copied into it (see StreamRunSplice()).
+ *
+ *           Otherwise reading, transforming, and writing are overlapped so that the disk (or pipe) and the CPU
+ *           are busy at the same time instead of taking turns. If pUring is true and the kernel supports it,
+ *           io_uring is used to keep several reads and writes in flight while the previous block is
+ *           transformed. Otherwise a reader thread and a writer thread pass blocks to and from this thread.
+ *           Either way, memory use is STREAM_SLOTS blocks of STREAM_BLOCK_LEN bytes no matter how long the
+ *           message is.
+ * RETURNS:  The key index following the last byte of the message, which is also the new stream offset of
+ *           pCtx.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t StreamRun
+    (
+    VigenereCtx *pCtx,
+    int          pInFd,
+    int          pOutFd,
+    int          pArmor,
+    bool         pUring,
+    bool         pSplice
+    )
+{
+    size_t phase = pCtx->mPhase;
+    ArmorState armor;
+    bool done = false;
+
+    ArmorBegin(&armor, pArmor, pCtx->mMode == VIGENERE_DECRYPT);
+#ifdef STREAM_SPLICE
+    done = pSplice && pArmor == ARMOR_NONE && StreamIsPipe(pInFd) && StreamIsPipe(pOutFd) &&
+           StreamRunSplice(&pCtx->mSched, pInFd, pOutFd, &phase);
+#endif
+#ifdef STREAM_URING
+    if (!done) done = pUring && StreamRunUring(&pCtx->mSched, &armor, pInFd, pOutFd, &phase);
+#endif
+    if (!done) phase = StreamRunThreads(&pCtx->mSched, &armor, pInFd, pOutFd, phase);
+    pCtx->mPhase = phase;
+    return phase;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamRunContainer
+ * DESCR:    Runs the message through pCtx as a chunked container (see Container.h). When encrypting, pInFd is
+ *           read in chunks of CONTAINER_CHUNK_LEN bytes, each chunk is encrypted on the worker threads (see
+ *           PoolApply()), and the container is written to pOutFd, which may be a pipe. When decrypting, pInFd
+ *           must be a container file, since its index is at the end. Its chunks are read, checked, and
+ *           decrypted a group at a time, one chunk per task, so the chunks of a group are checked and decrypted
+ *           in parallel, and are then written to pOutFd in order. Terminates with an error message if pInFd is
+ *           not a container or a chunk is damaged; the chunks before the damaged one have been written.
+ * RETURNS:  The number of bytes of the message.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t StreamRunContainer
+    (
+    VigenereCtx *pCtx,
+    int          pInFd,
+    int          pOutFd
+    )
+{
+    size_t n, c, i, phase, group = 2 * PoolGetThreads(), msgLen = 0;
+    ContainerWriter writer;
+    ContainerReader reader;
+    StreamChunk *chunks;
+    PoolGroup pending = { 0 };
+    char *buf;
+
+    if (pCtx->mMode == VIGENERE_ENCRYPT) {
+        buf = malloc(CONTAINER_CHUNK_LEN);
+        if (!buf) MainTerminate(TERM_ERR_FILE, "could not allocate the stream buffer.\n");
+        if (!ContainerWriteBegin(&writer, pOutFd, CONTAINER_CHUNK_LEN)) {
+            MainTerminate(TERM_ERR_FILE, "could not write the container.\n");
+        }
+        while ((n = StreamFill(pInFd, buf, CONTAINER_CHUNK_LEN)) > 0) {
+            phase = pCtx->mPhase;
+            pCtx->mPhase = PoolApply(&pCtx->mSched, phase, buf, buf, n);
+            if (!ContainerWrite(&writer, buf, n, phase)) {
+                MainTerminate(TERM_ERR_FILE, "could not write the container.\n");
+            }
+            msgLen += n;
+        }
+        free(buf);
+        if (!ContainerWriteEnd(&writer)) MainTerminate(TERM_ERR_FILE, "could not write the container.\n");
+        return msgLen;
+    }
+
+    if (!ContainerOpen(&reader, pInFd)) {
+        MainTerminate(TERM_ERR_CONTAINER, "the input is not a chunked container, or its index is damaged.\n");
+    }
+    chunks = calloc(group, sizeof(StreamChunk));
+    if (!chunks) MainTerminate(TERM_ERR_FILE, "could not allocate the stream buffer.\n");
+    for (i = 0; i < group; ++i) {
+        chunks[i].mReader = &reader;
+        chunks[i].mSched = &pCtx->mSched;
+        chunks[i].mBuf = malloc(reader.mChunkLen);
+        if (!chunks[i].mBuf) MainTerminate(TERM_ERR_FILE, "could not allocate the stream buffer.\n");
+    }
+    for (c = 0; c < reader.mNumChunks; c += n) {
+        n = reader.mNumChunks - c < group ? reader.mNumChunks - c : group;
+        for (i = 0; i < n; ++i) {
+            chunks[i].mChunk = c + i;
+            PoolSubmit(&pending, StreamChunkTask, &chunks[i]);
+        }
+        PoolWait(&pending);
+        for (i = 0; i < n; ++i) {
+            if (chunks[i].mLen < 0) {
+                MainTerminate(TERM_ERR_CONTAINER, "chunk %d of the container is damaged.\n", (int)(c + i));
+            }
+            StreamWrite(pOutFd, chunks[i].mBuf, chunks[i].mLen);
+        }
+    }
+    for (i = 0; i < group; ++i) free(chunks[i].mBuf);
+    free(chunks);
+    msgLen = reader.mMsgLen;
+    ContainerClose(&reader);
+    return msgLen;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamRunMem
+ * DESCR:    Runs the pLen bytes at pIn, which is usually a memory-mapped input file, through pCtx and the armor
+ *           pArmor (as in StreamRun()) and writes the result to pOutFd. pIn may be read-only, so each block is
+ *           transformed into a buffer of STREAM_BLOCK_LEN bytes on its way to pOutFd; armor is encoded from, or
+ *           decoded into, a second buffer. pIn[0] is at the stream offset of pCtx.
+ * RETURNS:  The key index following the last byte, which is also the new stream offset of pCtx.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t StreamRunMem
+    (
+    VigenereCtx *pCtx,
+    const char  *pIn,
+    size_t       pLen,
+    int          pOutFd,
+    int          pArmor
+    )
+{
+    char *block = malloc(STREAM_BLOCK_LEN), *armored = NULL;
+    ArmorState armor;
+    size_t n, m;
+
+    ArmorBegin(&armor, pArmor, pCtx->mMode == VIGENERE_DECRYPT);
+    if (pArmor != ARMOR_NONE) armored = malloc(ArmorMaxLen(&armor, STREAM_BLOCK_LEN));
+    if (!block || (pArmor != ARMOR_NONE && !armored)) {
+        MainTerminate(TERM_ERR_FILE, "could not allocate the stream buffer.\n");
+    }
+    for (; pLen > 0; pIn += n, pLen -= n) {
+        n = pLen < STREAM_BLOCK_LEN ? pLen : STREAM_BLOCK_LEN;
+        if (!armored) {
+            pCtx->mPhase = PoolApply(&pCtx->mSched, pCtx->mPhase, pIn, block, n);
+            StreamWrite(pOutFd, block, n);
+        } else if (armor.mDecode) {
+            m = ArmorRun(&armor, pIn, n, armored);
+            pCtx->mPhase = PoolApply(&pCtx->mSched, pCtx->mPhase, armored, armored, m);
+            StreamWrite(pOutFd, armored, m);
+        } else {
+            pCtx->mPhase = PoolApply(&pCtx->mSched, pCtx->mPhase, pIn, block, n);
+            StreamWrite(pOutFd, armored, ArmorRun(&armor, block, n, armored));
+        }
+    }
+    if (armored) {
+        m = ArmorEnd(&armor, armored);
+        if (armor.mDecode) pCtx->mPhase = PoolApply(&pCtx->mSched, pCtx->mPhase, armored, armored, m);
+        StreamWrite(pOutFd, armored, m);
+    }
+    free(armored);
+    free(block);
+    return pCtx->mPhase;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamRunRange
+ * DESCR:    Runs the pLen bytes at byte offset pOffset of the file open on pInFd through pCtx and writes the
+ *           result to pOutFd. pLen may be (size_t)-1 to run to end of file. The range is read with pread() in
+ *           blocks of STREAM_BLOCK_LEN bytes, so nothing before pOffset is read, and the stream offset of pCtx
+ *           is first moved to pOffset, so the key index of the first byte is the one it has in the whole
+ *           message. The cipher must not be in text mode, where the key index of a byte depends on the number
+ *           of letters before it rather than on its offset.
+ * RETURNS:  The number of bytes run, which is less than pLen only if the file ends first.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t StreamRunRange
+    (
+    VigenereCtx *pCtx,
+    int          pInFd,
+    size_t       pOffset,
+    size_t       pLen,
+    int          pOutFd
+    )
+{
+    size_t len = pLen < STREAM_BLOCK_LEN ? pLen : STREAM_BLOCK_LEN, done = 0;
+    char *block = malloc(len > 0 ? len : 1);
+    ssize_t n = 1;
+
+    if (!block) MainTerminate(TERM_ERR_FILE, "could not allocate the stream buffer.\n");
+    VigenereCtxSeek(pCtx, pOffset);
+    while (done < pLen && n > 0) {
+        n = StreamReadAt(pInFd, block, pLen - done < len ? pLen - done : len, pOffset + done);
+        pCtx->mPhase = PoolApply(&pCtx->mSched, pCtx->mPhase, block, block, n);
+        StreamWrite(pOutFd, block, n);
+        done += n;
+    }
+    free(block);
+    return done;
+}
+
+#ifdef STREAM_SPLICE
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamRunSplice
+ * DESCR:    The pipe pipeline. The output pipe is grown to STREAM_BLOCK_LEN bytes if the kernel allows it. Each
+ *           block, the size of the output pipe, is read into a buffer of its own that is freshly mapped (so it
+ *           is page-aligned), transformed in place, and given to the output pipe with vmsplice(), which puts
+ *           references to the pages of the buffer in the pipe rather than copying the bytes into it.
+ *
+ *           The pipe holds references to the pages, not copies, and a consumer that splice()s or tee()s out of
+ *           the pipe moves those same references on, so a page that has been spliced is never written again,
+ *           however the consumer reads it. Its buffer is given away with SPLICE_F_GIFT and unmapped, which only
+ *           drops our mapping; the pages live until the last pipe lets go of them. The next block goes into a
+ *           new mapping, whose pages are only allocated as they are filled.
+ *
+ *           If the kernel will not vmsplice() to pOutFd, the blocks are written with write() instead, which
+ *           copies them, so then the one buffer is used for every block.
+ * RETURNS:  true if the message was processed. *pPhase is the key index of the first byte on entry and of the
+ *           byte following the last one on return. false if the pipe size could not be found or the buffer
+ *           could not be mapped, in which case nothing has been read or written.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool StreamRunSplice
+    (
+    const VigenereSched *pSched,
+    int                  pInFd,
+    int                  pOutFd,
+    size_t              *pPhase
+    )
+{
+    long page = sysconf(_SC_PAGESIZE);
+    int pipeLen;
+    char *buf;
+    struct iovec iov;
+    size_t phase = *pPhase, len;
+    ssize_t n;
+    bool copy = false, spliced = false;
+
+    pipeLen = fcntl(pOutFd, F_SETPIPE_SZ, STREAM_BLOCK_LEN);
+    if (pipeLen < 0) pipeLen = fcntl(pOutFd, F_GETPIPE_SZ);
+    if (page <= 0 || pipeLen <= 0 || pipeLen % page != 0) return false;
+    buf = mmap(NULL, (size_t)pipeLen, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED) return false;
+
+    /* A bigger input pipe means fewer reads to fill a block. It is fine if the kernel says no. */
+    fcntl(pInFd, F_SETPIPE_SZ, pipeLen);
+
+    while ((len = StreamFill(pInFd, buf, pipeLen)) > 0) {
+        iov.iov_base = buf;
+        iov.iov_len = len;
+        phase = PoolApply(pSched, phase, buf, buf, len);
+        while (!copy && iov.iov_len > 0) {
+            n = vmsplice(pOutFd, &iov, 1, SPLICE_F_GIFT);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && !spliced && (errno == EINVAL || errno == ENOSYS)) copy = true;
+            else if (n < 0) MainTerminate(TERM_ERR_FILE, "could not write the message.\n");
+            else {
+                iov.iov_base = (char *)iov.iov_base + n;
+                iov.iov_len -= n;
+                spliced = true;
+            }
+        }
+        if (copy) StreamWrite(pOutFd, iov.iov_base, iov.iov_len);
+        if (len < (size_t)pipeLen) break;
+        if (!copy) {
+            munmap(buf, (size_t)pipeLen);
+            buf = mmap(NULL, (size_t)pipeLen, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (buf == MAP_FAILED) MainTerminate(TERM_ERR_FILE, "could not map a block of the message.\n");
+        }
+    }
+    munmap(buf, (size_t)pipeLen);
+    *pPhase = phase;
+    return true;
+}
+#endif
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamRunSync
+ * DESCR:    The simplest pipeline: read a block into the first slot of pPipe, transform it (see
+ *           StreamTransform()), write it, repeat. Used if the threads of the threaded pipeline could not be
+ *           started. pPhase is the key index of the first byte.
+ * RETURNS:  The key index following the last byte of the message.
+ *------------------------------------------------------------------------------------------------------------*/
+static size_t StreamRunSync
+    (
+    StreamPipe          *pPipe,
+    const VigenereSched *pSched,
+    size_t               pPhase
+    )
+{
+    StreamSlot *slot = &pPipe->mSlot[0];
+
+    do {
+        slot->mLen = StreamRead(pPipe->mInFd, slot->mBuf, STREAM_BLOCK_LEN);
+        pPhase = StreamTransform(pPipe, slot, pSched, pPhase);
+        StreamWrite(pPipe->mOutFd, slot->mOut, slot->mOutLen);
+    } while (slot->mLen > 0);
+    return pPhase;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamRunThreads
+ * DESCR:    The threaded pipeline. StreamReader() fills the slots in order, this thread transforms each one
+ *           (see StreamTransform()) as soon as it has been read, and StreamWriter() writes each one out as soon
+ *           as it has been transformed and hands it back to the reader. With STREAM_SLOTS slots the reader can
+ *           be up to STREAM_SLOTS - 1 blocks ahead of the writer. pPhase is the key index of the first byte,
+ *           and pArmor the armor stage.
+ * RETURNS:  The key index following the last byte of the message.
+ *------------------------------------------------------------------------------------------------------------*/
+static size_t StreamRunThreads
+    (
+    const VigenereSched *pSched,
+    const ArmorState    *pArmor,
+    int                  pInFd,
+    int                  pOutFd,
+    size_t               pPhase
+    )
+{
+    StreamPipe stream;
+    pthread_t reader, writer;
+    size_t seq;
+    StreamSlot *slot;
+    bool last;
+
+    if (!StreamSlotsBegin(&stream, pArmor)) {
+        MainTerminate(TERM_ERR_FILE, "could not allocate the stream buffers.\n");
+    }
+    stream.mInFd = pInFd;
+    stream.mOutFd = pOutFd;
+    if (pthread_create(&reader, NULL, StreamReader, &stream) != 0) {
+        pPhase = StreamRunSync(&stream, pSched, pPhase);
+        StreamSlotsEnd(&stream);
+        return pPhase;
+    }
+    if (pthread_create(&writer, NULL, StreamWriter, &stream) != 0) {
+        MainTerminate(TERM_ERR_BUG, "could not start the writer thread.\n");
+    }
+    for (seq = 0, last = false; !last; ++seq) {
+        slot = &stream.mSlot[seq % STREAM_SLOTS];
+        pthread_mutex_lock(&stream.mLock);
+        while (slot->mState != STREAM_READ) pthread_cond_wait(&stream.mChange, &stream.mLock);
+        pthread_mutex_unlock(&stream.mLock);
+        last = slot->mLen == 0;
+        pPhase = StreamTransform(&stream, slot, pSched, pPhase);
+        pthread_mutex_lock(&stream.mLock);
+        slot->mState = STREAM_WRITING;
+        pthread_cond_broadcast(&stream.mChange);
+        pthread_mutex_unlock(&stream.mLock);
+    }
+    pthread_join(reader, NULL);
+    pthread_join(writer, NULL);
+    StreamSlotsEnd(&stream);
+    return pPhase;
+}
+
+#ifdef STREAM_URING
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamRunUring
+ * DESCR:    The io_uring pipeline. The blocks of the message are numbered 0, 1, 2, ... and block b lives in
+ *           slot b % STREAM_SLOTS. r is the next block to read, c the next block to transform, and w the oldest
+ *           block whose slot is not yet free, so w <= c <= r <= w + STREAM_SLOTS. Each time around the loop,
+ *
+ *           1. Reads are queued into every free slot. If the input is seekable each read has its own file
+ *              offset, so all of them can be in flight at once; otherwise only one is, to keep them in order.
+ *           2. The reads are submitted, and the blocks that have been read are transformed in order (see
+ *              StreamTransform()) and their writes queued, while the kernel works on the reads. Again, writes
+ *              to a seekable output have their own offsets; otherwise only one is in flight at a time.
+ *           3. The writes are submitted and this thread waits for at least one request to finish. A short read
+ *              or write is resubmitted for the rest of its block. A read of 0 bytes is the end of the input.
+ *           4. Once everything has drained, the armor is ended if no slot of length 0 was transformed.
+ *
+ * RETURNS:  true if the message was processed. *pPhase is the key index of the first byte on entry and of the
+ *           byte following the last one on return. false if io_uring is not available, in which case nothing
+ *           has been read or written.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool StreamRunUring
+    (
+    const VigenereSched *pSched,
+    const ArmorState    *pArmor,
+    int                  pInFd,
+    int                  pOutFd,
+    size_t              *pPhase
+    )
+{
+    StreamPipe stream;
+    StreamRing ring;
+    StreamSlot *slot;
+    size_t r = 0, c = 0, w = 0, phase = *pPhase;
+    int reads = 0, writes = 0;
+    bool inSeek, outSeek, eof = false, ended = false;
+    off_t inOff, outOff;
+
+    if (!StreamRingBegin(&ring, 2 * STREAM_SLOTS)) return false;
+    if (!StreamSlotsBegin(&stream, pArmor)) {
+        MainTerminate(TERM_ERR_FILE, "could not allocate the stream buffers.\n");
+    }
+    StreamPosition(pInFd, false, &inSeek, &inOff);
+    StreamPosition(pOutFd, true, &outSeek, &outOff);
+
+    while (!eof || reads > 0 || writes > 0 || c < r) {
+        /* 1. Queue reads into the free slots. */
+        while (!eof && r - w < STREAM_SLOTS && (inSeek || reads == 0)) {
+            slot = &stream.mSlot[r % STREAM_SLOTS];
+            slot->mLen = 0;
+            slot->mOff = inOff;
+            slot->mState = STREAM_READING;
+            StreamRingQueue(&ring, IORING_OP_READ, pInFd, slot->mBuf, STREAM_BLOCK_LEN, inSeek ? inOff : -1,
+                            (r % STREAM_SLOTS) * 2);
+            if (inSeek) inOff += STREAM_BLOCK_LEN;
+            ++r;
+            ++reads;
+        }
+        StreamRingEnter(&ring, 0);
+
+        /* 2. Transform the blocks that have been read, in order, and queue their writes. */
+        while (c < r && stream.mSlot[c % STREAM_SLOTS].mState == STREAM_READ && (outSeek || writes == 0)) {
+            slot = &stream.mSlot[c % STREAM_SLOTS];
+            ++c;
+            if (slot->mLen == 0) ended = true;
+            phase = StreamTransform(&stream, slot, pSched, phase);
+            if (slot->mOutLen == 0) {
+                slot->mState = STREAM_FREE;
+                continue;
+            }
+            slot->mDone = 0;
+            slot->mOff = outOff;
+            slot->mState = STREAM_WRITING;
+            StreamRingQueue(&ring, IORING_OP_WRITE, pOutFd, slot->mOut, slot->mOutLen, outSeek ? outOff : -1,
+                            ((c - 1) % STREAM_SLOTS) * 2 + 1);
+            if (outSeek) outOff += slot->mOutLen;
+            ++writes;
+        }
+        while (w < c && stream.mSlot[w % STREAM_SLOTS].mState == STREAM_FREE) ++w;
+        if (reads == 0 && writes == 0) continue;
+
+        /* 3. Submit the writes and wait for something to finish. */
+        StreamRingEnter(&ring, 1);
+        while (*ring.mCqHead != __atomic_load_n(ring.mCqTail, __ATOMIC_ACQUIRE)) {
+            struct io_uring_cqe *cqe = &ring.mCqes[*ring.mCqHead & *ring.mCqMask];
+            int res = cqe->res;
+            bool isWrite = cqe->user_data & 1;
+            slot = &stream.mSlot[cqe->user_data / 2];
+            __atomic_store_n(ring.mCqHead, *ring.mCqHead + 1, __ATOMIC_RELEASE);
+
+            if (res == -EINTR || res == -EAGAIN) res = 0;
+            else if (res < 0) {
+                MainTerminate(TERM_ERR_FILE, "could not %s the message.\n", isWrite ? "write" : "read");
+            }
+            if (isWrite) {
+                if (res == 0 && cqe->res == 0) MainTerminate(TERM_ERR_FILE, "could not write the message.\n");
+                slot->mDone += res;
+                if (slot->mDone < slot->mOutLen) {
+                    StreamRingQueue(&ring, IORING_OP_WRITE, pOutFd, slot->mOut + slot->mDone,
+                                    slot->mOutLen - slot->mDone, outSeek ? slot->mOff + (off_t)slot->mDone : -1,
+                                    cqe->user_data);
+                } else {
+                    slot->mState = STREAM_FREE;
+                    --writes;
+                }
+            } else if (res == 0 && cqe->res == 0) {
+                /* End of file. Any reads still in flight after this one will also read 0 bytes. */
+                eof = true;
+                slot->mState = STREAM_READ;
+                --reads;
+            } else {
+                slot->mLen += res;
+                if (inSeek && slot->mLen < STREAM_BLOCK_LEN) {
+                    StreamRingQueue(&ring, IORING_OP_READ, pInFd, slot->mBuf + slot->mLen,
+                                    STREAM_BLOCK_LEN - slot->mLen, slot->mOff + (off_t)slot->mLen,
+                                    cqe->user_data);
+                } else if (res == 0 && !inSeek) {
+                    StreamRingQueue(&ring, IORING_OP_READ, pInFd, slot->mBuf, STREAM_BLOCK_LEN, -1,
+                                    cqe->user_data);
+                } else {
+                    slot->mState = STREAM_READ;
+                    --reads;
+                }
+            }
+        }
+    }
+
+    /* Leave the file positions where a plain read()/write() loop would have left them. */
+    if (inSeek) lseek(pInFd, inOff, SEEK_SET);
+    if (outSeek) lseek(pOutFd, outOff, SEEK_SET);
+
+    /* The read that hits the end of the input may be the rest of a short read, whose slot is not empty, so no
+     * slot of length 0 may have been read. End the armor with one, like the one StreamReader() always reads. */
+    if (!ended) {
+        slot = &stream.mSlot[0];
+        slot->mLen = 0;
+        phase = StreamTransform(&stream, slot, pSched, phase);
+        StreamWrite(pOutFd, slot->mOut, slot->mOutLen);
+    }
+    StreamRingEnd(&ring);
+    StreamSlotsEnd(&stream);
+    *pPhase = phase;
+    return true;
+}
+#endif
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamSlotsBegin
+ * DESCR:    Initializes the lock and condition variable of pPipe and its armor stage, a copy of pArmor,
+ *           allocates the buffers of its slots (and their armor buffers if there is armor), and marks every
+ *           slot free.
+ * RETURNS:  true if the buffers were allocated. Either way, call StreamSlotsEnd() when done with pPipe.
+ *------------------------------------------------------------------------------------------------------------*/
+static bool StreamSlotsBegin
+    (
+    StreamPipe       *pPipe,
+    const ArmorState *pArmor
+    )
+{
+    int i;
+
+    memset(pPipe, 0, sizeof(StreamPipe));
+    pthread_mutex_init(&pPipe->mLock, NULL);
+    pthread_cond_init(&pPipe->mChange, NULL);
+    pPipe->mArmor = *pArmor;
+    for (i = 0; i < STREAM_SLOTS; ++i) {
+        pPipe->mSlot[i].mBuf = malloc(STREAM_BLOCK_LEN);
+        pPipe->mSlot[i].mState = STREAM_FREE;
+        if (!pPipe->mSlot[i].mBuf) return false;
+        if (pArmor->mKind == ARMOR_NONE) continue;
+        pPipe->mSlot[i].mArmored = malloc(ArmorMaxLen(pArmor, STREAM_BLOCK_LEN));
+        if (!pPipe->mSlot[i].mArmored) return false;
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamSlotsEnd
+ * DESCR:    Frees the buffers and armor buffers of the slots of pPipe and destroys its lock and condition
+ *           variable.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+static void StreamSlotsEnd
+    (
+    StreamPipe *pPipe
+    )
+{
+    int i;
+
+    for (i = 0; i < STREAM_SLOTS; ++i) {
+        free(pPipe->mSlot[i].mBuf);
+        free(pPipe->mSlot[i].mArmored);
+        pPipe->mSlot[i].mBuf = NULL;
+        pPipe->mSlot[i].mArmored = NULL;
+    }
+    pthread_cond_destroy(&pPipe->mChange);
+    pthread_mutex_destroy(&pPipe->mLock);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamTransform
+ * DESCR:    Runs the pSlot->mLen bytes that were read into pSlot through pSched and the armor stage of pPipe,
+ *           and points mOut and mOutLen of pSlot at the bytes to write. Without armor the block is transformed
+ *           in place. With armor, encryption transforms the block in place and then encodes it into mArmored,
+ *           and decryption decodes the block into mArmored and then transforms it there, so each block is read
+ *           from memory once for both stages while it is still in the cache. A slot of length 0 (the end of the
+ *           input) ends the armor. pPhase is the key index of the first byte.
+ * RETURNS:  The key index following the last byte.
+ *------------------------------------------------------------------------------------------------------------*/
+static size_t StreamTransform
+    (
+    StreamPipe          *pPipe,
+    StreamSlot          *pSlot,
+    const VigenereSched *pSched,
+    size_t               pPhase
+    )
+{
+    ArmorState *armor = &pPipe->mArmor;
+    size_t n;
+
+    if (armor->mKind == ARMOR_NONE) {
+        pSlot->mOut = pSlot->mBuf;
+        pSlot->mOutLen = pSlot->mLen;
+        return PoolApply(pSched, pPhase, pSlot->mBuf, pSlot->mBuf, pSlot->mLen);
+    }
+    if (!armor->mDecode) pPhase = PoolApply(pSched, pPhase, pSlot->mBuf, pSlot->mBuf, pSlot->mLen);
+    n = ArmorRun(armor, pSlot->mBuf, pSlot->mLen, pSlot->mArmored);
+    if (pSlot->mLen == 0) n += ArmorEnd(armor, pSlot->mArmored + n);
+    if (armor->mDecode) pPhase = PoolApply(pSched, pPhase, pSlot->mArmored, pSlot->mArmored, n);
+    pSlot->mOut = pSlot->mArmored;
+    pSlot->mOutLen = n;
+    return pPhase;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamWriter
+ * DESCR:    The writer thread of the threaded pipeline. pArg is the StreamPipe. Writes the slots out in order
+ *           as they are transformed and marks them free for the reader. Stops after the slot of length 0 that
+ *           marks the end, which may still have armor to write (see StreamTransform()).
+ * RETURNS:  NULL.
+ *------------------------------------------------------------------------------------------------------------*/
+static void *StreamWriter
+    (
+    void *pArg
+    )
+{
+    StreamPipe *stream = pArg;
+    size_t seq, len;
+    StreamSlot *slot;
+
+    for (seq = 0; ; ++seq) {
+        slot = &stream->mSlot[seq % STREAM_SLOTS];
+        pthread_mutex_lock(&stream->mLock);
+        while (slot->mState != STREAM_WRITING) pthread_cond_wait(&stream->mChange, &stream->mLock);
+        pthread_mutex_unlock(&stream->mLock);
+        len = slot->mLen;
+        StreamWrite(stream->mOutFd, slot->mOut, slot->mOutLen);
+        pthread_mutex_lock(&stream->mLock);
+        slot->mState = STREAM_FREE;
+        pthread_cond_broadcast(&stream->mChange);
+        pthread_mutex_unlock(&stream->mLock);
+        if (len == 0) break;
+    }
+    return NULL;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StreamWrite
+ * DESCR:    Writes all pLen bytes of pBuf to file descriptor pFd. write() may write fewer bytes than it was
+ *           asked to (e.g., to a pipe), so it is called until everything has been written. Terminates with an
+ *           error message if a write fails.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void StreamWrite
+    (
+    int         pFd,
+    const char *pBuf,
+    size_t      pLen
+    )
+{
+    while (pLen > 0) {
+        ssize_t n = write(pFd, pBuf, pLen);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) MainTerminate(TERM_ERR_FILE, "could not write the message.\n");
+        pBuf += n;
+        pLen -= n;
+    }
+}
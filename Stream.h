@@ -0,0 +1,91 @@
+/***************************************************************************************************************
+ * FILE: Stream.h
+ *
+ * DESCRIPTION
+ * Streaming encryption/decryption. The message is read in blocks of STREAM_BLOCK_LEN bytes, each block is run
+ * through the key schedule and written out before the next block is read, and the key index is carried from
+ * one block to the next. Only one block is ever in memory, so there is no limit on the size of the message and
+ * the memory that is used does not depend on it. Every byte of the input is processed, including whitespace
+ * and newlines, which (like every other char outside 'A'..'Z') are passed through unchanged. The ciphertext may
+ * be armored as hex or base64 on its way out (encryption) or in (decryption), in the same pass (see Armor.h).
+ * StreamRunRange() runs only a byte range of a file (the --offset and --length options), reading nothing
+ * outside it. StreamRunContainer() writes or reads the ciphertext as a chunked container (see Container.h).
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#ifndef _STREAM_H_ /* Preprocessor guard to prevent Stream.h from being included more than once */
+#define _STREAM_H_ /* See comments in Main.h. */
+
+#include <stddef.h>    /* For size_t */
+#include "Types.h"     /* For bool */
+#include "Vigenere.h"  /* For VigenereCtx */
+
+/*==============================================================================================================
+ * Global function declarations.
+ *
+ * See comments in Main.h concerning what global function declarations are for.
+ *============================================================================================================*/
+extern size_t StreamFill
+    (
+    int     pFd,
+    char   *pBuf,
+    size_t  pLen
+    );
+
+extern size_t StreamRun
+    (
+    VigenereCtx *pCtx,
+    int          pInFd,
+    int          pOutFd,
+    int          pArmor,
+    bool         pUring,
+    bool         pSplice
+    );
+
+extern size_t StreamRunContainer
+    (
+    VigenereCtx *pCtx,
+    int          pInFd,
+    int          pOutFd
+    );
+
+extern size_t StreamRunMem
+    (
+    VigenereCtx *pCtx,
+    const char  *pIn,
+    size_t       pLen,
+    int          pOutFd,
+    int          pArmor
+    );
+
+extern size_t StreamRunRange
+    (
+    VigenereCtx *pCtx,
+    int          pInFd,
+    size_t       pOffset,
+    size_t       pLen,
+    int          pOutFd
+    );
+
+extern void StreamWrite
+    (
+    int         pFd,
+    const char *pBuf,
+    size_t      pLen
+    );
+
+#endif /* __STREAM_H__ */
@@ -21,6 +21,7 @@
  * 24 Jan 2012 [KRB] Initial revision.
  **************************************************************************************************************/
 #include <stdio.h>   /* For sprintf() */
+#include <stdlib.h>  /* For malloc() */
 #include "String.h"  /* Good to always include the module header file. See comments in Globals.c. */
 
 /*==============================================================================================================
@@ -63,3 +64,19 @@ char *StrCatInt
     strcat(pString, intBuf);
     return pString;
 }
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: StrDup
+ * DESCR:    Makes a copy of pString on the heap, as the POSIX strdup() does, which is not ANSI C.
+ * RETURNS:  A pointer to the copy, which the caller must free(), or NULL if there was not enough memory.
+ *------------------------------------------------------------------------------------------------------------*/
+char *StrDup
+    (
+    const char *pString
+    )
+{
+    char *copy = malloc(strlen(pString) + 1);
+
+    if (copy) strcpy(copy, pString);
+    return copy;
+}
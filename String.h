@@ -107,4 +107,9 @@ char *StrCatInt
     int   pInt
     );
 
+char *StrDup
+    (
+    const char *pString
+    );
+
 #endif /* __STRING_H__ */
@@ -20,10 +20,19 @@
  * -------------------------------------------------------------------------------------------------------------
  * 24 Jan 2012 [KRB] Initial revision.
  **************************************************************************************************************/
-#include <stdio.h>    /* For printf(), scanf() */
+#include <stdio.h>    /* For fgets(), printf(), scanf(), sprintf() */
+#include <string.h>   /* For strlen() */
 #include "Globals.h"  /* For BINARY */
+#include "Kernel.h"   /* For KernelGetName() */
 #include "View.h"     /* Good to always include the module header file. See comments in Globals.c. */
 
+/*==============================================================================================================
+ * Global preprocessor macros.
+ *
+ * VIEW_PERIODS is the most candidate key lengths ViewPrintPeriods() prints.
+ *============================================================================================================*/
+#define VIEW_PERIODS (10)
+
 /*==============================================================================================================
  * Function definitions.
  *============================================================================================================*/
@@ -65,18 +74,45 @@ char ViewGetChar
 	return fgetc(stdin);
 }
 
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ViewGetLine
+ * DESCR:    Reads a line, spaces and punctuation included, from stdin. The newline is not stored. At most
+ *           pMaxLen chars are read, so a longer line is cut off rather than overflowing pStr.
+ * RETURNS:  Nothing directly. The line is returned through the pStr parameter which has better be an array of
+ *           at least pMaxLen+1 chars.
+ *------------------------------------------------------------------------------------------------------------*/
+void ViewGetLine
+	(
+	char *pStr,
+	int   pMaxLen
+	)
+{
+	size_t len;
+
+	pStr[0] = '\0';
+	if (!fgets(pStr, pMaxLen + 1, stdin)) return;
+	len = strlen(pStr);
+	while (len > 0 && (pStr[len - 1] == '\n' || pStr[len - 1] == '\r')) pStr[--len] = '\0';
+}
+
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ViewGetStr
- * DESCR:    Reads a string (not containing whitespace) from stdin.
+ * DESCR:    Reads a string (not containing whitespace) from stdin. At most pMaxLen chars are read, so a longer
+ *           string is cut off rather than overflowing pStr.
  * RETURNS:  Nothing directly. The string is returned through the pStr parameter which has better be an array
- *           of chars large enough to store the string that was entered.
+ *           of at least pMaxLen+1 chars.
  *------------------------------------------------------------------------------------------------------------*/
 void ViewGetStr
 	(
-	char *pStr
+	char *pStr,
+	int   pMaxLen
 	)
 {
-	scanf("%s", pStr);
+	char fmt[32];
+
+	sprintf(fmt, "%%%ds", pMaxLen);
+	pStr[0] = '\0';
+	scanf(fmt, pStr);
 }
 
 /*--------------------------------------------------------------------------------------------------------------
@@ -94,22 +130,115 @@ void ViewHelp() {
      */
     printf("Encrypts or decrypts a message using the Vigenere cipher.\n\n"
 
-           "Usage: vigenere mode [-h] -k keyfile [-v]\n\n"
+           "Usage: vigenere mode [-a alphabet] [-b manifest] [-h] [-i infile] [-j threads] -k keyfile\n"
+           "              [--armor armor] [--binary] [--chain keyfile] [--container] [--kasiski]\n"
+           "              [--kernel tier] [--length bytes] [--max-period length] [--ngrams ngramfile]\n"
+           "              [--no-splice] [--no-uring] [--offset bytes] [-o outfile] [--period length]\n"
+           "              [--rekey keyfile] [-s] [-t] [-v]\n\n"
 
            "If performing encryption (mode = e), the plaintext is read from stdin and the ciphertext is\n"
            "written to stdout. If performing decryption (mode = d), the ciphertext is read from stdin and\n"
            "the plaintext is written to stdout. Modes are:\n\n"
 
            "\t  e  Encrypt the plaintext to produce the ciphertext using the specified key\n"
-           "\t  d  Decrypt the ciphertext to produce the plaintext using the specified key.\n\n"
+           "\t  d  Decrypt the ciphertext to produce the plaintext using the specified key.\n"
+           "\t  analyze  Finds the length of the key of the ciphertext (-i or stdin) and prints the likely\n"
+           "\t      key lengths, best first. -k is not needed. Use -t for a text mode ciphertext and -j to\n"
+           "\t      split the work across threads. For -i, or with --period, also recovers the key, assuming\n"
+           "\t      English plaintext, and prints it, and with -o writes it to 'outfile' as a key file.\n"
+           "\t  ngrams  Compiles the n-gram frequencies of the English text in 'infile' into a table file,\n"
+           "\t      'outfile', for --ngrams, which maps it rather than counting the text on every run. Needs\n"
+           "\t      -i and -o. -k is not needed. \"make corpus.ngr\" compiles corpus.txt the same way.\n\n"
 
            "Options:\n"
+           "\t  -a  Encrypts only the chars of 'alphabet' rather than 'A'..'Z'. 'alphabet' is upper, lower,\n"
+           "\t      alpha (A-Z and a-z), alnum (A-Z, a-z, and 0-9), print (' '..'~'), or the name of a file\n"
+           "\t      whose first line lists the chars in order. The key must only have chars in the alphabet.\n"
+           "\t  --armor  Writes the ciphertext as text, 'armor' is hex or base64, when encrypting, and reads\n"
+           "\t      it that way, skipping whitespace, when decrypting. The whole input is processed, as with\n"
+           "\t      -s. Cannot be used with -b, or with an 'outfile' that is 'infile'.\n"
+           "\t  -b  Runs every job listed in 'manifest', one per line as 'mode keyfile infile outfile', in\n"
+           "\t      one process. The mode and -k are not needed. Use -j to run the jobs in parallel.\n"
+           "\t  --binary  Binary mode: every byte of the message is shifted mod 256 by the key byte under it.\n"
+           "\t      The key is every byte of 'keyfile', newlines included. The whole input is processed,\n"
+           "\t      as with -s.\n"
+           "\t  --chain  Applies the key in 'keyfile' after the -k key, in the same mode, in the same\n"
+           "\t      pass over the message. 'd' with the same two keys undoes 'e'. Cannot be used with -b or\n"
+           "\t      --rekey.\n"
+           "\t  --container  Writes the ciphertext as a chunked container when encrypting, and reads one when\n"
+           "\t      decrypting: 1 MB chunks, each with its offset, key index, and CRC32C, and an index of the\n"
+           "\t      chunks at the end. Decryption checks every chunk, on -j threads, and cannot read a pipe.\n"
+           "\t      Cannot be used with -b, --armor, --offset, --length, or an 'outfile' that is 'infile'.\n"
            "\t  -h  Displays this help message and terminates without further processing.\n"
+           "\t  -i  Reads the message from 'infile' rather than stdin. The whole file is processed, as\n"
+           "\t      with -s.\n"
+           "\t  -j  Splits the work across 'threads' threads, or one per CPU if 'threads' is 0. Only used\n"
+           "\t      with -b, -i, -o, or -s. The output is the same for any number of threads.\n"
            "\t  -k  Reads the key from 'keyfile'.\n"
+           "\t  --kasiski  In analyze mode, finds the key length from the distances between repeated trigrams\n"
+           "\t      rather than by the index of coincidence, which is better for a short ciphertext.\n"
+           "\t  --kernel  Forces the kernel tier: scalar, swar, sse2, avx2, or avx512bw. The default is the\n"
+           "\t      fastest tier the CPU supports. The VIGENERE_KERNEL environment variable does the same.\n"
+           "\t  --length  Processes only 'bytes' bytes of 'infile', from --offset on, rather than the rest of\n"
+           "\t      the file. Needs -i.\n"
+           "\t  --max-period  Tries key lengths from 1 to 'length' (at most 256, 64 by default) in analyze\n"
+           "\t      mode.\n"
+           "\t  --ngrams  Recovers the key in analyze mode by hill climbing on the quadgrams of the\n"
+           "\t      plaintext, with the quadgram frequencies of 'ngramfile', English text or a table file\n"
+           "\t      compiled from it by the ngrams mode, rather than by letter frequencies. Better for a\n"
+           "\t      short ciphertext with a long key. Needs the 26 letters as the alphabet.\n"
+           "\t  --no-splice  Writes to a pipe with write() rather than vmsplice(), which is otherwise used\n"
+           "\t      when streaming from a pipe to a pipe. The output is the same either way.\n"
+           "\t  --no-uring  Streams with a reader and a writer thread rather than io_uring, which is\n"
+           "\t      otherwise used when the kernel supports it. The output is the same either way.\n"
+           "\t  --offset  Processes 'infile' from byte 'bytes' on, with the key where it falls at that byte,\n"
+           "\t      so a range of a large file can be decrypted without reading the bytes before it. Needs\n"
+           "\t      -i. Cannot be used with -b, -t, --armor, or an 'outfile' that is 'infile'.\n"
+           "\t  -o  Writes the result to 'outfile' rather than stdout. If 'outfile' is 'infile', the file is\n"
+           "\t      encrypted or decrypted in place. In analyze mode, writes the recovered key to 'outfile'.\n"
+           "\t  --period  Recovers the key for the key length 'length' in analyze mode, in one pass, rather\n"
+           "\t      than finding the length first. Cannot be used with --kasiski.\n"
+           "\t  --rekey  Re-keys ciphertext: decrypts it with the -k key and encrypts it with the key in\n"
+           "\t      'keyfile', in one pass, so the plaintext is never written anywhere. Needs mode 'd'. With\n"
+           "\t      an 'outfile' that is 'infile', the file is re-keyed in place. Cannot be used with -b,\n"
+           "\t      --armor, --chain, or --container.\n"
+           "\t  -s  Streams the message: every byte of stdin is processed in blocks until end of file, so\n"
+           "\t      there is no limit on its length. Chars outside the alphabet are copied unchanged.\n"
+           "\t  -t  Text mode: encrypts the letters of both cases and keeps their case, copies every other\n"
+           "\t      byte unchanged, and advances the key only on letters. The message is a whole line.\n"
+           "\t      Cannot be used with -a or --binary.\n"
            "\t  -v  Displays version info and terminates without further processing.\n");
 
 }
 
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: ViewPrintPeriods
+ * DESCR:    Prints the result of analyze mode to stdout: the number of letters that were analyzed, the key
+ *           length pBest that was picked, the key pKey that was recovered for it unless it is "", and the first
+ *           VIEW_PERIODS of the pCount candidate key lengths in pRank, best first, with their scores. pMethod
+ *           names the score, e.g., "IoC". Nothing is printed for the candidates if pCount is 0.
+ * RETURNS:  Nothing
+ *------------------------------------------------------------------------------------------------------------*/
+void ViewPrintPeriods
+    (
+    const char          *pMethod,
+    size_t               pLetters,
+    const AnalyzePeriod *pRank,
+    size_t               pCount,
+    size_t               pBest,
+    const char          *pKey
+    )
+{
+    size_t i;
+
+    printf("Letters: %lu\nKey length: %lu\n", (unsigned long)pLetters, (unsigned long)pBest);
+    if (pKey[0]) printf("Key: %s\n", pKey);
+    if (pCount) printf("Period  %s\n", pMethod);
+    for (i = 0; i < pCount && i < VIEW_PERIODS; ++i) {
+        printf("%6lu  %.3f\n", (unsigned long)pRank[i].mPeriod, pRank[i].mScore);
+    }
+}
+
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ViewPrintStr
  * DESCR:    Prints a string to stdout.
@@ -125,7 +254,7 @@ void ViewPrintStr
 
 /*--------------------------------------------------------------------------------------------------------------
  * FUNCTION: ViewVersion
- * DESCR:    Prints the version of the Vigenere cipher program.
+ * DESCR:    Prints the version of the Vigenere cipher program and the kernel tier that is in use.
  * RETURNS:  Nothing
  *------------------------------------------------------------------------------------------------------------*/
 void ViewVersion
@@ -133,4 +262,5 @@ void ViewVersion
     )
 {
     printf("Vigenere Cipher Version %s -- (c) %s %s\n", VERSION, COPY, AUTHOR);
+    printf("Kernel: %s\n", KernelGetName());
 }
@@ -23,6 +23,9 @@
 #ifndef _VIEW_H_ /* Preprocessor guard to prevent View.h from being included more than once */
 #define _VIEW_H_ /* See comments in Main.h. */
 
+#include <stddef.h>   /* For size_t */
+#include "Analyze.h"  /* For AnalyzePeriod */
+
 /*==============================================================================================================
  * Global function declarations.
  *
@@ -42,13 +45,30 @@ extern char ViewGetChar
 
 extern void ViewGetStr
 	(
-	char *pStr
+	char *pStr,
+	int   pMaxLen
+	);
+
+extern void ViewGetLine
+	(
+	char *pStr,
+	int   pMaxLen
 	);
 
 extern void ViewHelp
     (
     );
 
+extern void ViewPrintPeriods
+    (
+    const char          *pMethod,
+    size_t               pLetters,
+    const AnalyzePeriod *pRank,
+    size_t               pCount,
+    size_t               pBest,
+    const char          *pKey
+    );
+
 extern void ViewPrintStr
     (
     char *pString
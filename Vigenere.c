@@ -20,7 +20,9 @@
  * -------------------------------------------------------------------------------------------------------------
  * 24 Jan 2012 [KRB] Initial revision.
  **************************************************************************************************************/
-#include <string.h>    /* For strlen() */
+#include <stdlib.h>    /* For malloc(), free() */
+#include <string.h>    /* For memcmp(), memset(), strcmp(), strlen() */
+#include "Kernel.h"    /* For KernelVector() */
 #include "Vigenere.h"  /* Good to always include the module header file. See comments in Globals.c. */
 #include<stdio.h>
 
@@ -35,6 +37,26 @@ bool const VIGENERE_ENCRYPT = false;
 /* Declare a bool constant named VIGENERE_DECRYPT and initialize it to true. */
 bool const VIGENERE_DECRYPT = true;
 
+/*==============================================================================================================
+ * Static global variables.
+ *
+ * gAlphaNames lists the alphabets that can be named rather than spelled out (see VigenereAlphaNamed()). The
+ * first one is the default.
+ *============================================================================================================*/
+static const struct {
+    const char *mName;   /* The name of the alphabet */
+    const char *mChars;  /* The chars of the alphabet, in order */
+} gAlphaNames[] = {
+    { "upper", "ABCDEFGHIJKLMNOPQRSTUVWXYZ" },
+    { "lower", "abcdefghijklmnopqrstuvwxyz" },
+    { "alpha", "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz" },
+    { "alnum", "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789" },
+    { "print", " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`"
+               "abcdefghijklmnopqrstuvwxyz{|}~" }
+};
+
+#define ALPHA_NAMES ((int)(sizeof(gAlphaNames) / sizeof(gAlphaNames[0])))
+
 /*==============================================================================================================
  * Static function declarations.
  *============================================================================================================*/
@@ -126,20 +148,9 @@ char EncryptChar
  * RETURNS:  pOut is either the plaintext (if pMode is VIGENERE_DECRYPT) or ciphertext (if pMode is VIGENERE_
  *           ENCRYPT).
  *
- * PSEUDOCODE:
- * Define k as an int variable and initialize it to 0.
- * Define i as an int variable.
- * Set the first char of pOut to the null character '\0'.
- * For i <- 0 to strlen(pIn) - 1 Do (increment i by one each time thru the loop)
- *     If pMode is VIGENERE_ENCRYPT Then
- *         Set pOut[i] to EncryptChar(pIn, pKey[k], i)
- *     Else
- *         Set pOut[i] to DecryptChar(pIn, pKey[k], i)
- *     End If
- *     printf("%d\t%s\t%s\t%s\n", i, &pOut[i], &pKey[k], &pIn[i]);
- *     Set k to (k + 1) % strlen(pKey)
- * End For
- * Set pOut[i] to the null character '\0'
+ * NOTE:     This is a thin wrapper around VigenereLen() for callers that have C-strings. The lengths of pKey
+ *           and pIn are computed once here rather than on every iteration of the loop. pOut had better be
+ *           large enough to store strlen(pIn) + 1 chars.
  *------------------------------------------------------------------------------------------------------------*/
 void Vigenere
     (
@@ -149,23 +160,507 @@ void Vigenere
     char *pOut
     )
 {
-    int k = 0;
+    size_t len = strlen(pIn);
+
+    pOut[VigenereLen(pMode, pKey, strlen(pKey), pIn, len, pOut, len)] = '\0';
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereAdvance
+ *
+ * DESCR:    Counts how far the key advances over the pLen chars of pIn, which is pLen except for the text
+ *           alphabet, where it is the number of letters. The letter test is arithmetic rather than a lookup in
+ *           mIndex, so that the compiler can vectorize the loop. This lets a message be split into pieces that
+ *           are run at the same time: the key index of a piece is the key index of the message plus the sum
+ *           of VigenereAdvance() over the pieces before it.
+ *
+ * RETURNS:  The number of key indices that pIn covers (not reduced mod the key length).
+ *------------------------------------------------------------------------------------------------------------*/
+size_t VigenereAdvance
+    (
+    const VigenereSched *pSched,
+    const char          *pIn,
+    size_t               pLen
+    )
+{
+    const unsigned char *in = (const unsigned char *)pIn;
+    size_t i, n = 0;
+
+    if (!pSched->mAlpha.mText) return pLen;
+    for (i = 0; i < pLen; ++i) n += (unsigned char)((in[i] | 0x20) - 'a') < 26;
+    return n;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereAlphaBegin
+ *
+ * DESCR:    Compiles the alphabet made of the pLen chars of pChars (not null-terminated) into pAlpha. Index i
+ *           of the alphabet is pChars[i], i.e., the order of the chars is the order of the rows and columns of
+ *           the tabula recta.
+ *
+ * RETURNS:  true if the alphabet was compiled. false if it is empty, has more than VIGENERE_ALPHA_MAX chars, or
+ *           has a char twice, a NUL, or a char outside 7-bit ASCII.
+ *------------------------------------------------------------------------------------------------------------*/
+bool VigenereAlphaBegin
+    (
+    VigenereAlpha *pAlpha,
+    const char    *pChars,
+    size_t         pLen
+    )
+{
+    size_t i;
+
+    if (pLen == 0 || pLen > VIGENERE_ALPHA_MAX) return false;
+    memset(pAlpha->mIndex, VIGENERE_ALPHA_NONE, sizeof(pAlpha->mIndex));
+    memset(pAlpha->mChar, 0, sizeof(pAlpha->mChar));
+    pAlpha->mLen = pLen;
+    pAlpha->mBase = (unsigned char)pChars[0];
+    pAlpha->mRange = true;
+    pAlpha->mText = false;
+    pAlpha->mCase = 0;
+    for (i = 0; i < pLen; ++i) {
+        unsigned char c = (unsigned char)pChars[i];
+        if (c == 0 || c > 0x7F || pAlpha->mIndex[c] != VIGENERE_ALPHA_NONE) return false;
+        pAlpha->mIndex[c] = (unsigned char)i;
+        pAlpha->mChar[i] = pAlpha->mChar[pLen + i] = c;
+        if (c != pAlpha->mBase + i) pAlpha->mRange = false;
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereAlphaBinary
+ *
+ * DESCR:    Compiles the binary alphabet into pAlpha: every byte, 0x00..0xFF, at the index of its own value, so
+ *           that each byte of a message is shifted mod 256 by the key byte under it (see Vigenere.h).
+ *
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void VigenereAlphaBinary
+    (
+    VigenereAlpha *pAlpha
+    )
+{
     int i;
-    pOut[0]='\0';
 
+    pAlpha->mLen = VIGENERE_ALPHA_BYTES;
+    pAlpha->mRange = true;
+    pAlpha->mText = false;
+    pAlpha->mBase = 0;
+    pAlpha->mCase = 0;
+    for (i = 0; i < VIGENERE_ALPHA_BYTES; ++i) {
+        pAlpha->mIndex[i] = (unsigned char)i;
+        pAlpha->mChar[i] = pAlpha->mChar[VIGENERE_ALPHA_BYTES + i] = (unsigned char)i;
+    }
+}
 
-    for (i = 0; i < strlen(pIn); ++i)
-    {
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereAlphaNamed
+ *
+ * DESCR:    Looks up one of the named alphabets,
+ *
+ *           upper  'A'..'Z', the default
+ *           lower  'a'..'z'
+ *           alpha  'A'..'Z' then 'a'..'z'
+ *           alnum  'A'..'Z', 'a'..'z', then '0'..'9'
+ *           print  The printable ASCII chars, ' '..'~'
+ *
+ *           Passing NULL returns the default alphabet.
+ *
+ * RETURNS:  The chars of the alphabet, as a C-string, or NULL if there is no alphabet named pName.
+ *------------------------------------------------------------------------------------------------------------*/
+const char *VigenereAlphaNamed
+    (
+    const char *pName
+    )
+{
+    int i;
+
+    if (!pName) return gAlphaNames[0].mChars;
+    for (i = 0; i < ALPHA_NAMES; ++i) {
+        if (!strcmp(gAlphaNames[i].mName, pName)) return gAlphaNames[i].mChars;
+    }
+    return NULL;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereAlphaText
+ *
+ * DESCR:    Compiles the text alphabet into pAlpha: 'A'..'Z', with each of 'a'..'z' at the index of its
+ *           uppercase letter, letter case kept, and the key advancing only on letters (see Vigenere.h).
+ *
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void VigenereAlphaText
+    (
+    VigenereAlpha *pAlpha
+    )
+{
+    const char *upper = VigenereAlphaNamed(NULL);
+    int i;
 
-        if (pMode)
-        {
-        pOut[i]=DecryptChar(pIn, pKey[k], i);
+    VigenereAlphaBegin(pAlpha, upper, strlen(upper));
+    for (i = 0; i < 26; ++i) pAlpha->mIndex['a' + i] = (unsigned char)i;
+    pAlpha->mText = true;
+    pAlpha->mCase = 0x20;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereApply
+ *
+ * DESCR:    Runs the key schedule pSched over the pLen chars of pIn, storing the result in pOut. pPhase is the
+ *           key index of pIn[0], which lets a long message be processed in pieces: pass the value returned for
+ *           one piece as the pPhase of the next. pIn and pOut may be the same buffer. Chars outside the
+ *           alphabet are copied to pOut unchanged. The key still advances past them, except for the text
+ *           alphabet, where it advances only past letters and the case bit of each letter is kept.
+ *
+ *           The bulk of the message is handed to the vector kernel (see Kernel.h), which processes whole
+ *           vectors and returns how many chars it did. The remaining tail is done here with the lookup tables
+ *           of the alphabet, which are the tabula recta in another form: row r, column c is mChar[c + r].
+ *
+ * RETURNS:  The key index of the char following pIn[pLen-1].
+ *
+ * PSEUDOCODE:
+ * Set k to pPhase % the length of the schedule
+ * Set i to the number of chars done by KernelVector(), which advances k past them
+ * For i <- i to pLen - 1 Do
+ *     Set col to the index of pIn[i] in the alphabet
+ *     If pIn[i] is in the alphabet Then Set pOut[i] to the char at col + row k of the schedule, with the case
+ *         bit of pIn[i] if the alphabet is the text alphabet Else copy pIn[i]
+ *     If pIn[i] is in the alphabet or the alphabet is not the text alphabet Then
+ *         Set k to k + 1, wrapping to 0 at the end of the schedule
+ *     End If
+ * End For
+ * Return k
+ *------------------------------------------------------------------------------------------------------------*/
+size_t VigenereApply
+    (
+    const VigenereSched *pSched,
+    size_t               pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    )
+{
+    const unsigned char *shift = pSched->mShift;
+    const VigenereAlpha *alpha = &pSched->mAlpha;
+    size_t i, k = pPhase % pSched->mLen;
+
+    for (i = KernelVector(pSched, &k, pIn, pOut, pLen); i < pLen; ++i) {
+        unsigned col = alpha->mIndex[(unsigned char)pIn[i]];
+        if (col < alpha->mLen) {
+            pOut[i] = (char)(alpha->mChar[col + shift[k]] | (pIn[i] & alpha->mCase));
+        } else {
+            pOut[i] = pIn[i];
+            if (alpha->mText) continue;
         }
-        else
-        {
-        pOut[i]=EncryptChar(pIn, pKey[k], i);
+        if (++k == pSched->mLen) k = 0;
+    }
+    return k;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereCtxBegin
+ *
+ * DESCR:    Initializes the caller-owned context pCtx for mode pMode, the pKeyLen chars of pKey, and the
+ *           alphabet pAlpha (NULL for 'A'..'Z'), with the stream offset at the start of the message. Neither
+ *           pKey nor pAlpha is referenced after this returns.
+ *
+ * RETURNS:  true if the context is ready. false if the key schedule could not be built (see
+ *           VigenereSchedBegin()). Call VigenereCtxEnd() to free a context that was initialized.
+ *------------------------------------------------------------------------------------------------------------*/
+bool VigenereCtxBegin
+    (
+    VigenereCtx         *pCtx,
+    bool                 pMode,
+    const char          *pKey,
+    size_t               pKeyLen,
+    const VigenereAlpha *pAlpha
+    )
+{
+    pCtx->mMode = pMode;
+    pCtx->mPhase = 0;
+    return VigenereSchedBegin(&pCtx->mSched, pMode, pKey, pKeyLen, pAlpha);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereCtxEnd
+ *
+ * DESCR:    Frees the memory held by a context that was initialized by VigenereCtxBegin(). The context itself
+ *           belongs to the caller.
+ *
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void VigenereCtxEnd
+    (
+    VigenereCtx *pCtx
+    )
+{
+    VigenereSchedEnd(&pCtx->mSched);
+    pCtx->mPhase = 0;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereCtxFree
+ *
+ * DESCR:    Frees a context that was allocated by VigenereCtxNew(). pCtx may be NULL.
+ *
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void VigenereCtxFree
+    (
+    VigenereCtx *pCtx
+    )
+{
+    if (!pCtx) return;
+    VigenereCtxEnd(pCtx);
+    free(pCtx);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereCtxFuse
+ *
+ * DESCR:    Folds a second key into the context: after this, one run through pCtx is the same as a run through
+ *           pCtx as it was followed by a run with the pKeyLen chars of pKey in mode pMode (see
+ *           VigenereSchedFuse()). With the context in decrypt mode and pMode VIGENERE_ENCRYPT, this re-keys
+ *           ciphertext from the old key to pKey without the plaintext ever existing. The stream offset goes
+ *           back to the start of the message, and the mode of the context, which is what armor and containers
+ *           go by, is not changed.
+ *
+ * RETURNS:  true if the key was folded in. false if the schedule of pKey could not be built or the fused key
+ *           would be too long, in which case the context is unchanged.
+ *------------------------------------------------------------------------------------------------------------*/
+bool VigenereCtxFuse
+    (
+    VigenereCtx *pCtx,
+    bool         pMode,
+    const char  *pKey,
+    size_t       pKeyLen
+    )
+{
+    VigenereSched second, fused;
+
+    if (!VigenereSchedBegin(&second, pMode, pKey, pKeyLen, &pCtx->mSched.mAlpha)) return false;
+    if (!VigenereSchedFuse(&fused, &pCtx->mSched, &second)) {
+        VigenereSchedEnd(&second);
+        return false;
+    }
+    VigenereSchedEnd(&second);
+    VigenereSchedEnd(&pCtx->mSched);
+    pCtx->mSched = fused;
+    pCtx->mPhase = 0;
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereCtxNew
+ *
+ * DESCR:    Allocates a context on the heap and initializes it as VigenereCtxBegin() does.
+ *
+ * RETURNS:  The context, or NULL if the key schedule could not be built or memory could not be allocated.
+ *           Call VigenereCtxFree() to free it.
+ *------------------------------------------------------------------------------------------------------------*/
+VigenereCtx *VigenereCtxNew
+    (
+    bool                 pMode,
+    const char          *pKey,
+    size_t               pKeyLen,
+    const VigenereAlpha *pAlpha
+    )
+{
+    VigenereCtx *ctx = malloc(sizeof(VigenereCtx));
+
+    if (ctx && !VigenereCtxBegin(ctx, pMode, pKey, pKeyLen, pAlpha)) {
+        free(ctx);
+        ctx = NULL;
+    }
+    return ctx;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereCtxRun
+ *
+ * DESCR:    Runs the next pLen chars of the message, pIn, through the context, storing the result in pOut, and
+ *           advances the stream offset past them. Calling this once per piece of a message gives the same
+ *           result as calling it once for the whole message. pIn and pOut may be the same buffer.
+ *
+ * RETURNS:  The key index of the next char, which is also the new stream offset.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t VigenereCtxRun
+    (
+    VigenereCtx *pCtx,
+    const char  *pIn,
+    char        *pOut,
+    size_t       pLen
+    )
+{
+    pCtx->mPhase = VigenereApply(&pCtx->mSched, pCtx->mPhase, pIn, pOut, pLen);
+    return pCtx->mPhase;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereCtxSeek
+ *
+ * DESCR:    Moves the stream offset of the context to char pOffset of the message (letter pOffset for the text
+ *           alphabet), so the next call to VigenereCtxRun() starts there. VigenereCtxSeek(pCtx, 0) starts a new
+ *           message with the same key.
+ *
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void VigenereCtxSeek
+    (
+    VigenereCtx *pCtx,
+    size_t       pOffset
+    )
+{
+    pCtx->mPhase = pOffset % pCtx->mSched.mLen;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereLen
+ *
+ * DESCR:    Encrypts or decrypts pInLen chars of pIn with the pKeyLen chars of pKey, writing at most pOutSize
+ *           chars to pOut. Neither pIn nor pKey need to be null-terminated, and pOut is not null-terminated.
+ *           The key schedule is built once, so the cost is O(pKeyLen + pInLen). The alphabet is 'A'..'Z'.
+ *
+ * RETURNS:  The number of chars written to pOut, which is the smaller of pInLen and pOutSize. 0 is returned
+ *           if the key schedule could not be built.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t VigenereLen
+    (
+    bool        pMode,
+    const char *pKey,
+    size_t      pKeyLen,
+    const char *pIn,
+    size_t      pInLen,
+    char       *pOut,
+    size_t      pOutSize
+    )
+{
+    VigenereSched sched;
+    size_t len = pInLen < pOutSize ? pInLen : pOutSize;
+
+    if (!VigenereSchedBegin(&sched, pMode, pKey, pKeyLen, NULL)) return 0;
+    VigenereApply(&sched, 0, pIn, pOut, len);
+    VigenereSchedEnd(&sched);
+    return len;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereSchedBegin
+ *
+ * DESCR:    Builds the key schedule for the pKeyLen chars of pKey (which may include NULs for the binary
+ *           alphabet) and the alphabet pAlpha, which is copied into the schedule (NULL is 'A'..'Z'). For
+ *           encryption the row for key index k is the index of pKey[k] in the alphabet. For decryption it is
+ *           (n - that index) % n for an alphabet of n chars, i.e., decrypting with a key is the same as
+ *           encrypting with its inverse. The schedule is followed by VIGENERE_SCHED_PAD wrapped around shifts
+ *           for the vector kernels.
+ *
+ * RETURNS:  true if the schedule was built. false if pKeyLen is 0, a char of the key is not in the alphabet,
+ *           or memory for the schedule could not be allocated. Call VigenereSchedEnd() to free a schedule that
+ *           was built.
+ *------------------------------------------------------------------------------------------------------------*/
+bool VigenereSchedBegin
+    (
+    VigenereSched       *pSched,
+    bool                 pMode,
+    const char          *pKey,
+    size_t               pKeyLen,
+    const VigenereAlpha *pAlpha
+    )
+{
+    const char *upper;
+    size_t k, n;
+
+    pSched->mLen = 0;
+    pSched->mShift = NULL;
+    if (pAlpha) {
+        pSched->mAlpha = *pAlpha;
+    } else {
+        upper = VigenereAlphaNamed(NULL);
+        VigenereAlphaBegin(&pSched->mAlpha, upper, strlen(upper));
+    }
+    n = pSched->mAlpha.mLen;
+    if (pKeyLen == 0) return false;
+    pSched->mShift = malloc(pKeyLen + VIGENERE_SCHED_PAD);
+    if (!pSched->mShift) return false;
+    pSched->mLen = pKeyLen;
+    for (k = 0; k < pKeyLen; ++k) {
+        size_t row = pSched->mAlpha.mIndex[(unsigned char)pKey[k]];
+        if (row >= n) {
+            VigenereSchedEnd(pSched);
+            return false;
         }
-        k = (k+1)% strlen(pKey);
+        pSched->mShift[k] = pMode ? (n - row) % n : row;
+    }
+    for (k = 0; k < VIGENERE_SCHED_PAD; ++k) pSched->mShift[pKeyLen + k] = pSched->mShift[k % pKeyLen];
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereSchedEnd
+ *
+ * DESCR:    Frees the memory of a key schedule that was built by VigenereSchedBegin() or VigenereSchedFuse().
+ *
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void VigenereSchedEnd
+    (
+    VigenereSched *pSched
+    )
+{
+    free(pSched->mShift);
+    pSched->mShift = NULL;
+    pSched->mLen = 0;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereSchedFuse
+ *
+ * DESCR:    Builds the schedule of running a message through pFirst and then through pSecond, as one schedule.
+ *           Each pass adds the row under the key index to the column of each char, mod n, and both passes
+ *           advance the key on the same chars, so the two passes are one pass whose row for key index k is
+ *           pFirst's row for k mod a plus pSecond's row for k mod b, mod n, for keys of lengths a and b. That
+ *           pattern repeats every lcm(a, b) chars, which is the length of the fused key. The kernels see an
+ *           ordinary schedule, so a chain of keys, or decrypting with one key and encrypting with another,
+ *           costs one pass over the message instead of one per key.
+ *
+ * RETURNS:  true if the schedule was built. false if the two schedules do not have the same alphabet, the
+ *           fused key would be longer than VIGENERE_FUSE_MAX, or memory could not be allocated. Call
+ *           VigenereSchedEnd() to free a schedule that was built.
+ *------------------------------------------------------------------------------------------------------------*/
+bool VigenereSchedFuse
+    (
+    VigenereSched       *pSched,
+    const VigenereSched *pFirst,
+    const VigenereSched *pSecond
+    )
+{
+    size_t a = pFirst->mLen, b = pSecond->mLen, gcd = a, r = b, t, i = 0, j = 0, k, n = pFirst->mAlpha.mLen;
+
+    pSched->mLen = 0;
+    pSched->mShift = NULL;
+    pSched->mAlpha = pFirst->mAlpha;
+    if (n != pSecond->mAlpha.mLen || pFirst->mAlpha.mText != pSecond->mAlpha.mText ||
+        memcmp(pFirst->mAlpha.mIndex, pSecond->mAlpha.mIndex, sizeof(pFirst->mAlpha.mIndex))) {
+        return false;
+    }
+    while (r > 0) {
+        t = gcd % r;
+        gcd = r;
+        r = t;
+    }
+    if (a / gcd > VIGENERE_FUSE_MAX / b) return false;
+    pSched->mShift = malloc(a / gcd * b + VIGENERE_SCHED_PAD);
+    if (!pSched->mShift) return false;
+    pSched->mLen = a / gcd * b;
+    for (k = 0; k < pSched->mLen; ++k) {
+        pSched->mShift[k] = (pFirst->mShift[i] + pSecond->mShift[j]) % n;
+        if (++i == a) i = 0;
+        if (++j == b) j = 0;
+    }
+    for (k = 0; k < VIGENERE_SCHED_PAD; ++k) {
+        pSched->mShift[pSched->mLen + k] = pSched->mShift[k % pSched->mLen];
     }
-    pOut[i]='\0';
+    return true;
 }
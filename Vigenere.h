@@ -28,6 +28,7 @@
  * here, because I am going to use the "bool" type that was defined in Types.h. Look at lines 36 and 37 below.
  */
 
+#include <stddef.h>  /* For size_t */
 #include "Types.h"
 
 /*==============================================================================================================
@@ -35,10 +36,96 @@
  *============================================================================================================*/
 
 /* Declare a bool constant named VIGENERE_ENCRYPT. */
-bool const VIGENERE_ENCRYPT;
+extern bool const VIGENERE_ENCRYPT;
 
 /* Declare a bool constant named VIGENERE_DECRYPT. */
-bool const VIGENERE_DECRYPT;
+extern bool const VIGENERE_DECRYPT;
+
+/*==============================================================================================================
+ * Global preprocessor macros.
+ *
+ * VIGENERE_SCHED_PAD is the number of extra shifts stored after the end of a key schedule. The shifts wrap
+ * around, i.e., mShift[mLen + j] is mShift[j % mLen], so a vector kernel can load the shifts for the next 64
+ * chars with one unaligned load starting at any key index, no matter how short the key is.
+ *============================================================================================================*/
+#define VIGENERE_SCHED_PAD (64)
+
+/*
+ * VIGENERE_ALPHA_MAX is the most chars an alphabet can have. Alphabet chars are 7-bit ASCII, so that a vector
+ * kernel can look a char up with 8 16-entry shuffles. VIGENERE_ALPHA_NONE is the index of a byte that is not
+ * in the alphabet.
+ */
+#define VIGENERE_ALPHA_MAX  (127)
+#define VIGENERE_ALPHA_NONE (0xFF)
+
+/*
+ * VIGENERE_ALPHA_BYTES is the length of the binary alphabet (see VigenereAlphaBinary()), which has every byte
+ * value in it, so it is not bound by VIGENERE_ALPHA_MAX, and no byte is ever VIGENERE_ALPHA_NONE.
+ */
+#define VIGENERE_ALPHA_BYTES (256)
+
+/*
+ * VIGENERE_FUSE_MAX is the longest key VigenereSchedFuse() will build. A fused key is as long as the least
+ * common multiple of the lengths of its keys, e.g., 16 MB for two keys of 4096 and 4095 chars.
+ */
+#define VIGENERE_FUSE_MAX (1 << 24)
+
+/*==============================================================================================================
+ * Global type definitions.
+ *
+ * A VigenereAlpha is the alphabet of the cipher, which is 'A'..'Z' unless another one is asked for (see
+ * VigenereAlphaNamed()). It is compiled by VigenereAlphaBegin() into a pair of lookup tables: mIndex maps a
+ * byte to its index in the alphabet (VIGENERE_ALPHA_NONE if the byte is not in it, in which case the byte is
+ * copied unchanged) and mChar maps an index back to a byte. mChar holds the alphabet twice, so that the index
+ * of a char plus the row of a key char, which is less than 2 * mLen, can be looked up without a mod. When the
+ * alphabet is a run of consecutive bytes, e.g., 'a'..'z' or ' '..'~', mRange is set and the vector kernels use
+ * arithmetic on mBase and mLen rather than the tables.
+ *
+ * The text alphabet (see VigenereAlphaText()) is 'A'..'Z' with 'a'..'z' mapped to the same indices. It is for
+ * ordinary text: a letter is encrypted or decrypted and keeps its case (mCase is the case bit, which is or'ed
+ * back into the result), every other byte is copied, and, unlike every other alphabet, the key advances only
+ * on letters. So, "Attack at dawn!" with key LEMON is "Lxfopv ef rnhr!".
+ *
+ * The binary alphabet (see VigenereAlphaBinary()) is every byte, 0x00..0xFF, in order, so each byte of the
+ * message is shifted mod 256 by the byte of the key under it. It is a range (base 0, length 256), and since
+ * 256 wraps to 0 in a byte, the range arithmetic of the vector kernels is just a wrapping add for it.
+ *============================================================================================================*/
+typedef struct {
+    size_t        mLen;                          /* The number of chars, 1..VIGENERE_ALPHA_MAX (256 binary) */
+    bool          mRange;                        /* true if the alphabet is mBase, mBase + 1, ... */
+    bool          mText;                         /* true for the text alphabet, see above */
+    unsigned char mBase;                         /* The first char of the alphabet */
+    unsigned char mCase;                         /* 0x20 for the text alphabet, else 0 */
+    unsigned char mIndex[256];                   /* mIndex[b] is the index of byte b, or VIGENERE_ALPHA_NONE */
+    unsigned char mChar[2 * 256];                /* mChar[i] is the char at index i % mLen, i < 2 * mLen */
+} VigenereAlpha;
+
+/*
+ * A VigenereSched is the key schedule. It is built once from the key by VigenereSchedBegin() and holds, for
+ * each key index k, the row of the tabula recta that is used to encrypt or decrypt the character under key
+ * index k. The row already accounts for the mode (for decryption the row is (n - index of key[k]) % n, for an
+ * alphabet of n chars), so the kernel does not need to know whether it is encrypting or decrypting. It only
+ * needs to look up a char. The schedule has its own copy of the alphabet.
+ */
+typedef struct {
+    size_t         mLen;    /* The number of entries in mShift, i.e., the length of the key */
+    unsigned char *mShift;  /* mShift[k] is the tabula recta row for key index k, 0..n-1. Padded, see above */
+    VigenereAlpha  mAlpha;  /* The alphabet */
+} VigenereSched;
+
+/*
+ * A VigenereCtx is everything one encryption or decryption needs: the mode, the key schedule, and the stream
+ * offset, i.e., the key index of the next char (the number of chars, or of letters for the text alphabet,
+ * before it, mod the key length). Nothing about a message lives in a global, so any number of
+ * contexts, with different keys and modes, can be used at once from any number of threads, as long as each
+ * context is used by one thread at a time. A context may be owned by the caller (VigenereCtxBegin() and
+ * VigenereCtxEnd()) or allocated on the heap (VigenereCtxNew() and VigenereCtxFree()).
+ */
+typedef struct {
+    bool          mMode;   /* VIGENERE_ENCRYPT or VIGENERE_DECRYPT */
+    VigenereSched mSched;  /* The key schedule for the key and mMode */
+    size_t        mPhase;  /* The key index of the next char to be run through the context */
+} VigenereCtx;
 
 /*==============================================================================================================
  * Global function declarations.
@@ -53,4 +140,123 @@ extern void Vigenere
     char *pOut
     );
 
+extern size_t VigenereAdvance
+    (
+    const VigenereSched *pSched,
+    const char          *pIn,
+    size_t               pLen
+    );
+
+extern bool VigenereAlphaBegin
+    (
+    VigenereAlpha *pAlpha,
+    const char    *pChars,
+    size_t         pLen
+    );
+
+extern void VigenereAlphaBinary
+    (
+    VigenereAlpha *pAlpha
+    );
+
+extern const char *VigenereAlphaNamed
+    (
+    const char *pName
+    );
+
+extern void VigenereAlphaText
+    (
+    VigenereAlpha *pAlpha
+    );
+
+extern size_t VigenereApply
+    (
+    const VigenereSched *pSched,
+    size_t               pPhase,
+    const char          *pIn,
+    char                *pOut,
+    size_t               pLen
+    );
+
+extern bool VigenereCtxBegin
+    (
+    VigenereCtx         *pCtx,
+    bool                 pMode,
+    const char          *pKey,
+    size_t               pKeyLen,
+    const VigenereAlpha *pAlpha
+    );
+
+extern void VigenereCtxEnd
+    (
+    VigenereCtx *pCtx
+    );
+
+extern void VigenereCtxFree
+    (
+    VigenereCtx *pCtx
+    );
+
+extern bool VigenereCtxFuse
+    (
+    VigenereCtx *pCtx,
+    bool         pMode,
+    const char  *pKey,
+    size_t       pKeyLen
+    );
+
+extern VigenereCtx *VigenereCtxNew
+    (
+    bool                 pMode,
+    const char          *pKey,
+    size_t               pKeyLen,
+    const VigenereAlpha *pAlpha
+    );
+
+extern size_t VigenereCtxRun
+    (
+    VigenereCtx *pCtx,
+    const char  *pIn,
+    char        *pOut,
+    size_t       pLen
+    );
+
+extern void VigenereCtxSeek
+    (
+    VigenereCtx *pCtx,
+    size_t       pOffset
+    );
+
+extern size_t VigenereLen
+    (
+    bool        pMode,
+    const char *pKey,
+    size_t      pKeyLen,
+    const char *pIn,
+    size_t      pInLen,
+    char       *pOut,
+    size_t      pOutSize
+    );
+
+extern bool VigenereSchedBegin
+    (
+    VigenereSched       *pSched,
+    bool                 pMode,
+    const char          *pKey,
+    size_t               pKeyLen,
+    const VigenereAlpha *pAlpha
+    );
+
+extern void VigenereSchedEnd
+    (
+    VigenereSched *pSched
+    );
+
+extern bool VigenereSchedFuse
+    (
+    VigenereSched       *pSched,
+    const VigenereSched *pFirst,
+    const VigenereSched *pSecond
+    );
+
 #endif /* __VIGENERE_H__ */
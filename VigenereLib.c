@@ -0,0 +1,368 @@
+/***************************************************************************************************************
+ * FILE: VigenereLib.c
+ *
+ * DESCRIPTION
+ * See comments in VigenereLib.h. The functions here only wrap the Kernel and Vigenere modules. None of them
+ * calls MainTerminate(), or uses the Model, so the library does not contain Main.o and an error is always
+ * returned to the caller.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+
+/*
+ * pread() is POSIX, not ANSI C, so with -ansi it is not declared unless we ask for it. This must come before
+ * any #include.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>        /* For isspace() */
+#include <errno.h>        /* For errno, EINTR */
+#include <stdio.h>        /* For fopen(), getc(), fclose() */
+#include <stdlib.h>       /* For malloc(), realloc(), free() */
+#include <unistd.h>       /* For pread() */
+#include "Container.h"    /* For ContainerOpen(), ContainerRead(), ContainerWrite(), CONTAINER_CHUNK_LEN, ... */
+#include "Kernel.h"       /* For KernelBegin(), KernelGetName(), KernelSelect() */
+#include "Vigenere.h"     /* For VigenereAlphaBegin(), VigenereAlphaBinary(), VigenereApply(), ... */
+#include "VigenereLib.h"  /* Good to always include the module header file. See comments in Globals.c. */
+
+/*==============================================================================================================
+ * Global type definitions.
+ *
+ * The definitions of the opaque VigenereLibKey and VigenereLibContainer. The mode is already folded into the
+ * schedule.
+ *============================================================================================================*/
+struct VigenereLibKey {
+    VigenereSched mSched;
+};
+
+struct VigenereLibContainer {
+    ContainerReader mReader;
+};
+
+/*==============================================================================================================
+ * Function definitions.
+ *============================================================================================================*/
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereLibBatch
+ * DESCR:    Encrypts or decrypts each of the pCount messages of pMsgs with pKey. Each message starts at key
+ *           index 0, i.e., the messages are independent of each other.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void VigenereLibBatch
+    (
+    const VigenereLibKey *pKey,
+    const VigenereLibMsg *pMsgs,
+    size_t                pCount
+    )
+{
+    size_t i;
+
+    for (i = 0; i < pCount; ++i) VigenereApply(&pKey->mSched, 0, pMsgs[i].mIn, pMsgs[i].mOut, pMsgs[i].mLen);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereLibContainerClose
+ * DESCR:    Frees a container opened by VigenereLibContainerOpen(). Its file is not closed.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void VigenereLibContainerClose
+    (
+    VigenereLibContainer *pContainer
+    )
+{
+    if (!pContainer) return;
+    ContainerClose(&pContainer->mReader);
+    free(pContainer);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereLibContainerOpen
+ * DESCR:    Opens the chunked container in the file open on pFd, reading and checking its index. pFd must be a
+ *           file, not a pipe, and must stay open until the container is closed.
+ * RETURNS:  The container, with the number of chunks in *pNumChunks and the length of the longest chunk, which
+ *           is the buffer length VigenereLibContainerRead() needs, in *pChunkLen. NULL if pFd is not a
+ *           container, its index is damaged, or memory cannot be allocated.
+ *------------------------------------------------------------------------------------------------------------*/
+VigenereLibContainer *VigenereLibContainerOpen
+    (
+    int     pFd,
+    size_t *pNumChunks,
+    size_t *pChunkLen
+    )
+{
+    VigenereLibContainer *container = malloc(sizeof(VigenereLibContainer));
+
+    if (!container) return NULL;
+    KernelBegin();
+    if (!ContainerOpen(&container->mReader, pFd)) {
+        free(container);
+        return NULL;
+    }
+    *pNumChunks = container->mReader.mNumChunks;
+    *pChunkLen = container->mReader.mChunkLen;
+    return container;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereLibContainerRead
+ * DESCR:    Reads chunk number pChunk of the container into pBuf, which must have room for the chunk length,
+ *           checks its CRC, and, if pKey is not NULL, decrypts it in place starting at the key index recorded
+ *           in its header. The chunk is read with pread(), so any number of threads may read chunks of one
+ *           container at once. If pOffset is not NULL, the byte offset of the chunk in the message is returned
+ *           in *pOffset.
+ * RETURNS:  The number of bytes in the chunk, or -1 if it could not be read or is damaged.
+ *------------------------------------------------------------------------------------------------------------*/
+long VigenereLibContainerRead
+    (
+    const VigenereLibContainer *pContainer,
+    const VigenereLibKey       *pKey,
+    size_t                      pChunk,
+    char                       *pBuf,
+    size_t                     *pOffset
+    )
+{
+    long len = ContainerRead(&pContainer->mReader, pChunk, pBuf);
+
+    if (len < 0) return -1;
+    if (pKey) {
+        VigenereApply(&pKey->mSched, pContainer->mReader.mChunks[pChunk].mPhase % pKey->mSched.mLen, pBuf, pBuf,
+                      len);
+    }
+    if (pOffset) *pOffset = pContainer->mReader.mChunks[pChunk].mOffset;
+    return len;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereLibContainerWrite
+ * DESCR:    Encrypts (or decrypts) the pLen bytes at pIn with pKey and writes the result to pFd as a chunked
+ *           container with chunks of pChunkLen bytes, or of 1 MB if pChunkLen is 0. pFd may be a pipe.
+ * RETURNS:  0 if the container was written, or -1 if a write failed, memory cannot be allocated, or pChunkLen
+ *           is more than 1 GB.
+ *------------------------------------------------------------------------------------------------------------*/
+int VigenereLibContainerWrite
+    (
+    const VigenereLibKey *pKey,
+    const char           *pIn,
+    size_t                pLen,
+    size_t                pChunkLen,
+    int                   pFd
+    )
+{
+    ContainerWriter writer;
+    size_t n, phase = 0, next;
+    char *buf;
+    bool ok;
+
+    if (pChunkLen == 0) pChunkLen = CONTAINER_CHUNK_LEN;
+    if (!ContainerWriteBegin(&writer, pFd, pChunkLen)) return -1;
+    buf = malloc(pChunkLen);
+    ok = buf != NULL;
+    for (; ok && pLen > 0; pIn += n, pLen -= n) {
+        n = pLen < pChunkLen ? pLen : pChunkLen;
+        next = VigenereApply(&pKey->mSched, phase, pIn, buf, n);
+        ok = ContainerWrite(&writer, buf, n, phase);
+        phase = next;
+    }
+    free(buf);
+    ok = ContainerWriteEnd(&writer) && ok;
+    return ok ? 0 : -1;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereLibKernel
+ * DESCR:    If pName is not NULL, forces the kernel tier named pName ("scalar", "swar", "sse2", "avx2", or
+ *           "avx512bw") to be used by every key. By default the fastest tier this CPU supports is used. The
+ *           tier is global to the process, so only select it before the first key is applied, and not while
+ *           other threads use the library.
+ * RETURNS:  The name of the tier that is in use, or NULL if there is no tier named pName or this CPU does not
+ *           support it, in which case the tier in use is not changed.
+ *------------------------------------------------------------------------------------------------------------*/
+const char *VigenereLibKernel
+    (
+    const char *pName
+    )
+{
+    KernelBegin();
+    if (pName && !KernelSelect(pName)) return NULL;
+    return KernelGetName();
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereLibKeyFree
+ * DESCR:    Frees a key that was built by VigenereLibKeyLoad() or VigenereLibKeyNew(). pKey may be NULL.
+ * RETURNS:  Nothing.
+ *------------------------------------------------------------------------------------------------------------*/
+void VigenereLibKeyFree
+    (
+    VigenereLibKey *pKey
+    )
+{
+    if (!pKey) return;
+    VigenereSchedEnd(&pKey->mSched);
+    free(pKey);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereLibKeyLoad
+ * DESCR:    Reads the key from the key file named pFilename and builds the key for pMode (VIGENERE_LIB_ENCRYPT
+ *           or VIGENERE_LIB_DECRYPT, see VigenereLibKeyNew()). As with the -k option of the vigenere program,
+ *           the key is the first word of the file, so a trailing newline is ignored, except in binary mode,
+ *           where it is every byte of the file.
+ * RETURNS:  The key, which is freed with VigenereLibKeyFree(). NULL if the file cannot be read, is empty, has
+ *           a char that is not in 'A'..'Z', or memory cannot be allocated.
+ *------------------------------------------------------------------------------------------------------------*/
+VigenereLibKey *VigenereLibKeyLoad
+    (
+    const char *pFilename,
+    int         pMode
+    )
+{
+    bool binary = (pMode & VIGENERE_LIB_BINARY) != 0;
+    FILE *in = fopen(pFilename, binary ? "rb" : "r");
+    VigenereLibKey *key = NULL;
+    char *word = NULL, *grown;
+    size_t len = 0, size = 0;
+    int c;
+
+    if (!in) return NULL;
+    while ((c = getc(in)) != EOF && isspace(c) && !binary) ;
+    for (; c != EOF && (binary || !isspace(c)); c = getc(in)) {
+        if (len == size) {
+            size = size ? 2 * size : 64;
+            grown = realloc(word, size);
+            if (!grown) break;
+            word = grown;
+        }
+        word[len++] = (char)c;
+    }
+    if (len && (c == EOF || (!binary && isspace(c)))) key = VigenereLibKeyNew(word, len, pMode);
+    fclose(in);
+    free(word);
+    return key;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereLibKeyNew
+ * DESCR:    Builds the key for the first pKeyLen chars of pKey and pMode (VIGENERE_LIB_ENCRYPT or
+ *           VIGENERE_LIB_DECRYPT, either one or'ed with VIGENERE_LIB_TEXT for text mode or VIGENERE_LIB_BINARY
+ *           for binary mode). pKey does not have to be null-terminated.
+ * RETURNS:  The key, which is freed with VigenereLibKeyFree(). NULL if pKeyLen is 0, a char of the key is not
+ *           in 'A'..'Z', or memory cannot be allocated.
+ *------------------------------------------------------------------------------------------------------------*/
+VigenereLibKey *VigenereLibKeyNew
+    (
+    const char *pKey,
+    size_t      pKeyLen,
+    int         pMode
+    )
+{
+    return VigenereLibKeyNewAlpha(pKey, pKeyLen, NULL, 0, pMode);
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereLibKeyNewAlpha
+ * DESCR:    Same as VigenereLibKeyNew() but for the alphabet made of the pAlphabetLen chars of pAlphabet, in
+ *           order, e.g., "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789". The chars must be
+ *           distinct 7-bit ASCII chars other than NUL, at most 127 of them. If pAlphabet is NULL the alphabet
+ *           is 'A'..'Z'. pMode may not have VIGENERE_LIB_TEXT or VIGENERE_LIB_BINARY unless pAlphabet is NULL.
+ * RETURNS:  The key, which is freed with VigenereLibKeyFree(). NULL if the alphabet is not valid, pKeyLen is
+ *           0, a char of the key is not in the alphabet, or memory cannot be allocated.
+ *------------------------------------------------------------------------------------------------------------*/
+VigenereLibKey *VigenereLibKeyNewAlpha
+    (
+    const char *pKey,
+    size_t      pKeyLen,
+    const char *pAlphabet,
+    size_t      pAlphabetLen,
+    int         pMode
+    )
+{
+    VigenereLibKey *key = malloc(sizeof(VigenereLibKey));
+    bool text = (pMode & VIGENERE_LIB_TEXT) != 0, binary = (pMode & VIGENERE_LIB_BINARY) != 0, ok = true;
+    VigenereAlpha alpha;
+
+    if (!key) return NULL;
+    KernelBegin();
+    if (text || binary) {
+        if (text) VigenereAlphaText(&alpha);
+        else VigenereAlphaBinary(&alpha);
+        ok = !pAlphabet && !(text && binary);
+    } else if (pAlphabet) {
+        ok = VigenereAlphaBegin(&alpha, pAlphabet, pAlphabetLen);
+    }
+    if (!ok || !VigenereSchedBegin(&key->mSched, (pMode & VIGENERE_LIB_DECRYPT) != 0, pKey, pKeyLen,
+                                   text || binary || pAlphabet ? &alpha : NULL)) {
+        free(key);
+        return NULL;
+    }
+    return key;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereLibReadAt
+ * DESCR:    Reads the pLen bytes at byte offset pOffset of the file open on pFd into pBuf with pread(), and
+ *           encrypts or decrypts them in place, starting at the key index of pOffset. Only those bytes are read
+ *           and the file position of pFd does not move, so any number of threads may read ranges of one file at
+ *           once. A text mode key cannot be used, because the key index of a byte depends on the number of
+ *           letters before it.
+ * RETURNS:  The number of bytes read, which is less than pLen only at end of file, or -1 if the read failed or
+ *           pKey is a text mode key.
+ *------------------------------------------------------------------------------------------------------------*/
+long VigenereLibReadAt
+    (
+    const VigenereLibKey *pKey,
+    int                   pFd,
+    size_t                pOffset,
+    char                 *pBuf,
+    size_t                pLen
+    )
+{
+    size_t len = 0;
+    ssize_t n;
+
+    if (pKey->mSched.mAlpha.mText) return -1;
+    while (len < pLen) {
+        n = pread(pFd, pBuf + len, pLen - len, (off_t)(pOffset + len));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return -1;
+        if (n == 0) break;
+        len += n;
+    }
+    VigenereApply(&pKey->mSched, pOffset % pKey->mSched.mLen, pBuf, pBuf, len);
+    return (long)len;
+}
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: VigenereLibRun
+ * DESCR:    Encrypts or decrypts pLen bytes of a message that is longer than one buffer. pPhase is the key
+ *           index of the first byte, i.e., 0 for the first piece of the message and the return value of the
+ *           previous call for every other piece. It is taken mod the key length, so a piece that starts at
+ *           byte offset o of the message can also be run on its own with pPhase = o (letter o in text mode).
+ * RETURNS:  The key index of the byte that follows the piece.
+ *------------------------------------------------------------------------------------------------------------*/
+size_t VigenereLibRun
+    (
+    const VigenereLibKey *pKey,
+    size_t                pPhase,
+    const char           *pIn,
+    char                 *pOut,
+    size_t                pLen
+    )
+{
+    return VigenereApply(&pKey->mSched, pPhase % pKey->mSched.mLen, pIn, pOut, pLen);
+}
@@ -0,0 +1,198 @@
+/***************************************************************************************************************
+ * FILE: VigenereLib.h
+ *
+ * DESCRIPTION
+ * The public interface of libvigenere.a and libvigenere.so (build them with "make lib"). This is the only
+ * header a program that links with the library includes. It does not include any other header of the project,
+ * so it does not drag in the project's bool, and it can be included from C89, C99, or C++. Nothing in it will
+ * change incompatibly without VIGENERE_LIB_VERSION changing.
+ *
+ * A VigenereLibKey is a key schedule for one key and one mode. It is built once, from a key file with
+ * VigenereLibKeyLoad() or from a string with VigenereLibKeyNew(), and can then be used for any number of
+ * messages. A key is never changed after it is built, so one key may be used by any number of threads at once.
+ * VigenereLibBatch() encrypts or decrypts an array of messages in one call, each message starting at key
+ * index 0, so the cost of a call is spread across all of its messages:
+ *
+ *     VigenereLibKey *key = VigenereLibKeyLoad("key.txt", VIGENERE_LIB_ENCRYPT);
+ *     VigenereLibMsg  msgs[2] = { { "HELLO", out1, 5 }, { "WORLD", out2, 5 } };
+ *     VigenereLibBatch(key, msgs, 2);
+ *     VigenereLibKeyFree(key);
+ *
+ * As in the vigenere program, only the chars 'A'..'Z' are encrypted or decrypted, unless the key is built
+ * with another alphabet by VigenereLibKeyNewAlpha(). Every other byte is copied unchanged, and the output of
+ * a message is always exactly as long as its input. A mode or'ed with VIGENERE_LIB_TEXT builds the key for
+ * text mode (the -t option of the vigenere program): letters of both cases are encrypted or decrypted and
+ * keep their case, and the key, and so the phase of VigenereLibRun(), advances only on letters. A mode or'ed
+ * with VIGENERE_LIB_BINARY builds the key for binary mode (the --binary option): every byte is shifted mod 256
+ * by the key byte under it, the key may have any bytes in it, and VigenereLibKeyLoad() uses the whole file.
+ *
+ * The output at byte offset i of a message depends only on the input at i and the key at i mod the key length,
+ * so any range of a message can be run on its own: VigenereLibRun() with the offset of the range as its phase,
+ * or VigenereLibReadAt() to read the range of a file with pread() and run it in one call,
+ *
+ *     char window[4096];
+ *     long n = VigenereLibReadAt(key, fd, 50000000000, window, sizeof(window));
+ *
+ * VigenereLibContainerWrite() writes the ciphertext as a chunked container (the --container option): chunks
+ * that each record their offset, their key index, and a CRC32C, followed by an index of the chunks. A reader
+ * opens the container with VigenereLibContainerOpen(), and can then check and decrypt any chunk on its own with
+ * VigenereLibContainerRead(), from any number of threads, in text mode too.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#ifndef _VIGENERE_LIB_H_ /* Preprocessor guard to prevent VigenereLib.h from being included more than once */
+#define _VIGENERE_LIB_H_ /* See comments in Main.h. */
+
+#include <stddef.h>  /* For size_t */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*==============================================================================================================
+ * Global preprocessor macros.
+ *
+ * VIGENERE_LIB_API marks the functions that libvigenere.so exports. The library is compiled with
+ * -fvisibility=hidden, so every other function of the project stays private to it.
+ *============================================================================================================*/
+#define VIGENERE_LIB_VERSION (1)
+
+#define VIGENERE_LIB_ENCRYPT (0)
+#define VIGENERE_LIB_DECRYPT (1)
+#define VIGENERE_LIB_TEXT    (2)
+#define VIGENERE_LIB_BINARY  (4)
+
+#if defined(__GNUC__)
+#define VIGENERE_LIB_API __attribute__((visibility("default")))
+#else
+#define VIGENERE_LIB_API
+#endif
+
+/*==============================================================================================================
+ * Global type definitions.
+ *
+ * VigenereLibKey and VigenereLibContainer are opaque. A VigenereLibMsg is one message of a batch: mLen bytes
+ * are read from mIn and written to mOut. mIn and mOut may be the same buffer, which encrypts or decrypts the
+ * message in place.
+ *============================================================================================================*/
+typedef struct VigenereLibKey VigenereLibKey;
+
+typedef struct VigenereLibContainer VigenereLibContainer;
+
+typedef struct {
+    const char *mIn;   /* The message */
+    char       *mOut;  /* Where the encrypted or decrypted message is written, mLen bytes */
+    size_t      mLen;  /* The length of the message */
+} VigenereLibMsg;
+
+/*==============================================================================================================
+ * Global function declarations.
+ *
+ * See comments in Main.h concerning what global function declarations are for.
+ *============================================================================================================*/
+extern VIGENERE_LIB_API void VigenereLibBatch
+    (
+    const VigenereLibKey *pKey,
+    const VigenereLibMsg *pMsgs,
+    size_t                pCount
+    );
+
+extern VIGENERE_LIB_API void VigenereLibContainerClose
+    (
+    VigenereLibContainer *pContainer
+    );
+
+extern VIGENERE_LIB_API VigenereLibContainer *VigenereLibContainerOpen
+    (
+    int     pFd,
+    size_t *pNumChunks,
+    size_t *pChunkLen
+    );
+
+extern VIGENERE_LIB_API long VigenereLibContainerRead
+    (
+    const VigenereLibContainer *pContainer,
+    const VigenereLibKey       *pKey,
+    size_t                      pChunk,
+    char                       *pBuf,
+    size_t                     *pOffset
+    );
+
+extern VIGENERE_LIB_API int VigenereLibContainerWrite
+    (
+    const VigenereLibKey *pKey,
+    const char           *pIn,
+    size_t                pLen,
+    size_t                pChunkLen,
+    int                   pFd
+    );
+
+extern VIGENERE_LIB_API const char *VigenereLibKernel
+    (
+    const char *pName
+    );
+
+extern VIGENERE_LIB_API void VigenereLibKeyFree
+    (
+    VigenereLibKey *pKey
+    );
+
+extern VIGENERE_LIB_API VigenereLibKey *VigenereLibKeyLoad
+    (
+    const char *pFilename,
+    int         pMode
+    );
+
+extern VIGENERE_LIB_API VigenereLibKey *VigenereLibKeyNew
+    (
+    const char *pKey,
+    size_t      pKeyLen,
+    int         pMode
+    );
+
+extern VIGENERE_LIB_API VigenereLibKey *VigenereLibKeyNewAlpha
+    (
+    const char *pKey,
+    size_t      pKeyLen,
+    const char *pAlphabet,
+    size_t      pAlphabetLen,
+    int         pMode
+    );
+
+extern VIGENERE_LIB_API long VigenereLibReadAt
+    (
+    const VigenereLibKey *pKey,
+    int                   pFd,
+    size_t                pOffset,
+    char                 *pBuf,
+    size_t                pLen
+    );
+
+extern VIGENERE_LIB_API size_t VigenereLibRun
+    (
+    const VigenereLibKey *pKey,
+    size_t                pPhase,
+    const char           *pIn,
+    char                 *pOut,
+    size_t                pLen
+    );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __VIGENERE_LIB_H__ */
@@ -0,0 +1,411 @@
+/***************************************************************************************************************
+ * FILE: VigenereLib.hpp
+ *
+ * DESCRIPTION
+ * Header-only C++20 interface to libvigenere (see VigenereLib.h). A vigenere::Cipher owns the key schedule for
+ * one key and one mode and runs messages through the library kernel straight from a std::string_view or a
+ * std::span, into a buffer of the caller or into a std::string that is returned, so nothing has to be copied
+ * into a null-terminated char array first:
+ *
+ *     vigenere::Cipher enc("LEMON", vigenere::Mode::Encrypt);
+ *     std::string cipher = enc("ATTACKATDAWN");        // A new string
+ *     enc.Apply(std::span{in}, std::span{out});        // Into out, which must be as long as in
+ *     cipher = enc(std::move(cipher));                 // In place, no allocation
+ *
+ * The tabula recta is also built at compile time, and vigenere::Transform() uses it, so a message can be
+ * encrypted or decrypted in a constant expression:
+ *
+ *     constexpr auto cipher = vigenere::Transform<12>(vigenere::Mode::Encrypt, "LEMON", "ATTACKATDAWN");
+ *     // cipher holds the 12 chars of "LXFOPVEFRNHR"
+ *
+ * When the key is known at compile time, vigenere::FixedCipher<"KEY"> bakes the key schedule into the code
+ * (see below). Bench.cpp compares it with the run time kernels ("make bench").
+ *
+ * A Cipher is never changed after it is built, so it may be used by any number of threads at once. Errors
+ * are thrown: std::invalid_argument for an empty key, a key char outside the alphabet, or an invalid
+ * alphabet, std::runtime_error for a key file or a file range that cannot be read, and std::length_error for
+ * an output buffer that is too short. The constexpr Transform() and FixedCipher below are for 'A'..'Z' only.
+ *
+ * Link with libvigenere.a or libvigenere.so, and compile with -std=c++20.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#ifndef _VIGENERE_LIB_HPP_ /* Preprocessor guard to prevent VigenereLib.hpp from being included twice */
+#define _VIGENERE_LIB_HPP_ /* See comments in Main.h. */
+
+#include <array>          // For std::array
+#include <cstddef>        // For std::size_t
+#include <cstring>        // For std::memcpy()
+#include <memory>         // For std::unique_ptr
+#include <numeric>        // For std::lcm()
+#include <span>           // For std::span
+#include <stdexcept>      // For std::invalid_argument, std::length_error, std::runtime_error
+#include <string>         // For std::string
+#include <string_view>    // For std::string_view
+#include <type_traits>    // For std::is_constant_evaluated()
+#include <utility>        // For std::move, std::index_sequence
+#include "VigenereLib.h"  // For the C interface
+
+namespace vigenere {
+
+/*==============================================================================================================
+ * Type definitions.
+ *
+ * TabulaRecta[k][c] is the ciphertext letter for plaintext letter 'A' + c under key letter 'A' + k. Text<N>
+ * is the result of a compile-time Transform() of an N-char message.
+ *============================================================================================================*/
+enum class Mode { Encrypt = VIGENERE_LIB_ENCRYPT, Decrypt = VIGENERE_LIB_DECRYPT };
+
+using TabulaRecta = std::array<std::array<char, 26>, 26>;
+
+template <std::size_t N>
+using Text = std::array<char, N>;
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: MakeTabulaRecta
+ * DESCR:    Builds the tabula recta. It is constexpr, so gTabulaRecta below is built by the compiler.
+ * RETURNS:  The tabula recta.
+ *------------------------------------------------------------------------------------------------------------*/
+constexpr TabulaRecta MakeTabulaRecta
+    (
+    )
+{
+    TabulaRecta table{};
+    for (int k = 0; k < 26; ++k) {
+        for (int c = 0; c < 26; ++c) table[k][c] = static_cast<char>('A' + (k + c) % 26);
+    }
+    return table;
+}
+
+inline constexpr TabulaRecta gTabulaRecta = MakeTabulaRecta();
+
+/*--------------------------------------------------------------------------------------------------------------
+ * FUNCTION: Transform
+ * DESCR:    Encrypts or decrypts pIn with pKey by looking each char up in gTabulaRecta. This is the constexpr
+ *           version, for messages that are known at compile time. Like the library, it only changes 'A'..'Z'
+ *           and every message starts at key index 0. At run time use a Cipher, which uses the vector kernel.
+ * RETURNS:  The first N chars of the result (pIn must have at least N chars).
+ *------------------------------------------------------------------------------------------------------------*/
+template <std::size_t N>
+constexpr Text<N> Transform
+    (
+    Mode             pMode,
+    std::string_view pKey,
+    std::string_view pIn
+    )
+{
+    Text<N> out{};
+    std::size_t k = 0;
+    for (std::size_t i = 0; i < N; ++i, k = (k + 1) % pKey.size()) {
+        char c = pIn[i];
+        if (c >= 'A' && c <= 'Z') {
+            int row = ((pKey[k] - 'A') % 26 + 26) % 26;
+            if (pMode == Mode::Decrypt) row = (26 - row) % 26;
+            c = gTabulaRecta[row][c - 'A'];
+        }
+        out[i] = c;
+    }
+    return out;
+}
+
+/*==============================================================================================================
+ * CLASS: Cipher
+ *
+ * A key schedule for one key and one mode. A Cipher can be moved but not copied. Every message starts at key
+ * index 0, unless a phase is passed to Apply() to continue a message that is run in pieces.
+ *============================================================================================================*/
+class Cipher {
+public:
+    Cipher
+        (
+        std::string_view pKey,
+        Mode             pMode
+        )
+        : mKey(VigenereLibKeyNew(pKey.data(), pKey.size(), static_cast<int>(pMode)))
+    {
+        if (!mKey) throw std::invalid_argument("vigenere::Cipher: the key is empty or not in 'A'..'Z'");
+    }
+
+    /* The same, for an alphabet other than 'A'..'Z' (see VigenereLibKeyNewAlpha()). */
+    Cipher
+        (
+        std::string_view pKey,
+        std::string_view pAlphabet,
+        Mode             pMode
+        )
+        : mKey(VigenereLibKeyNewAlpha(pKey.data(), pKey.size(), pAlphabet.data(), pAlphabet.size(),
+                                      static_cast<int>(pMode)))
+    {
+        if (!mKey) throw std::invalid_argument("vigenere::Cipher: the key or the alphabet is not valid");
+    }
+
+    /* Reads the key from a key file, like the -k option of the vigenere program. */
+    static Cipher FromFile
+        (
+        const char *pFilename,
+        Mode        pMode
+        )
+    {
+        VigenereLibKey *key = VigenereLibKeyLoad(pFilename, static_cast<int>(pMode));
+        if (!key) {
+            throw std::runtime_error(std::string("vigenere::Cipher: could not read key file ") + pFilename);
+        }
+        return Cipher(key);
+    }
+
+    /* Runs pIn into pOut, which must be at least as long, and returns the phase of the char after pIn. */
+    std::size_t Apply
+        (
+        std::span<const char> pIn,
+        std::span<char>       pOut,
+        std::size_t           pPhase = 0
+        ) const
+    {
+        if (pOut.size() < pIn.size()) throw std::length_error("vigenere::Cipher: the output is too short");
+        return VigenereLibRun(mKey.get(), pPhase, pIn.data(), pOut.data(), pIn.size());
+    }
+
+    /* Runs pBuf in place and returns the phase of the char after pBuf. */
+    std::size_t Apply
+        (
+        std::span<char> pBuf,
+        std::size_t     pPhase = 0
+        ) const
+    {
+        return VigenereLibRun(mKey.get(), pPhase, pBuf.data(), pBuf.data(), pBuf.size());
+    }
+
+    /* Runs every message of pMsgs with one call into the library (see VigenereLibBatch()). */
+    void Batch
+        (
+        std::span<const VigenereLibMsg> pMsgs
+        ) const
+    {
+        VigenereLibBatch(mKey.get(), pMsgs.data(), pMsgs.size());
+    }
+
+    /* Returns a new string. */
+    std::string operator()
+        (
+        std::string_view pIn
+        ) const
+    {
+        std::string out(pIn.size(), '\0');
+        Apply(pIn, out);
+        return out;
+    }
+
+    /* Runs the string in place and moves it back out, so there is no allocation. */
+    std::string operator()
+        (
+        std::string &&pIn
+        ) const
+    {
+        Apply(std::span<char>(pIn));
+        return std::move(pIn);
+    }
+
+    /* Reads the bytes at pOffset of the file open on pFd into pBuf and runs them, starting at the key index
+     * of pOffset (see VigenereLibReadAt()). Returns the number of bytes read, less than pBuf.size() only at end
+     * of file. */
+    std::size_t ReadAt
+        (
+        int             pFd,
+        std::size_t     pOffset,
+        std::span<char> pBuf
+        ) const
+    {
+        long n = VigenereLibReadAt(mKey.get(), pFd, pOffset, pBuf.data(), pBuf.size());
+        if (n < 0) {
+            throw std::runtime_error("vigenere::Cipher: could not read the range (or the key is text mode)");
+        }
+        return static_cast<std::size_t>(n);
+    }
+
+    /* The kernel tier in use, or selects the one named pName (see VigenereLibKernel()). */
+    static const char *Kernel
+        (
+        const char *pName = nullptr
+        )
+    {
+        return VigenereLibKernel(pName);
+    }
+
+private:
+    struct KeyFree {
+        void operator()(VigenereLibKey *pKey) const { VigenereLibKeyFree(pKey); }
+    };
+
+    explicit Cipher
+        (
+        VigenereLibKey *pKey
+        )
+        : mKey(pKey)
+    {
+    }
+
+    std::unique_ptr<VigenereLibKey, KeyFree> mKey;
+};
+
+/*==============================================================================================================
+ * CLASS: FixedKey
+ *
+ * A key that is a template parameter, e.g., FixedCipher<"LEMON">. It only holds the chars of the string
+ * literal, so that the literal can be passed as a template argument.
+ *============================================================================================================*/
+template <std::size_t N>
+struct FixedKey {
+    constexpr FixedKey
+        (
+        const char (&pKey)[N]
+        )
+    {
+        for (std::size_t i = 0; i < N; ++i) mKey[i] = pKey[i];
+    }
+
+    char mKey[N];
+};
+
+/*==============================================================================================================
+ * CLASS: FixedCipher
+ *
+ * A cipher whose key and mode are known at compile time. The key schedule is a constexpr array of BLOCK
+ * shifts, BLOCK being the least common multiple of the key length and 64, so a block is a whole number of key
+ * periods and a whole number of 64-char vectors. Every vector of a block therefore has a shift vector that is
+ * a compile time constant, and the key index is never looked at or wrapped inside a block:
+ *
+ *     using Secret = vigenere::FixedCipher<"LEMON">;
+ *     Secret::Apply(in, out);
+ *
+ * With GCC and Clang a block is done with vector extensions, which the compiler lowers to whatever vector
+ * instructions the target has (build with -march=native to get AVX2 or AVX-512). Other compilers, and
+ * constant expressions, get a fold expression over the block. Everything is static and constexpr, so it can
+ * also be used in a constant expression. The output is the same as that of a Cipher with the same key and
+ * mode.
+ *============================================================================================================*/
+template <FixedKey Key, Mode M = Mode::Encrypt>
+class FixedCipher {
+public:
+    static constexpr std::size_t PERIOD = sizeof(Key.mKey) - 1;
+    static_assert(PERIOD > 0, "vigenere::FixedCipher: the key is empty");
+    static constexpr std::size_t BLOCK = std::lcm(PERIOD, std::size_t(64));
+
+    /* Runs pIn into pOut, which must be at least as long, and returns the phase of the char after pIn. */
+    static constexpr std::size_t Apply
+        (
+        std::span<const char> pIn,
+        std::span<char>       pOut,
+        std::size_t           pPhase = 0
+        )
+    {
+        std::size_t i = 0, k = pPhase % PERIOD, n = pIn.size();
+
+        if (pOut.size() < n) throw std::length_error("vigenere::FixedCipher: the output is too short");
+        for (; k != 0 && i < n; ++i, k = (k + 1) % PERIOD) pOut[i] = Shift(pIn[i], SHIFT[k]);
+        for (; i + BLOCK <= n; i += BLOCK) {
+            Block(pIn.data() + i, pOut.data() + i, std::make_index_sequence<BLOCK>{});
+        }
+        for (; i < n; ++i, ++k) pOut[i] = Shift(pIn[i], SHIFT[k]);
+        return k % PERIOD;
+    }
+
+    /* Runs pBuf in place and returns the phase of the char after pBuf. */
+    static constexpr std::size_t Apply
+        (
+        std::span<char> pBuf,
+        std::size_t     pPhase = 0
+        )
+    {
+        return Apply(std::span<const char>(pBuf), pBuf, pPhase);
+    }
+
+private:
+    /* The width of the vectors of Block(), the widest the target has. It divides BLOCK. */
+#if defined(__AVX512BW__)
+    static constexpr std::size_t VEC = 64;
+#elif defined(__AVX2__)
+    static constexpr std::size_t VEC = 32;
+#else
+    static constexpr std::size_t VEC = 16;
+#endif
+
+    /* SHIFT[j] is the tabula recta row for key index j % PERIOD, for j in 0..BLOCK-1. */
+    static constexpr std::array<unsigned char, BLOCK> MakeShift
+        (
+        )
+    {
+        std::array<unsigned char, BLOCK> shift{};
+        for (std::size_t j = 0; j < BLOCK; ++j) {
+            int row = ((Key.mKey[j % PERIOD] - 'A') % 26 + 26) % 26;
+            shift[j] = static_cast<unsigned char>(M == Mode::Decrypt ? (26 - row) % 26 : row);
+        }
+        return shift;
+    }
+
+    static constexpr std::array<unsigned char, BLOCK> SHIFT = MakeShift();
+
+    /* Encrypts/decrypts one char. Written without a branch on the char so that the block vectorizes. */
+    static constexpr char Shift
+        (
+        char     pChar,
+        unsigned pRow
+        )
+    {
+        unsigned char col = static_cast<unsigned char>(pChar - 'A');
+        unsigned char r = static_cast<unsigned char>(col + pRow);
+        r = r >= 26 ? r - 26 : r;
+        return col < 26 ? static_cast<char>('A' + r) : pChar;
+    }
+
+    /*
+     * One block, the key index of pIn[0] being 0. In the vector version the steps are those of KernelSse2()
+     * (see Kernel.c), on VEC chars at a time. In the fold version J... is 0..BLOCK-1, so the fold is fully
+     * unrolled, and the block is read into x before anything is written, so that the compiler does not have
+     * to assume that a store to pOut changes a later char of pIn (they may be the same buffer).
+     */
+    template <std::size_t... J>
+    static constexpr void Block
+        (
+        const char *pIn,
+        char       *pOut,
+        std::index_sequence<J...>
+        )
+    {
+#if defined(__GNUC__)
+        if (!std::is_constant_evaluated()) {
+            typedef unsigned char Vec __attribute__((vector_size(VEC)));
+            for (std::size_t v = 0; v < BLOCK; v += VEC) {
+                Vec x, row;
+                std::memcpy(&x, pIn + v, VEC);
+                std::memcpy(&row, SHIFT.data() + v, VEC);
+                Vec col = x - 'A';
+                Vec r = col + row;
+                r = r >= 26 ? r - 26 : r;
+                x = col < 26 ? r + 'A' : x;
+                std::memcpy(pOut + v, &x, VEC);
+            }
+            return;
+        }
+#endif
+        const std::array<char, BLOCK> x{pIn[J]...};
+        ((pOut[J] = Shift(x[J], SHIFT[J])), ...);
+    }
+};
+
+} // namespace vigenere
+
+#endif /* __VIGENERE_LIB_HPP__ */
@@ -122,6 +122,456 @@ TestDecrypt() {
 	fi
 }
 
+#----- TestStream ----------------------------------------------------------------------------------------------
+# Perform the encryption and decryption test case corresponding to the value of variable _tc using the
+# streaming mode (-s). The output must be identical to the output of the non-streaming mode. Encryption runs
+# from a file to a pipe (io_uring) and from a pipe to a pipe (vmsplice), and decryption reads from a pipe with
+# the threaded pipeline (--no-splice --no-uring), so every pipeline is tested.
+#---------------------------------------------------------------------------------------------------------------
+TestStream() {
+	echo -n Performing Streaming Test Case $_tc...
+
+	_cipher=cipher$_tc.correct
+	_key=key$_tc.txt
+	_plain=plain$_tc.txt
+
+	if $_binary e -s -k $_key < $_plain | cmp -s - $_cipher &&
+	   cat $_plain | $_binary e -s -k $_key | cmp -s - $_cipher &&
+	   cat $_cipher | $_binary d -s --no-splice --no-uring -k $_key | cmp -s - $_plain; then
+		echo "PASSED"
+	else
+		echo "FAILED. Streaming output differs from" $_cipher "or" $_plain
+	fi
+}
+
+#----- TestFiles -----------------------------------------------------------------------------------------------
+# Perform the encryption and decryption test case corresponding to the value of variable _tc using memory-
+# mapped files (-i and -o). Encryption is done in place, decryption from one file to another.
+#---------------------------------------------------------------------------------------------------------------
+TestFiles() {
+	echo -n Performing File Test Case $_tc...
+
+	_cipher=cipher$_tc.correct
+	_filetmp=filetmp$_tc.txt
+	_key=key$_tc.txt
+	_plain=plain$_tc.txt
+	_plainout=plainout$_tc.txt
+
+	cp $_plain $_filetmp
+	$_binary e -k $_key -i $_filetmp -o $_filetmp
+	$_binary d -k $_key -i $_filetmp -o $_plainout
+
+	if cmp -s $_filetmp $_cipher && cmp -s $_plainout $_plain; then
+		echo "PASSED"
+	else
+		echo "FAILED. Mapped file output differs from" $_cipher "or" $_plain
+	fi
+	rm -f $_filetmp $_plainout
+}
+
+#----- TestThreads ---------------------------------------------------------------------------------------------
+# Encrypt a file of 3 * 64 * 64 KiB + 1 bytes with -j 1, 2, 3, and 4. For each thread count the length of a
+# slice of the file is a multiple of 64 with a remainder left over, which must not make an extra slice. The
+# output must be the same for every thread count.
+#---------------------------------------------------------------------------------------------------------------
+TestThreads() {
+	echo -n Performing Threads Test...
+
+	yes THEQUICKBROWNFOXJUMPSOVERTHELAZYDOG | head -c 12582913 > threadsplain.txt
+	for _threads in 1 2 3 4; do
+		$_binary e -k key1.txt -i threadsplain.txt -o threadscipher$_threads.txt -j $_threads
+	done
+
+	if cmp -s threadscipher1.txt threadscipher2.txt && cmp -s threadscipher1.txt threadscipher3.txt &&
+	   cmp -s threadscipher1.txt threadscipher4.txt && ! cmp -s threadsplain.txt threadscipher1.txt; then
+		echo "PASSED"
+	else
+		echo "FAILED. Output with -j 2, 3, or 4 differs from -j 1"
+	fi
+	rm -f threadsplain.txt threadscipher1.txt threadscipher2.txt threadscipher3.txt threadscipher4.txt
+}
+
+#----- TestAlpha -----------------------------------------------------------------------------------------------
+# Perform the encryption and decryption of a mixed case message with digits using the alnum alphabet (-a).
+# Encryption streams from stdin, decryption maps the file with -i, and both must round trip the message.
+#---------------------------------------------------------------------------------------------------------------
+TestAlpha() {
+	echo -n Performing Alphabet Test...
+
+	if $_binary e -a alnum -s -k alphakey.txt < alphaplain.txt | cmp -s - alphacipher.correct &&
+	   $_binary d -a alnum -k alphakey.txt -i alphacipher.correct | cmp -s - alphaplain.txt; then
+		echo "PASSED"
+	else
+		echo "FAILED. Alphabet output differs from alphacipher.correct or alphaplain.txt"
+	fi
+}
+
+#----- TestText ------------------------------------------------------------------------------------------------
+# Perform the encryption and decryption of ordinary text, with mixed case, punctuation, and CR/LF line ends, in
+# text mode (-t). Encryption streams from stdin, decryption maps the file with -i on 4 threads, and both must
+# round trip the message. A single line is also read from stdin, spaces and all, as the message.
+#---------------------------------------------------------------------------------------------------------------
+TestText() {
+	echo -n Performing Text Test...
+
+	if $_binary e -t -s -k textkey.txt < textplain.txt | cmp -s - textcipher.correct &&
+	   $_binary d -t -j 4 -k textkey.txt -i textcipher.correct | cmp -s - textplain.txt &&
+	   [ "`echo 'Attack at dawn, Tango!' | $_binary e -t -k key1.txt`" = 'Ttggqd ag jopn, Ggbzo!' ]; then
+		echo "PASSED"
+	else
+		echo "FAILED. Text output differs from textcipher.correct, textplain.txt, or the expected line"
+	fi
+}
+
+#----- TestBinary ----------------------------------------------------------------------------------------------
+# Perform the encryption and decryption of random bytes in binary mode (--binary). The key has NUL, CR, LF, and
+# high bytes in it. Encryption streams from stdin, decryption maps the file with -i on 4 threads, and both must
+# round trip the bytes.
+#---------------------------------------------------------------------------------------------------------------
+TestBinary() {
+	echo -n Performing Binary Test...
+
+	if $_binary e --binary -s -k binkey.bin < binplain.bin | cmp -s - bincipher.correct &&
+	   $_binary d --binary -j 4 -k binkey.bin -i bincipher.correct | cmp -s - binplain.bin; then
+		echo "PASSED"
+	else
+		echo "FAILED. Binary output differs from bincipher.correct or binplain.bin"
+	fi
+}
+
+#----- TestArmor -----------------------------------------------------------------------------------------------
+# Perform the encryption and decryption of the binary test case with the ciphertext armored as base64 and as hex
+# (--armor). Encryption streams from stdin or maps the file with -i, decryption does the other on 4 threads, and
+# both must round trip the bytes. A file of more than 3 stream blocks piped to -s, whose last block is read
+# short, must be armored the same as base64 -w0 does with a key of NUL bytes.
+#---------------------------------------------------------------------------------------------------------------
+TestArmor() {
+	echo -n Performing Armor Test...
+
+	printf '\0' > armorkey.bin
+	yes THEQUICKBROWNFOXJUMPSOVERTHELAZYDOG | head -c 3146728 > armortmp.bin
+
+	if $_binary e --binary --armor base64 -s -k binkey.bin < binplain.bin | cmp -s - binbase64.correct &&
+	   $_binary d --binary --armor base64 -j 4 -k binkey.bin -i binbase64.correct | cmp -s - binplain.bin &&
+	   $_binary e --binary --armor hex -j 4 -k binkey.bin -i binplain.bin | cmp -s - binhex.correct &&
+	   $_binary d --binary --armor hex -s -k binkey.bin < binhex.correct | cmp -s - binplain.bin &&
+	   $_binary e --binary --armor base64 -s -k armorkey.bin < armortmp.bin |
+	       cmp -s - <(base64 -w0 armortmp.bin; echo); then
+		echo "PASSED"
+	else
+		echo "FAILED. Armor output differs from binbase64.correct, binhex.correct, binplain.bin, or base64 -w0"
+	fi
+	rm -f armorkey.bin armortmp.bin
+}
+
+#----- TestRange -----------------------------------------------------------------------------------------------
+# Perform the decryption of byte ranges of the ciphertext (--offset and --length), which must match the same
+# range of the plaintext: a range in the middle of the binary test case, a range that runs past the end of the
+# file, and the rest of test case 4 from an offset that is not a multiple of its key length on 4 threads.
+#---------------------------------------------------------------------------------------------------------------
+TestRange() {
+	echo -n Performing Range Test...
+
+	if $_binary d --binary --offset 1000 --length 100 -k binkey.bin -i bincipher.correct |
+	     cmp -s - <(tail -c +1001 binplain.bin | head -c 100) &&
+	   $_binary d --binary --offset 4000 --length 1000 -k binkey.bin -i bincipher.correct |
+	     cmp -s - <(tail -c +4001 binplain.bin) &&
+	   $_binary d --offset 777 -j 4 -k key4.txt -i cipher4.correct | cmp -s - <(tail -c +778 plain4.txt); then
+		echo "PASSED"
+	else
+		echo "FAILED. Range output differs from the same range of binplain.bin or plain4.txt"
+	fi
+}
+
+#----- TestContainer -------------------------------------------------------------------------------------------
+# Perform the encryption and decryption of test case 4 as a chunked container (--container), and of test case 4
+# repeated 300 times, which is more than one chunk, in text mode on 4 threads. A container with one byte of a
+# chunk changed must be rejected.
+#---------------------------------------------------------------------------------------------------------------
+TestContainer() {
+	echo -n Performing Container Test...
+
+	for _i in `seq 1 300`; do cat plain4.txt; done > contmp.txt
+	cp container4.correct contbad.vgc
+	printf 'X' | dd of=contbad.vgc bs=1 seek=100 conv=notrunc 2> /dev/null
+
+	if $_binary e --container -s -k key4.txt < plain4.txt | cmp -s - container4.correct &&
+	   $_binary d --container -j 4 -k key4.txt -i container4.correct | cmp -s - plain4.txt &&
+	   $_binary e -t --container -j 4 -k key4.txt -i contmp.txt -o contmp.vgc &&
+	   $_binary d -t --container -j 4 -k key4.txt -i contmp.vgc | cmp -s - contmp.txt &&
+	   ! $_binary d --container -k key4.txt -i contbad.vgc > /dev/null 2>&1; then
+		echo "PASSED"
+	else
+		echo "FAILED. Container output differs from container4.correct, plain4.txt, or contmp.txt"
+	fi
+	rm -f contmp.txt contmp.vgc contbad.vgc
+}
+
+#----- TestChain -----------------------------------------------------------------------------------------------
+# Encrypt test case 3 with two keys in one pass (--chain), and re-key the ciphertext of test case 3 to the keys
+# of test cases 2 and 4 in one pass (--rekey), the second in place, and the text mode ciphertext to key 1. Each
+# must match running the keys one at a time.
+#---------------------------------------------------------------------------------------------------------------
+TestChain() {
+	echo -n Performing Chain Test...
+
+	cp cipher3.correct chaintmp.txt
+
+	if $_binary e -s -k key1.txt < plain3.txt | $_binary e -s -k key2.txt > chaintwo.txt &&
+	   $_binary e -s -k key1.txt --chain key2.txt < plain3.txt | cmp -s - chaintwo.txt &&
+	   $_binary d -s -k key1.txt --chain key2.txt < chaintwo.txt | cmp -s - plain3.txt &&
+	   $_binary d -k key3.txt --rekey key2.txt -i cipher3.correct |
+	       cmp -s - <($_binary e -k key2.txt -i plain3.txt) &&
+	   $_binary d -j 4 -k key3.txt --rekey key4.txt -i chaintmp.txt -o chaintmp.txt &&
+	   $_binary e -k key4.txt -i plain3.txt | cmp -s - chaintmp.txt &&
+	   $_binary d -t -s -k textkey.txt --rekey key1.txt < textcipher.correct |
+	   cmp -s - <($_binary e -t -s -k key1.txt < textplain.txt); then
+		echo "PASSED"
+	else
+		echo "FAILED. Chained or re-keyed output differs from running the keys one at a time"
+	fi
+	rm -f chaintmp.txt chaintwo.txt
+}
+
+#----- TestAnalyze ---------------------------------------------------------------------------------------------
+# Find the key length of the text mode ciphertext (11, the length of textkey.txt), on 1 and on 4 threads, and of
+# the uppercase letters of the text mode plaintext encrypted with key 2 (13), read from stdin.
+#---------------------------------------------------------------------------------------------------------------
+TestAnalyze() {
+	echo -n Performing Analyze Test...
+
+	tr a-z A-Z < textplain.txt | tr -dc A-Z | $_binary e -s -k key2.txt > analyzetmp.txt
+
+	if $_binary analyze -t -i textcipher.correct | grep -qx 'Key length: 11' &&
+	   $_binary analyze -t -j 4 -i textcipher.correct | grep -qx 'Key length: 11' &&
+	   $_binary analyze --max-period 40 < analyzetmp.txt | grep -qx 'Key length: 13'; then
+		echo "PASSED"
+	else
+		echo "FAILED. Analyze did not find the key length of textcipher.correct or of key 2"
+	fi
+	rm -f analyzetmp.txt
+}
+
+#----- TestKasiski ---------------------------------------------------------------------------------------------
+# Find the key length of the text mode ciphertext (11) by Kasiski examination, and of the uppercase letters of
+# the text mode plaintext encrypted with keys 1 and 2 (5 and 13). A ciphertext with no repeated trigram must be
+# rejected as such, and one too short for the index of coincidence must be rejected as too short.
+#---------------------------------------------------------------------------------------------------------------
+TestKasiski() {
+	echo -n Performing Kasiski Test...
+
+	tr a-z A-Z < textplain.txt | tr -dc A-Z > kasiskitmp.txt
+
+	if $_binary analyze --kasiski -t -i textcipher.correct | grep -qx 'Key length: 11' &&
+	   $_binary e -k key1.txt -i kasiskitmp.txt | $_binary analyze --kasiski | grep -qx 'Key length: 5' &&
+	   $_binary e -k key2.txt -i kasiskitmp.txt | $_binary analyze --kasiski | grep -qx 'Key length: 13' &&
+	   $_binary analyze --kasiski -i cipher2.correct 2>&1 | grep -q 'no repeated trigrams' &&
+	   echo ABCDEFGHIJ | $_binary analyze 2>&1 | grep -q 'too short to find a key length'; then
+		echo "PASSED"
+	else
+		echo "FAILED. Kasiski examination did not find the key length of textcipher.correct or of key 1 or 2"
+	fi
+	rm -f kasiskitmp.txt
+}
+
+#----- TestSolve -----------------------------------------------------------------------------------------------
+# Recover the key of the text mode ciphertext, whose length analyze finds first, and check that the key file
+# that analyze writes decrypts it. Recover keys 1 and 2 from stdin for their known lengths (--period). A period
+# longer than the number of letters must be rejected.
+#---------------------------------------------------------------------------------------------------------------
+TestSolve() {
+	echo -n Performing Solve Test...
+
+	tr a-z A-Z < textplain.txt | tr -dc A-Z > solvetmp.txt
+
+	if $_binary analyze -t -i textcipher.correct -o solvekey.txt | grep -qx 'Key: WHITERABBIT' &&
+	   $_binary d -t -k solvekey.txt -i textcipher.correct | cmp -s - textplain.txt &&
+	   $_binary e -k key1.txt -i solvetmp.txt | $_binary analyze --period 5 | grep -qx 'Key: TANGO' &&
+	   $_binary e -k key2.txt -i solvetmp.txt | $_binary analyze --period 13 | grep -qx 'Key: VICTORYISNIGH' &&
+	   ! echo AB | $_binary analyze --period 5 > /dev/null 2>&1; then
+		echo "PASSED"
+	else
+		echo "FAILED. analyze did not recover the key of textcipher.correct or key 1 or 2"
+	fi
+	rm -f solvetmp.txt solvekey.txt
+}
+
+#----- TestClimb -----------------------------------------------------------------------------------------------
+# Recover a 34-char key from the uppercase letters of the text mode plaintext (about 56 letters per key char,
+# too few for letter frequencies) by quadgram hill climbing, with the plaintext as the corpus, on 1 and 3
+# threads. An alphabet that is not the 26 letters must be rejected.
+#---------------------------------------------------------------------------------------------------------------
+TestClimb() {
+	echo -n Performing Climb Test...
+
+	tr a-z A-Z < textplain.txt | tr -dc A-Z > climbtmp.txt
+	echo VICTORYISNIGHTANGOWHITERABBITLEMON > climbkey.txt
+
+	if $_binary e -k climbkey.txt -i climbtmp.txt | $_binary analyze --period 34 --ngrams textplain.txt |
+	       grep -qx 'Key: VICTORYISNIGHTANGOWHITERABBITLEMON' &&
+	   $_binary e -k climbkey.txt -i climbtmp.txt | $_binary analyze --period 34 --ngrams textplain.txt -j 3 |
+	       grep -qx 'Key: VICTORYISNIGHTANGOWHITERABBITLEMON' &&
+	   ! $_binary analyze -a alnum --ngrams textplain.txt -i textcipher.correct > /dev/null 2>&1; then
+		echo "PASSED"
+	else
+		echo "FAILED. Quadgram hill climbing did not recover the 34-char key"
+	fi
+	rm -f climbtmp.txt climbkey.txt
+}
+
+#----- TestNgrams ----------------------------------------------------------------------------------------------
+# Compile the text mode plaintext into an n-gram table file with the ngrams mode, which must be the same as the
+# table compiled from the table file itself, and recover the 34-char key of TestClimb with the mapped table. A
+# table file that is cut short must be rejected.
+#---------------------------------------------------------------------------------------------------------------
+TestNgrams() {
+	echo -n Performing Ngrams Test...
+
+	tr a-z A-Z < textplain.txt | tr -dc A-Z > ngramtmp.txt
+	echo VICTORYISNIGHTANGOWHITERABBITLEMON > ngramkey.txt
+
+	if $_binary ngrams -i textplain.txt -o ngramtmp.ngr && [ "$(wc -c < ngramtmp.ngr)" -eq 1901184 ] &&
+	   $_binary ngrams -i ngramtmp.ngr -o ngramcopy.ngr && cmp -s ngramtmp.ngr ngramcopy.ngr &&
+	   $_binary e -k ngramkey.txt -i ngramtmp.txt | $_binary analyze --period 34 --ngrams ngramtmp.ngr |
+	       grep -qx 'Key: VICTORYISNIGHTANGOWHITERABBITLEMON' &&
+	   head -c 100 ngramtmp.ngr > ngramcopy.ngr &&
+	   ! $_binary analyze --period 34 --ngrams ngramcopy.ngr -i ngramtmp.txt > /dev/null 2>&1; then
+		echo "PASSED"
+	else
+		echo "FAILED. The compiled n-gram table did not match or did not recover the 34-char key"
+	fi
+	rm -f ngramtmp.txt ngramkey.txt ngramtmp.ngr ngramcopy.ngr
+}
+
+#----- TestLongKey ---------------------------------------------------------------------------------------------
+# A key file with a key of 4096 chars, the longest there may be, must be read whole. One with a longer key must
+# be rejected, rather than overflowing the key buffer, both with -k and in a batch manifest.
+#---------------------------------------------------------------------------------------------------------------
+TestLongKey() {
+	echo -n Performing Long Key Test...
+
+	head -c 4096 /dev/zero | tr '\0' B > longkey.txt
+	echo "e longkey.txt plain1.txt longout.txt" > longmanifest.txt
+
+	if [ "$(echo HELLO | $_binary e -k longkey.txt)" = IFMMP ] && echo C >> longkey.txt &&
+	   ! echo HELLO | $_binary e -k longkey.txt > /dev/null 2>&1 &&
+	   ! $_binary -b longmanifest.txt > /dev/null 2>&1; then
+		echo "PASSED"
+	else
+		echo "FAILED. A 4096-char key was not read whole or a longer key was not rejected"
+	fi
+	rm -f longkey.txt longmanifest.txt longout.txt
+}
+
+#----- TestBatch -----------------------------------------------------------------------------------------------
+# Perform the encryption and decryption of every test case in one process with batch mode (-b). The manifest
+# lists an encryption and a decryption job for each test case. Then run four text mode jobs on a file that is
+# long enough for each job to split it across the pool with PoolApply() from inside its task, on 2 threads,
+# which must not wait on one another, and compare each to the output of the file on its own. Last, run a chain
+# of jobs that each read the output of the one before, and a job that overwrites a file an earlier job reads,
+# which must all see the files as if the jobs ran one after another.
+#---------------------------------------------------------------------------------------------------------------
+TestBatch() {
+	echo -n Performing Batch Test...
+
+	_manifest=manifest.txt
+	_failed=0
+
+	rm -f $_manifest
+	for _tc in `seq 1 4`; do
+		echo "e key$_tc.txt plain$_tc.txt batchcipher$_tc.txt" >> $_manifest
+		echo "d key$_tc.txt cipher$_tc.correct batchplain$_tc.txt" >> $_manifest
+	done
+	$_binary -b $_manifest -j 0
+
+	for _tc in `seq 1 4`; do
+		if ! cmp -s batchcipher$_tc.txt cipher$_tc.correct || ! cmp -s batchplain$_tc.txt plain$_tc.txt; then
+			_failed=1
+		fi
+		rm -f batchcipher$_tc.txt batchplain$_tc.txt
+	done
+
+	yes 'The quick brown fox, jumps over the lazy dog.' | head -c 9000000 > batchtext.txt
+	$_binary e -t -k textkey.txt -i batchtext.txt -o batchtextcipher.txt
+	rm -f $_manifest
+	for _tc in `seq 1 4`; do
+		echo "e textkey.txt batchtext.txt batchtext$_tc.txt" >> $_manifest
+	done
+	$_binary -t -b $_manifest -j 2
+	for _tc in `seq 1 4`; do
+		cmp -s batchtext$_tc.txt batchtextcipher.txt || _failed=1
+		rm -f batchtext$_tc.txt
+	done
+	rm -f $_manifest batchtext.txt batchtextcipher.txt
+
+	yes THEQUICKBROWNFOXJUMPSOVERTHELAZYDOG | head -c 20000000 > batchchain.txt
+	echo "e key1.txt batchchain.txt batchchain1.txt" > $_manifest
+	echo "d key1.txt batchchain1.txt batchchain2.txt" >> $_manifest
+	echo "e key2.txt batchchain2.txt batchchain3.txt" >> $_manifest
+	echo "e key2.txt plain2.txt batchchain1.txt" >> $_manifest
+	if ! $_binary -b $_manifest -j 0 2> /dev/null || ! cmp -s batchchain1.txt cipher2.correct ||
+	   ! cmp -s batchchain2.txt batchchain.txt ||
+	   ! $_binary e -k key2.txt -i batchchain.txt | cmp -s - batchchain3.txt; then
+		_failed=1
+	fi
+	rm -f $_manifest batchchain.txt batchchain1.txt batchchain2.txt batchchain3.txt
+
+	if [ $_failed = 1 ]; then
+		echo "FAILED. Batch output differs from the cipher or plain files"
+	else
+		echo "PASSED"
+	fi
+}
+
+#----- TestLib -------------------------------------------------------------------------------------------------
+# Perform the encryption and decryption of every test case with the library (see LibTest.c). Each plaintext is
+# encrypted twice in one batch with libtest, which is linked with libvigenere.a, and each ciphertext is
+# decrypted twice with libtestso, which is linked with libvigenere.so.
+#---------------------------------------------------------------------------------------------------------------
+TestLib() {
+	echo -n Performing Library Test...
+
+	_failed=0
+	for _tc in `seq 1 4`; do
+		if ! ./libtest $_kernel e key$_tc.txt plain$_tc.txt plain$_tc.txt |
+		     cmp -s - <(cat cipher$_tc.correct cipher$_tc.correct cipher$_tc.correct) ||
+		   ! ./libtestso $_kernel d key$_tc.txt cipher$_tc.correct cipher$_tc.correct |
+		     cmp -s - <(cat plain$_tc.txt plain$_tc.txt plain$_tc.txt); then
+			_failed=1
+		fi
+	done
+
+	if [ $_failed = 1 ]; then
+		echo "FAILED. Library output differs from the cipher or plain files"
+	else
+		echo "PASSED"
+	fi
+}
+
+#----- TestCxx -------------------------------------------------------------------------------------------------
+# Perform the encryption and decryption of every test case with the C++ interface (see CxxTest.cpp), which
+# writes its result three times.
+#---------------------------------------------------------------------------------------------------------------
+TestCxx() {
+	echo -n Performing C++ Test...
+
+	_failed=0
+	for _tc in `seq 1 4`; do
+		if ! ./cxxtest $_kernel e key$_tc.txt plain$_tc.txt |
+		     cmp -s - <(cat cipher$_tc.correct cipher$_tc.correct cipher$_tc.correct) ||
+		   ! ./cxxtest $_kernel d key$_tc.txt cipher$_tc.correct |
+		     cmp -s - <(cat plain$_tc.txt plain$_tc.txt plain$_tc.txt); then
+			_failed=1
+		fi
+	done
+
+	if [ $_failed = 1 ]; then
+		echo "FAILED. C++ output differs from the cipher or plain files"
+	else
+		echo "PASSED"
+	fi
+}
+
 #---------------------------------------------------------------------------------------------------------------
 # Starting point of execution for the shell script.
 #---------------------------------------------------------------------------------------------------------------
@@ -152,12 +602,48 @@ cp $_binary $_testdir
 # cd to the test cases directory.
 cd $_testdir
 
+# Build the libraries and link the library test driver with each of them.
+make -s -C $_currdir lib
+gcc -ansi -Wall -I$_currdir LibTest.c $_currdir/libvigenere.a -o libtest
+gcc -ansi -Wall -I$_currdir LibTest.c -L$_currdir -lvigenere -Wl,-rpath,$_currdir -o libtestso
+g++ -std=c++20 -Wall -I$_currdir CxxTest.cpp $_currdir/libvigenere.a -o cxxtest
+
 # Let _tc take on the values 1, 2, 3, 4. The test case files are named (key1.txt, plain1.txt),
-# (key2.txt, plain2.txt), ... . For each value of _tc, call the Test function.
-for _tc in `seq 1 4`; do
-	TestEncrypt
-	TestDecrypt
+# (key2.txt, plain2.txt), ... . For each value of _tc, call the Test function. The test cases are run once
+# for each kernel tier that this CPU supports, by forcing the tier with the VIGENERE_KERNEL variable.
+for _kernel in scalar swar sse2 avx2 avx512bw; do
+	if ! $_binary --kernel $_kernel -v > /dev/null; then
+		echo "Skipping kernel $_kernel (not supported on this CPU)"
+		continue
+	fi
+	echo "Kernel $_kernel:"
+	export VIGENERE_KERNEL=$_kernel
+	for _tc in `seq 1 4`; do
+		TestEncrypt
+		TestDecrypt
+		TestStream
+		TestFiles
+	done
+	TestThreads
+	TestAlpha
+	TestText
+	TestBinary
+	TestArmor
+	TestRange
+	TestContainer
+	TestChain
+	TestAnalyze
+	TestKasiski
+	TestSolve
+	TestClimb
+	TestNgrams
+	TestLongKey
+	TestBatch
+	TestLib
+	TestCxx
 done
+unset VIGENERE_KERNEL
+rm -f libtest libtestso cxxtest
 
 # cd back to the original working directory.
 cd $_curdir
@@ -170,9 +656,15 @@ _curdir=
 _cygwin=
 _diffdecrypt=
 _diffencrypt=
+_failed=
 _file=
+_filetmp=
+_i=
+_kernel=
 _key=
+_manifest=
 _plain=
 _plainout=
 _tc=
 _testdir=
+_threads=
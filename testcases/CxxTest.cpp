@@ -0,0 +1,67 @@
+/***************************************************************************************************************
+ * FILE: CxxTest.cpp
+ *
+ * DESCRIPTION
+ * Test driver for VigenereLib.hpp, built and run by test.sh. Usage:
+ *
+ *     ./cxxtest kernel mode keyfile file
+ *
+ * Encrypts or decrypts the file three times, with each of the ways a Cipher can be called (a returned string,
+ * a caller buffer in two pieces, and a moved string), and writes each result to stdout. The constexpr
+ * Transform() is checked by the static_assert below, i.e., by compiling this file.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#include <fstream>          // For std::ifstream
+#include <iostream>         // For std::cout, std::cerr
+#include <iterator>         // For std::istreambuf_iterator
+#include <vector>           // For std::vector
+#include "VigenereLib.hpp"  // For vigenere::Cipher
+
+static_assert(vigenere::Transform<14>(vigenere::Mode::Encrypt, "LEMON", "ATTACK AT DAWN") ==
+              vigenere::Text<14>{'L', 'X', 'F', 'O', 'P', 'V', ' ', 'M', 'H', ' ', 'O', 'E', 'I', 'B'});
+
+int main
+    (
+    int   pArgc,
+    char *pArgv[]
+    )
+{
+    if (pArgc != 5) {
+        std::cerr << "usage: cxxtest kernel mode keyfile file\n";
+        return 1;
+    }
+    if (!vigenere::Cipher::Kernel(pArgv[1])) return 2;
+    try {
+        auto mode = pArgv[2][0] == 'd' ? vigenere::Mode::Decrypt : vigenere::Mode::Encrypt;
+        auto cipher = vigenere::Cipher::FromFile(pArgv[3], mode);
+        std::ifstream in(pArgv[4], std::ios::binary);
+        std::string msg((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::vector<char> buf(msg.size());
+        std::size_t half = msg.size() / 2, phase;
+
+        std::cout << cipher(std::string_view(msg));
+        phase = cipher.Apply(std::span(msg).first(half), buf);
+        cipher.Apply(std::span(msg).subspan(half), std::span(buf).subspan(half), phase);
+        std::cout.write(buf.data(), buf.size());
+        std::cout << cipher(std::move(msg));
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 3;
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+/***************************************************************************************************************
+ * FILE: LibTest.c
+ *
+ * DESCRIPTION
+ * Test driver for libvigenere.a, built and run by test.sh. Usage:
+ *
+ *     ./libtest kernel mode keyfile file...
+ *
+ * Loads the key from keyfile for mode ('e' or 'd'), reads every file, encrypts or decrypts all of them with
+ * one call to VigenereLibBatch(), and writes the results to stdout one after another. The first file is then
+ * run once more in pieces of 7 bytes with VigenereLibRun() and written again, so the output is the output for
+ * each file followed by the output for the first file.
+ *
+ * AUTHOR INFORMATION
+ * Kevin R. Burger [KRB]
+ *
+ * Mailing Address:
+ * Computer Science & Engineering
+ * School of Computing, Informatics, and Decision Systems Engineering
+ * Arizona State University
+ * Tempe, AZ 85287-8809
+ *
+ * Email: burgerk@asu
+ * Web:   http://kevin.floorsoup.com
+ *
+ * MODIFICATION HISTORY:
+ * -------------------------------------------------------------------------------------------------------------
+ * 17 Oct 2026 [KRB] Initial revision.
+ **************************************************************************************************************/
+#include <stdio.h>        /* For fopen(), fread(), fwrite(), fprintf() */
+#include <stdlib.h>       /* For malloc(), free() */
+#include "VigenereLib.h"  /* For the library */
+
+#define LIBTEST_MAX_LEN (1 << 20)
+
+int main
+    (
+    int    pArgc,
+    char  *pArgv[]
+    )
+{
+    VigenereLibKey *key;
+    VigenereLibMsg *msgs;
+    size_t phase, off, n;
+    int i, count = pArgc - 4;
+
+    if (count < 1) {
+        fprintf(stderr, "usage: libtest kernel mode keyfile file...\n");
+        return 1;
+    }
+    if (!VigenereLibKernel(pArgv[1])) return 2;
+    key = VigenereLibKeyLoad(pArgv[3], pArgv[2][0] == 'd' ? VIGENERE_LIB_DECRYPT : VIGENERE_LIB_ENCRYPT);
+    if (!key) return 3;
+    msgs = malloc(count * sizeof(VigenereLibMsg));
+    for (i = 0; i < count; ++i) {
+        FILE *in = fopen(pArgv[4 + i], "rb");
+        char *buf = malloc(LIBTEST_MAX_LEN);
+        if (!in) return 4;
+        msgs[i].mIn = buf;
+        msgs[i].mOut = buf;
+        msgs[i].mLen = fread(buf, 1, LIBTEST_MAX_LEN, in);
+        fclose(in);
+    }
+    VigenereLibBatch(key, msgs, count);
+    for (i = 0; i < count; ++i) fwrite(msgs[i].mOut, 1, msgs[i].mLen, stdout);
+
+    /* Undo the batch on the first file by building the key for the other mode, then redo it in pieces. */
+    VigenereLibKeyFree(key);
+    key = VigenereLibKeyLoad(pArgv[3], pArgv[2][0] == 'd' ? VIGENERE_LIB_ENCRYPT : VIGENERE_LIB_DECRYPT);
+    VigenereLibBatch(key, msgs, 1);
+    VigenereLibKeyFree(key);
+    key = VigenereLibKeyLoad(pArgv[3], pArgv[2][0] == 'd' ? VIGENERE_LIB_DECRYPT : VIGENERE_LIB_ENCRYPT);
+    for (phase = 0, off = 0; off < msgs[0].mLen; off += n) {
+        n = msgs[0].mLen - off < 7 ? msgs[0].mLen - off : 7;
+        phase = VigenereLibRun(key, phase, msgs[0].mIn + off, msgs[0].mOut + off, n);
+    }
+    fwrite(msgs[0].mOut, 1, msgs[0].mLen, stdout);
+
+    for (i = 0; i < count; ++i) free(msgs[i].mOut);
+    free(msgs);
+    VigenereLibKeyFree(key);
+    return 0;
+}